@@ -21,6 +21,7 @@
 #include<core/purec/puresocket.h>
 #include<core/purec/pureusb.h>
 #include<core/purec/purec.h>
+#include<core/purec/purerle.h>
 #include<api/scopefunapi.h>
 #include<SDL.h>
 
@@ -35,6 +36,8 @@
 /*--------------------------------------------------------------------
    api helper functions
 ---------------------------------------------------------------------*/
+int softwareGenerator(int frameVersion, int frameHeader, int frameData, int framePacket, SFContext* ctx, SSimulate* sim, double time);
+
 uint apiMin(uint a, uint b)
 {
     if(a < b)
@@ -136,6 +139,8 @@ SCOPEFUN_CREATE_DELETE(SFpga)
 SCOPEFUN_CREATE_DELETE(SGenerator)
 SCOPEFUN_CREATE_DELETE(SEeprom)
 SCOPEFUN_CREATE_DELETE(SActiveClients)
+SCOPEFUN_CREATE_DELETE(SFrameBatch)
+SCOPEFUN_CREATE_DELETE(SCaptureStats)
 SFrameData* sfCreateSFrameData(SFContext* ctx, int memory)
 {
     apiLock(ctx);
@@ -171,9 +176,13 @@ const char* msgName[(mLast + 1)] =
     "mHardwareUploadFpga",
     "mHardwareUploadGenerator",
     "mHardwareEepromRead",
+    "mHardwareEepromReadFirmwareID",
     "mHardwareEepromWrite",
     "mHardwareEepromErase",
     "mHardwareClose",
+    "mHardwareSubscribe",
+    "mHardwareCredit",
+    "mHardwareStream",
     "mLast",
 };
 const char* messageName(EMessage message)
@@ -251,6 +260,12 @@ int clientMessageHeader(messageHeader* dest, EMessage message)
         case mHardwareClose:
             dest->size = sizeof(csHardwareClose);
             break;
+        case mHardwareSubscribe:
+            dest->size = sizeof(csHardwareSubscribe);
+            break;
+        case mHardwareCredit:
+            dest->size = sizeof(csHardwareCredit);
+            break;
         default:
             return SCOPEFUN_FAILURE;
     };
@@ -327,6 +342,12 @@ int serverMessageHeader(messageHeader* dest, EMessage message)
         case mHardwareClose:
             dest->size = sizeof(scHardwareClose);
             break;
+        case mHardwareSubscribe:
+            dest->size = sizeof(scHardwareSubscribe);
+            break;
+        case mHardwareStream:
+            dest->size = sizeof(scHardwareStream);
+            break;
         default:
             return SCOPEFUN_FAILURE;
     };
@@ -443,6 +464,16 @@ int isClientHeaderOk(messageHeader* header)
             {
                 return SCOPEFUN_SUCCESS;
             }
+        case mHardwareSubscribe:
+            if(header->size == sizeof(csHardwareSubscribe))
+            {
+                return SCOPEFUN_SUCCESS;
+            }
+        case mHardwareCredit:
+            if(header->size == sizeof(csHardwareCredit))
+            {
+                return SCOPEFUN_SUCCESS;
+            }
     };
     return SCOPEFUN_FAILURE;
 }
@@ -558,10 +589,524 @@ int isServerHeaderOk(messageHeader* header)
             {
                 return SCOPEFUN_SUCCESS;
             }
+        case mHardwareSubscribe:
+            if(header->size == sizeof(scHardwareSubscribe))
+            {
+                return SCOPEFUN_SUCCESS;
+            }
+        case mHardwareStream:
+            if(header->size == sizeof(scHardwareStream))
+            {
+                return SCOPEFUN_SUCCESS;
+            }
     };
     return SCOPEFUN_FAILURE;
 }
 
+/*--------------------------------------------------------------------
+
+   replay
+
+   virtual usb device, streams a recorded .osc, raw or .rle frame file
+   in a loop, a transfer never crosses a frame boundary the same way a
+   short packet ends a usb transfer
+
+---------------------------------------------------------------------*/
+#define REPLAY_PATH       1024
+#define REPLAY_HEADER     SCOPEFUN_FRAME_1_HEADER
+#define REPLAY_FILE_MAX   0x7FFFFFFF
+#define REPLAY_OSC_FRAME  56
+#define REPLAY_OSC_PACKET 24
+#define REPLAY_OSC_MAGIC  0x3243534F
+#define REPLAY_OSC_INDEX  48
+
+typedef struct
+{
+    uint   hwVersion;
+    uint   hwHeader;
+    uint   hwData;
+    uint   hwPacket;
+    ularge frameStart;
+    ularge frameCount;
+    ularge frameSize;
+    ularge packetStart;
+    ularge packetCount;
+    ularge packetSize;
+} ReplayOscHeader;
+
+/* chunked .osc, see OscFileHeader and OscFileChunk in the application */
+typedef struct
+{
+    uint   magic;
+    uint   version;
+    uint   hwVersion;
+    uint   hwHeader;
+    uint   hwData;
+    uint   hwPacket;
+    uint   chunkSize;
+    uint   compression;
+    ularge frameCount;
+    ularge chunkCount;
+    ularge dataSize;
+    ularge indexOffset;
+} ReplayOscChunkedHeader;
+
+typedef struct
+{
+    ularge offset;
+    uint   size;
+    uint   compression;
+} ReplayOscChunk;
+
+typedef struct
+{
+    char    path[REPLAY_PATH];
+    uint    rate;
+    uint    version;
+    byte*   data;
+    uint    size;
+    uint*   frameOffset;
+    uint*   frameSize;
+    uint    frameCount;
+    uint    frame;
+    uint    emit;
+    uint    left;
+    uint    headerSize;
+    uint    loop;
+    byte    header[REPLAY_HEADER];
+    ularge  ticks;
+    ularge  bytes;
+} ReplayContext;
+
+int replayIsOn(SFContext* ctx)
+{
+    ReplayContext* replay = (ReplayContext*)ctx->replay;
+    return replay && replay->path[0] != 0;
+}
+
+int replayIsExt(const char* path, const char* ext)
+{
+    size_t pathLen = SDL_strlen(path);
+    size_t extLen  = SDL_strlen(ext);
+    return pathLen >= extLen && SDL_strcasecmp(path + pathLen - extLen, ext) == 0;
+}
+
+uint replayFrameSize(ReplayContext* replay, uint pos)
+{
+    uint left = replay->size - pos;
+    byte* frame = replay->data + pos;
+    uint header = 0;
+    uint size = 0;
+    if(replay->version == HARDWARE_VERSION_1)
+    {
+        header = SCOPEFUN_FRAME_1_HEADER;
+    }
+    if(replay->version == HARDWARE_VERSION_2)
+    {
+        header = SCOPEFUN_FRAME_2_HEADER;
+    }
+    if(header == 0 || left < header || frame[0] != 0xDD)
+    {
+        return 0;
+    }
+    // 32 bit sample count could overflow the size, check it first
+    if(replay->version == HARDWARE_VERSION_2)
+    {
+        SFrameHeader2* header2 = (SFrameHeader2*)frame;
+        byte* count = &header2->hardware.bytes[32];
+        uint samples = ((uint)count[0] << 24) | ((uint)count[1] << 16) | ((uint)count[2] << 8) | ((uint)count[3] << 0);
+        if(samples == 0 || samples > (left - header) / 4)
+        {
+            return 0;
+        }
+    }
+    size = apiFrameSize(replay->version, (char*)frame);
+    if(size > left)
+    {
+        return 0;
+    }
+    return size;
+}
+
+int replayIndex(ReplayContext* replay, uint start)
+{
+    // two passes, count then fill, bytes that are not a frame are skipped until the next magic
+    int pass = 0;
+    for(pass = 0; pass < 2; pass++)
+    {
+        uint count = 0;
+        uint pos = start;
+        while(pos < replay->size)
+        {
+            uint size = replayFrameSize(replay, pos);
+            if(size == 0)
+            {
+                pos++;
+                continue;
+            }
+            if(pass == 1)
+            {
+                replay->frameOffset[count] = pos;
+                replay->frameSize[count]   = size;
+            }
+            count++;
+            pos += size;
+        }
+        if(pass == 0)
+        {
+            if(count == 0)
+            {
+                return SCOPEFUN_FAILURE;
+            }
+            replay->frameCount  = count;
+            replay->frameOffset = (uint*)cMalloc(count * sizeof(uint));
+            replay->frameSize   = (uint*)cMalloc(count * sizeof(uint));
+        }
+    }
+    return SCOPEFUN_SUCCESS;
+}
+
+void replayFree(ReplayContext* replay)
+{
+    cFree((char*)replay->data);
+    cFree((char*)replay->frameOffset);
+    cFree((char*)replay->frameSize);
+    replay->data        = 0;
+    replay->size        = 0;
+    replay->frameOffset = 0;
+    replay->frameSize   = 0;
+    replay->frameCount  = 0;
+    replay->frame       = 0;
+    replay->emit        = 0;
+    replay->left        = 0;
+    replay->loop        = 0;
+}
+
+int replayUnpackOsc(ReplayContext* replay, int version)
+{
+    ReplayOscChunkedHeader osc = { 0 };
+    SDL_memcpy(&osc, replay->data, sizeof(ReplayOscChunkedHeader));
+    ularge index = osc.indexOffset + osc.frameCount * REPLAY_OSC_INDEX;
+    if(osc.hwVersion != (uint)version ||
+       osc.chunkSize == 0 ||
+       osc.dataSize == 0 ||
+       osc.dataSize > REPLAY_FILE_MAX ||
+       osc.chunkCount != (osc.dataSize + osc.chunkSize - 1) / osc.chunkSize ||
+       index + osc.chunkCount * sizeof(ReplayOscChunk) > replay->size)
+    {
+        return SCOPEFUN_FAILURE;
+    }
+    byte* data = (byte*)cMalloc((uint)osc.dataSize);
+    ularge i = 0;
+    for(i = 0; i < osc.chunkCount; i++)
+    {
+        ReplayOscChunk chunk;
+        SDL_memcpy(&chunk, replay->data + index + i * sizeof(ReplayOscChunk), sizeof(ReplayOscChunk));
+        uint raw = (uint)apiMin((uint)osc.chunkSize, (uint)(osc.dataSize - i * osc.chunkSize));
+        byte* dest = data + i * osc.chunkSize;
+        if(chunk.offset + chunk.size > replay->size)
+        {
+            cFree((char*)data);
+            return SCOPEFUN_FAILURE;
+        }
+        if(chunk.compression)
+        {
+            if(rleDecode(dest, raw, replay->data + chunk.offset, chunk.size) != raw)
+            {
+                cFree((char*)data);
+                return SCOPEFUN_FAILURE;
+            }
+        }
+        else
+        {
+            SDL_memcpy(dest, replay->data + chunk.offset, apiMin(raw, chunk.size));
+        }
+    }
+    cFree((char*)replay->data);
+    replay->data = data;
+    replay->size = (uint)osc.dataSize;
+    return SCOPEFUN_SUCCESS;
+}
+
+int replayLoad(SFContext* ctx, int version)
+{
+    ReplayContext* replay = (ReplayContext*)ctx->replay;
+    replayFree(replay);
+    replay->version = version;
+    // read whole file
+    SDL_RWops* file = SDL_RWFromFile(replay->path, "rb");
+    if(!file)
+    {
+        return SCOPEFUN_FAILURE;
+    }
+    Sint64 fileSize = SDL_RWsize(file);
+    if(fileSize <= 0 || fileSize > REPLAY_FILE_MAX)
+    {
+        SDL_RWclose(file);
+        return SCOPEFUN_FAILURE;
+    }
+    replay->size = (uint)fileSize;
+    replay->data = (byte*)cMalloc(replay->size);
+    size_t read = SDL_RWread(file, replay->data, 1, replay->size);
+    SDL_RWclose(file);
+    if(read != replay->size)
+    {
+        replayFree(replay);
+        return SCOPEFUN_FAILURE;
+    }
+    // rle compressed stream of frames
+    if(replayIsExt(replay->path, ".rle"))
+    {
+        uint size = (uint)rleDecode(0, REPLAY_FILE_MAX, replay->data, replay->size);
+        byte* data = (byte*)cMalloc(size);
+        rleDecode(data, size, replay->data, replay->size);
+        cFree((char*)replay->data);
+        replay->data = data;
+        replay->size = size;
+    }
+    // chunked .osc, frames are unpacked to one stream in capture order
+    int chunked = replayIsExt(replay->path, ".osc") && replay->size >= sizeof(ReplayOscChunkedHeader) && *(uint*)replay->data == REPLAY_OSC_MAGIC;
+    if(chunked)
+    {
+        if(replayUnpackOsc(replay, version) != SCOPEFUN_SUCCESS)
+        {
+            replayFree(replay);
+            return SCOPEFUN_FAILURE;
+        }
+    }
+    // skip .osc header, frame and packet tables, data is stored in ring order
+    uint start = 0;
+    if(replayIsExt(replay->path, ".osc") && !chunked)
+    {
+        ReplayOscHeader osc = { 0 };
+        if(replay->size < sizeof(ReplayOscHeader))
+        {
+            replayFree(replay);
+            return SCOPEFUN_FAILURE;
+        }
+        SDL_memcpy(&osc, replay->data, sizeof(ReplayOscHeader));
+        ularge tables = sizeof(ReplayOscHeader) + osc.frameSize * REPLAY_OSC_FRAME + osc.packetSize * REPLAY_OSC_PACKET;
+        if(osc.hwVersion != (uint)version || tables > replay->size)
+        {
+            replayFree(replay);
+            return SCOPEFUN_FAILURE;
+        }
+        start = (uint)tables;
+    }
+    if(replayIndex(replay, start) != SCOPEFUN_SUCCESS)
+    {
+        replayFree(replay);
+        return SCOPEFUN_FAILURE;
+    }
+    replay->ticks = SDL_GetPerformanceCounter();
+    replay->bytes = 0;
+    return SCOPEFUN_SUCCESS;
+}
+
+void replayNextFrame(SFContext* ctx)
+{
+    ReplayContext* replay = (ReplayContext*)ctx->replay;
+    byte* frame = replay->data + replay->frameOffset[replay->frame];
+    uint  size  = replay->frameSize[replay->frame];
+    uint  header = SCOPEFUN_FRAME_1_HEADER;
+    if(replay->version == HARDWARE_VERSION_2)
+    {
+        header = SCOPEFUN_FRAME_2_HEADER;
+    }
+    SDL_memcpy(replay->header, frame, header);
+    // version 2 data is cut to sfSetFrameData in whole 1024 byte blocks, sample count is patched to match
+    if(replay->version == HARDWARE_VERSION_2 && ctx->frame.info.data >= 1024 && size - header > ctx->frame.info.data)
+    {
+        SFrameHeader2* header2 = (SFrameHeader2*)replay->header;
+        byte* count = &header2->hardware.bytes[32];
+        uint samples = (ctx->frame.info.data / 1024) * 256;
+        count[0] = (byte)(samples >> 24);
+        count[1] = (byte)(samples >> 16);
+        count[2] = (byte)(samples >> 8);
+        count[3] = (byte)(samples >> 0);
+        size = apiFrameSize(HARDWARE_VERSION_2, (char*)replay->header);
+    }
+    replay->emit       = size;
+    replay->left       = size;
+    replay->headerSize = header;
+}
+
+void replayThrottle(ReplayContext* replay, uint bytes)
+{
+    replay->bytes += bytes;
+    if(replay->rate == 0)
+    {
+        return;
+    }
+    // sleep until the bytes sent so far are due at rate
+    ularge freq = SDL_GetPerformanceFrequency();
+    ularge due  = replay->ticks + (ularge)((double)replay->bytes * (double)freq / (double)replay->rate);
+    ularge now  = SDL_GetPerformanceCounter();
+    if(due > now)
+    {
+        SDL_Delay((uint)((due - now) * 1000 / freq));
+    }
+}
+
+int replayCapture(SFContext* ctx, SFrameData* dest, int size, int* transfer)
+{
+    ReplayContext* replay = (ReplayContext*)ctx->replay;
+    *transfer = 0;
+    if(replay->frameCount == 0 || size <= 0)
+    {
+        return SCOPEFUN_FAILURE;
+    }
+    if(replay->left == 0)
+    {
+        replayNextFrame(ctx);
+    }
+    uint pos   = replay->emit - replay->left;
+    uint count = apiMin((uint)size, replay->left);
+    uint copy  = 0;
+    byte* frame = replay->data + replay->frameOffset[replay->frame];
+    // header from the patched copy, data from the file
+    if(pos < replay->headerSize)
+    {
+        copy = apiMin(count, replay->headerSize - pos);
+        SDL_memcpy(dest->data.bytes, replay->header + pos, copy);
+    }
+    SDL_memcpy(dest->data.bytes + copy, frame + pos + copy, count - copy);
+    replay->left -= count;
+    if(replay->left == 0)
+    {
+        replay->frame++;
+        if(replay->frame == replay->frameCount)
+        {
+            replay->frame = 0;
+            replay->loop++;
+        }
+    }
+    *transfer = count;
+    replayThrottle(replay, count);
+    return SCOPEFUN_SUCCESS;
+}
+
+int replayIsOpened(SFContext* ctx, int* open)
+{
+    ReplayContext* replay = (ReplayContext*)ctx->replay;
+    *open = replay->frameCount > 0;
+    return SCOPEFUN_SUCCESS;
+}
+
+int replayClose(SFContext* ctx)
+{
+    replayFree((ReplayContext*)ctx->replay);
+    return SCOPEFUN_SUCCESS;
+}
+
+int replayEepromRead(SEeprom* buffer, int size)
+{
+    // blank eeprom
+    SDL_memset(&buffer->data.bytes[0], 0xFF, apiMin(SDL_max(size, 0), sizeof(buffer->data.bytes)));
+    return SCOPEFUN_SUCCESS;
+}
+
+/*--------------------------------------------------------------------
+
+   stats
+
+---------------------------------------------------------------------*/
+uint latencyBucket(uint us)
+{
+    if(us < SCOPEFUN_LATENCY_LINEAR)
+    {
+        return us;
+    }
+    uint msb = 0;
+    uint value = us;
+    while(value >>= 1)
+    {
+        msb++;
+    }
+    // msb >= 5, top bits are 16..31
+    uint top = us >> (msb - 4);
+    return SCOPEFUN_LATENCY_LINEAR + (msb - 5) * SCOPEFUN_LATENCY_SUB + (top - SCOPEFUN_LATENCY_SUB);
+}
+
+uint latencyBucketMax(uint bucket)
+{
+    if(bucket < SCOPEFUN_LATENCY_LINEAR)
+    {
+        return bucket;
+    }
+    uint msb = (bucket - SCOPEFUN_LATENCY_LINEAR) / SCOPEFUN_LATENCY_SUB + 5;
+    uint top = (bucket - SCOPEFUN_LATENCY_LINEAR) % SCOPEFUN_LATENCY_SUB + SCOPEFUN_LATENCY_SUB;
+    ularge max = ((ularge)(top + 1) << (msb - 4)) - 1;
+    return (uint)SDL_min(max, 0xFFFFFFFF);
+}
+
+void captureStats(SFContext* ctx, ularge start, int received)
+{
+    ularge us = (SDL_GetPerformanceCounter() - start) * 1000000 / SDL_GetPerformanceFrequency();
+    ctx->stats.calls++;
+    ctx->stats.bytes += SDL_max(received, 0);
+    if(received <= 0)
+    {
+        ctx->stats.empty++;
+    }
+    sfLatencyRecord(&ctx->stats.latency, (uint)SDL_min(us, 0xFFFFFFFF));
+}
+
+SCOPEFUN_API int sfLatencyClear(SLatency* latency)
+{
+    SDL_zerop(latency);
+    return SCOPEFUN_SUCCESS;
+}
+
+SCOPEFUN_API int sfLatencyRecord(SLatency* latency, uint us)
+{
+    latency->bucket.bytes[latencyBucket(us)]++;
+    latency->count++;
+    latency->sum += us;
+    latency->max  = SDL_max(latency->max, us);
+    return SCOPEFUN_SUCCESS;
+}
+
+SCOPEFUN_API int sfLatencyPercentile(SLatency* latency, double percentile, int* us)
+{
+    *us = 0;
+    if(latency->count == 0)
+    {
+        return SCOPEFUN_FAILURE;
+    }
+    percentile = SDL_max(0.0, SDL_min(percentile, 100.0));
+    ularge rank  = (ularge)ceil(percentile / 100.0 * (double)latency->count);
+    ularge count = 0;
+    uint i = 0;
+    for(i = 0; i < SCOPEFUN_LATENCY_BUCKETS; i++)
+    {
+        count += latency->bucket.bytes[i];
+        if(count >= SDL_max(rank, 1))
+        {
+            *us = (int)SDL_min(latencyBucketMax(i), latency->max);
+            return SCOPEFUN_SUCCESS;
+        }
+    }
+    *us = (int)latency->max;
+    return SCOPEFUN_SUCCESS;
+}
+
+SCOPEFUN_API int sfGetCaptureStats(SFContext* ctx, SCaptureStats* stats)
+{
+    apiLock(ctx);
+    *stats = ctx->stats;
+    apiUnlock(ctx);
+    return SCOPEFUN_SUCCESS;
+}
+
+SCOPEFUN_API int sfClearCaptureStats(SFContext* ctx)
+{
+    apiLock(ctx);
+    SDL_zero(ctx->stats);
+    apiUnlock(ctx);
+    return SCOPEFUN_SUCCESS;
+}
+
 /*--------------------------------------------------------------------
 
    api
@@ -589,6 +1134,9 @@ SCOPEFUN_API int sfApiCreateContext(SFContext* ctx, int memory)
     ctx->usb = cMalloc(sizeof(struct UsbContext));
     struct UsbContext* pCtx = (UsbContext*)ctx->usb;
     cMemSet((char*)pCtx, 0, sizeof(struct UsbContext));
+    // replay
+    ctx->replay = cMalloc(sizeof(ReplayContext));
+    cMemSet((char*)ctx->replay, 0, sizeof(ReplayContext));
     // version
     ctx->api.version = 1;
     ctx->api.major   = 0;
@@ -601,6 +1149,13 @@ SCOPEFUN_API int sfApiCreateContext(SFContext* ctx, int memory)
     ctx->frame.info.data    = memory;
     ctx->frame.info.packet  = SCOPEFUN_FRAME_2_PACKET;
     apiUnlock(ctx);
+    // replay from environment so the gui and scripts can run without a device
+    const char* replay = SDL_getenv("SCOPEFUN_REPLAY");
+    if(replay)
+    {
+        const char* rate = SDL_getenv("SCOPEFUN_REPLAY_RATE");
+        sfSetReplay(ctx, replay, rate ? SDL_atoi(rate) : 0);
+    }
     return SCOPEFUN_SUCCESS;
 }
 
@@ -612,6 +1167,9 @@ SCOPEFUN_API int sfApiDeleteContext(SFContext* ctx)
     cFree((char*)ctx->net);
     // usb
     cFree((char*)ctx->usb);
+    // replay
+    replayFree((ReplayContext*)ctx->replay);
+    cFree((char*)ctx->replay);
     return SCOPEFUN_SUCCESS;
 }
 
@@ -775,6 +1333,40 @@ SCOPEFUN_API int sfSetSimulateOnOff(SFContext* ctx, int on)
     apiUnlock(ctx);
     return SCOPEFUN_SUCCESS;
 }
+SCOPEFUN_API int sfSetSimulateSeed(SFContext* ctx, int seed)
+{
+    apiLock(ctx);
+    ctx->simulate.seed  = (uint)seed;
+    ctx->simulate.frame = 0;
+    apiUnlock(ctx);
+    return SCOPEFUN_SUCCESS;
+}
+SCOPEFUN_API int sfSetReplay(SFContext* ctx, const char* path, int rate)
+{
+    apiLock(ctx);
+    ReplayContext* replay = (ReplayContext*)ctx->replay;
+    replayFree(replay);
+    SDL_strlcpy(replay->path, path ? path : "", REPLAY_PATH);
+    replay->rate = SDL_max(rate, 0);
+    apiUnlock(ctx);
+    return SCOPEFUN_SUCCESS;
+}
+SCOPEFUN_API int sfSetCaptureQueue(SFContext* ctx, int count, int size)
+{
+    apiLock(ctx);
+    count = count > 0 ? apiMin(count, USB_STREAM_MAX_TRANSFER) : 0;
+    size  = size  > 0 ? apiMin(size, SCOPEFUN_FRAME_PACKET) : SCOPEFUN_FRAME_PACKET;
+    if(ctx->api.queue != (uint)count || ctx->api.queueSize != (uint)size)
+    {
+        // restarted with new settings on next usb capture
+        struct UsbContext* pUsbCtx = (struct UsbContext*)ctx->usb;
+        usbFxxStreamStop(pUsbCtx);
+    }
+    ctx->api.queue     = count;
+    ctx->api.queueSize = size;
+    apiUnlock(ctx);
+    return SCOPEFUN_SUCCESS;
+}
 
 SCOPEFUN_API int sfSetActiveClients(SFContext* ctx, SActiveClients* clients)
 {
@@ -853,6 +1445,14 @@ SCOPEFUN_API int sfGetSimulateData(SFContext* ctx, SSimulate* data)
     apiUnlock(ctx);
     return SCOPEFUN_SUCCESS;
 }
+SCOPEFUN_API int sfGetCaptureQueue(SFContext* ctx, int* depth, int* dropped)
+{
+    apiLock(ctx);
+    struct UsbContext* pUsbCtx = (struct UsbContext*)ctx->usb;
+    usbFxxStreamStatus(pUsbCtx, depth, dropped);
+    apiUnlock(ctx);
+    return SCOPEFUN_SUCCESS;
+}
 
 /*--------------------------------------------------------------------
 
@@ -1176,79 +1776,280 @@ SCOPEFUN_API int netHardwareConfig2(SFContext* ctx, SHardware2* config)
     apiUnlock(ctx);
     return result;
 }
-SCOPEFUN_API int netHardwareCapture(SFContext* ctx, SFrameData* data, int len, int* transfered,int type)
+int netDiscard(struct SocketContext* pSocketCtx, uint bytes)
 {
-    int result = SCOPEFUN_FAILURE;
-    *transfered = 0;
-    struct SocketContext* pSocketCtx = (SocketContext*)ctx->net;
-    if(pSocketCtx->socket > 0 && ctx->api.active > 0)
+    // payload the caller has no room for is read and dropped so the next message starts at its header
+    char discard[4096];
+    while(bytes > 0)
     {
-        len = apiMin(len, SCOPEFUN_FRAME_MEMORY);
-        int ret = 0;
-        int sent = 0;
         int received = 0;
-        csHardwareCapture message = { 0 };
-        clientMessageHeader(&message.header, mHardwareCapture);
-        message.len  = apiMin(len,SCOPEFUN_FRAME_MEMORY);
-        message.type = type;
-        ret = socketSend(pSocketCtx, (char*)&message, sizeof(message), 0, &sent);
-        if(ret == PURESOCKET_SUCCESS && sent == sizeof(csHardwareCapture))
-        {
-            // header
-            messageHeader header = { 0 };
-            ret = socketRecv(pSocketCtx, (char*)&header, sizeof(messageHeader), 0, &received);
-            if(ret == PURESOCKET_SUCCESS && received == sizeof(messageHeader) && isServerHeaderOk((messageHeader*)&header) == SCOPEFUN_SUCCESS)
-            {
-                // size
-                uint bytes = 0;
-                ret = socketRecv(pSocketCtx, (char*)&bytes, sizeof(uint), 0, &received);
-                if(ret == PURESOCKET_SUCCESS && received == sizeof(uint))
-                {
-                    // data
-                    bytes = apiMin(bytes, len);
-                    ret = socketRecv(pSocketCtx, (char*)&data->data.bytes[0], bytes, 0, &received);
-                    if(ret == PURESOCKET_SUCCESS && bytes == received)
-                    {
-                        *transfered = received;
-                        result = apiResult(ret);
-                    }
-                    else
-                    {
-                        SDL_LogInfo(SDL_LOG_CATEGORY_APPLICATION, "ScopeFun API: communication error 4" );
-                        int debug = 1;
-                    }
-                }
-                else
-                {
-                    SDL_LogInfo(SDL_LOG_CATEGORY_APPLICATION, "ScopeFun API: communication error 3" );
-                    int debug = 1;
-                }
-            }
-            else
-            {
-                SDL_LogInfo(SDL_LOG_CATEGORY_APPLICATION, "ScopeFun API: communication error 2" );
-                int debug = 1;
-            }
-        }
-        else
+        int chunk    = apiMin(bytes, sizeof(discard));
+        int ret      = socketRecv(pSocketCtx, discard, chunk, 0, &received);
+        if(ret != PURESOCKET_SUCCESS || received != chunk)
         {
-            int debug = 1;
-            SDL_LogInfo(SDL_LOG_CATEGORY_APPLICATION, "ScopeFun API: communication error 1" );
+            return SCOPEFUN_FAILURE;
         }
+        bytes -= chunk;
     }
-    return result;
+    return SCOPEFUN_SUCCESS;
 }
 
-SCOPEFUN_API int netHardwareUploadFx2(SFContext* ctx, SFx2* fw)
+int netCaptureRequest(struct SocketContext* pSocketCtx, int len, int type)
 {
-    int result = SCOPEFUN_FAILURE;
-    apiLock(ctx);
-    struct SocketContext* pSocketCtx = (SocketContext*)ctx->net;
-    if(pSocketCtx->socket > 0 && ctx->api.active > 0)
+    int sent = 0;
+    csHardwareCapture message = { 0 };
+    clientMessageHeader(&message.header, mHardwareCapture);
+    message.len  = apiMin(len, SCOPEFUN_FRAME_MEMORY);
+    message.type = type;
+    int ret = socketSend(pSocketCtx, (char*)&message, sizeof(message), 0, &sent);
+    if(ret == PURESOCKET_SUCCESS && sent == sizeof(csHardwareCapture))
     {
-        int ret = 0;
-        int sent = 0;
-        int received = 0;
+        return SCOPEFUN_SUCCESS;
+    }
+    SDL_LogInfo(SDL_LOG_CATEGORY_APPLICATION, "ScopeFun API: communication error 1" );
+    return SCOPEFUN_FAILURE;
+}
+
+int netCaptureResponse(struct SocketContext* pSocketCtx, byte* dest, int len, int* transfered)
+{
+    int received = 0;
+    // header
+    messageHeader header = { 0 };
+    int ret = socketRecv(pSocketCtx, (char*)&header, sizeof(messageHeader), 0, &received);
+    if(ret != PURESOCKET_SUCCESS || received != sizeof(messageHeader) || isServerHeaderOk((messageHeader*)&header) != SCOPEFUN_SUCCESS)
+    {
+        SDL_LogInfo(SDL_LOG_CATEGORY_APPLICATION, "ScopeFun API: communication error 2" );
+        return SCOPEFUN_FAILURE;
+    }
+    // size
+    uint bytes = 0;
+    ret = socketRecv(pSocketCtx, (char*)&bytes, sizeof(uint), 0, &received);
+    if(ret != PURESOCKET_SUCCESS || received != sizeof(uint))
+    {
+        SDL_LogInfo(SDL_LOG_CATEGORY_APPLICATION, "ScopeFun API: communication error 3" );
+        return SCOPEFUN_FAILURE;
+    }
+    // data
+    bytes = apiMin(bytes, len);
+    ret = socketRecv(pSocketCtx, (char*)dest, bytes, 0, &received);
+    if(ret != PURESOCKET_SUCCESS || bytes != received)
+    {
+        SDL_LogInfo(SDL_LOG_CATEGORY_APPLICATION, "ScopeFun API: communication error 4" );
+        return SCOPEFUN_FAILURE;
+    }
+    *transfered = received;
+    return apiResult(ret);
+}
+
+SCOPEFUN_API int netHardwareCapture(SFContext* ctx, SFrameData* data, int len, int* transfered,int type)
+{
+    int result = SCOPEFUN_FAILURE;
+    *transfered = 0;
+    struct SocketContext* pSocketCtx = (SocketContext*)ctx->net;
+    if(pSocketCtx->socket > 0 && ctx->api.active > 0)
+    {
+        len = apiMin(len, SCOPEFUN_FRAME_MEMORY);
+        if(netCaptureRequest(pSocketCtx, len, type) == SCOPEFUN_SUCCESS)
+        {
+            result = netCaptureResponse(pSocketCtx, &data->data.bytes[0], len, transfered);
+        }
+    }
+    return result;
+}
+
+SCOPEFUN_API int netHardwareCaptureBatch(SFContext* ctx, SFrameData* buffer, int header, int data, int frames, SFrameBatch* batch, int* captured)
+{
+    int result = SCOPEFUN_FAILURE;
+    *captured = 0;
+    struct SocketContext* pSocketCtx = (SocketContext*)ctx->net;
+    if(pSocketCtx->socket > 0 && ctx->api.active > 0)
+    {
+        // every frame is a header and a data request, up to SCOPEFUN_BATCH_WINDOW of them are in flight
+        int parts    = (header > 0) + (data > 0);
+        int requests = frames * parts;
+        int issued   = 0;
+        int done     = 0;
+        result = SCOPEFUN_SUCCESS;
+        while(done < requests && result == SCOPEFUN_SUCCESS)
+        {
+            while(issued < requests && issued - done < SCOPEFUN_BATCH_WINDOW && result == SCOPEFUN_SUCCESS)
+            {
+                int isHeader = header > 0 && (issued % parts) == 0;
+                result = netCaptureRequest(pSocketCtx, isHeader ? header : data, isHeader ? SCOPEFUN_CAPTURE_TYPE_HEADER : SCOPEFUN_CAPTURE_TYPE_DATA);
+                issued++;
+            }
+            if(result != SCOPEFUN_SUCCESS)
+            {
+                break;
+            }
+            int frame    = done / parts;
+            int isHeader = header > 0 && (done % parts) == 0;
+            int len      = isHeader ? header : data;
+            int offset   = batch->offset.bytes[frame] + (isHeader ? 0 : header);
+            int transfered = 0;
+            result = netCaptureResponse(pSocketCtx, &buffer->data.bytes[offset], len, &transfered);
+            batch->length.bytes[frame] += transfered;
+            done++;
+            if(done % parts == 0 && result == SCOPEFUN_SUCCESS)
+            {
+                *captured = frame + 1;
+            }
+        }
+        // responses of a failed batch are partly read or still in flight, the connection can not be trusted anymore
+        if(result != SCOPEFUN_SUCCESS)
+        {
+            SDL_LogInfo(SDL_LOG_CATEGORY_APPLICATION, "ScopeFun API: batch failed with %d responses outstanding, closing connection", issued - done);
+            socketClose(pSocketCtx);
+            ctx->client.connected = 0;
+            pSocketCtx->socket    = 0;
+        }
+    }
+    return result;
+}
+
+SCOPEFUN_API int netHardwareSubscribe(SFContext* ctx, int len, int type, int credit)
+{
+    int result = SCOPEFUN_FAILURE;
+    struct SocketContext* pSocketCtx = (SocketContext*)ctx->net;
+    if(pSocketCtx->socket > 0 && ctx->api.active > 0)
+    {
+        int ret = 0;
+        int sent = 0;
+        int received = 0;
+        csHardwareSubscribe message = { 0 };
+        clientMessageHeader(&message.header, mHardwareSubscribe);
+        message.len    = apiMin(len, SCOPEFUN_FRAME_MEMORY);
+        message.type   = type;
+        message.credit = credit;
+        ret = socketSend(pSocketCtx, (char*)&message, sizeof(message), 0, &sent);
+        if(ret == PURESOCKET_SUCCESS && sent == sizeof(csHardwareSubscribe))
+        {
+            scHardwareSubscribe response = { 0 };
+            ret = socketRecv(pSocketCtx, (char*)&response, sizeof(scHardwareSubscribe), 0, &received);
+            if(ret == PURESOCKET_SUCCESS && received == sizeof(scHardwareSubscribe) && isServerHeaderOk((messageHeader*)&response) == SCOPEFUN_SUCCESS && response.header.message == mHardwareSubscribe)
+            {
+                ctx->client.stream = response.credit;
+                result = apiResult(ret);
+            }
+        }
+    }
+    return result;
+}
+SCOPEFUN_API int netHardwareStream(SFContext* ctx, SFrameData* data, int len, int* transfered, int* sequence)
+{
+    int result = SCOPEFUN_FAILURE;
+    *transfered = 0;
+    *sequence   = 0;
+    struct SocketContext* pSocketCtx = (SocketContext*)ctx->net;
+    if(pSocketCtx->socket > 0 && ctx->api.active > 0 && ctx->client.stream > 0)
+    {
+        int ret = 0;
+        int sent = 0;
+        int received = 0;
+        // header, bytes and sequence
+        scHardwareStream header = { 0 };
+        uint headerSize = sizeof(messageHeader) + 2 * sizeof(uint);
+        ret = socketRecv(pSocketCtx, (char*)&header, headerSize, 0, &received);
+        if(ret == PURESOCKET_SUCCESS && received == headerSize && isServerHeaderOk((messageHeader*)&header) == SCOPEFUN_SUCCESS && header.header.message == mHardwareStream)
+        {
+            // data, clamped to the caller buffer, the rest of the payload is dropped
+            uint bytes = apiMin(header.bytes, len > 0 ? apiMin(len, SCOPEFUN_FRAME_MEMORY) : 0);
+            ret = socketRecv(pSocketCtx, (char*)&data->data.bytes[0], bytes, 0, &received);
+            if(ret == PURESOCKET_SUCCESS && bytes == received && netDiscard(pSocketCtx, header.bytes - bytes) == SCOPEFUN_SUCCESS)
+            {
+                *transfered = received;
+                *sequence   = header.sequence;
+                // frame consumed, give the credit back
+                csHardwareCredit credit = { 0 };
+                clientMessageHeader(&credit.header, mHardwareCredit);
+                credit.credit = 1;
+                ret = socketSend(pSocketCtx, (char*)&credit, sizeof(credit), 0, &sent);
+                if(ret == PURESOCKET_SUCCESS && sent == sizeof(csHardwareCredit))
+                {
+                    result = apiResult(ret);
+                }
+            }
+            else
+            {
+                SDL_LogInfo(SDL_LOG_CATEGORY_APPLICATION, "ScopeFun API: stream error 2" );
+            }
+        }
+        else
+        {
+            SDL_LogInfo(SDL_LOG_CATEGORY_APPLICATION, "ScopeFun API: stream error 1" );
+        }
+    }
+    return result;
+}
+SCOPEFUN_API int netHardwareUnsubscribe(SFContext* ctx)
+{
+    int result = SCOPEFUN_FAILURE;
+    struct SocketContext* pSocketCtx = (SocketContext*)ctx->net;
+    if(pSocketCtx->socket > 0 && ctx->api.active > 0)
+    {
+        int ret = 0;
+        int sent = 0;
+        int received = 0;
+        csHardwareSubscribe message = { 0 };
+        clientMessageHeader(&message.header, mHardwareSubscribe);
+        message.credit = 0;
+        ret = socketSend(pSocketCtx, (char*)&message, sizeof(message), 0, &sent);
+        if(ret == PURESOCKET_SUCCESS && sent == sizeof(csHardwareSubscribe))
+        {
+            // frames already in flight arrive before the reply
+            while(1)
+            {
+                messageHeader header = { 0 };
+                ret = socketRecv(pSocketCtx, (char*)&header, sizeof(messageHeader), 0, &received);
+                if(ret != PURESOCKET_SUCCESS || received != sizeof(messageHeader) || isServerHeaderOk(&header) != SCOPEFUN_SUCCESS)
+                {
+                    break;
+                }
+                if(header.message == mHardwareSubscribe)
+                {
+                    uint credit = 0;
+                    ret = socketRecv(pSocketCtx, (char*)&credit, sizeof(uint), 0, &received);
+                    if(ret == PURESOCKET_SUCCESS && received == sizeof(uint))
+                    {
+                        ctx->client.stream = 0;
+                        result = apiResult(ret);
+                    }
+                    break;
+                }
+                if(header.message != mHardwareStream)
+                {
+                    break;
+                }
+                uint info[2] = { 0 };
+                ret = socketRecv(pSocketCtx, (char*)&info[0], sizeof(info), 0, &received);
+                if(ret != PURESOCKET_SUCCESS || received != sizeof(info))
+                {
+                    break;
+                }
+                uint left = info[0];
+                while(left > 0 && ret == PURESOCKET_SUCCESS)
+                {
+                    char drain[4096];
+                    uint size = apiMin(left, sizeof(drain));
+                    ret = socketRecv(pSocketCtx, drain, size, 0, &received);
+                    left -= size;
+                }
+            }
+        }
+    }
+    return result;
+}
+
+SCOPEFUN_API int netHardwareUploadFx2(SFContext* ctx, SFx2* fw)
+{
+    int result = SCOPEFUN_FAILURE;
+    apiLock(ctx);
+    struct SocketContext* pSocketCtx = (SocketContext*)ctx->net;
+    if(pSocketCtx->socket > 0 && ctx->api.active > 0)
+    {
+        int ret = 0;
+        int sent = 0;
+        int received = 0;
         messageHeader header = { 0 };
         clientMessageHeader(&header, mHardwareUploadFx2);
         ret = socketSend(pSocketCtx, (char*)&header, sizeof(messageHeader), 0, &sent);
@@ -1505,7 +2306,11 @@ SCOPEFUN_API int usbHardwareOpen(SFContext* ctx, SUsb* cfg, int version)
 {
     int result = SCOPEFUN_FAILURE;
     apiLock(ctx);
-    if(ctx->api.active > 0)
+    if(ctx->api.active > 0 && replayIsOn(ctx))
+    {
+        result = replayLoad(ctx, version);
+    }
+    else if(ctx->api.active > 0)
     {
         struct UsbContext* pUsbCtx = (struct UsbContext*)ctx->usb;
         UsbGuid id;
@@ -1526,7 +2331,11 @@ SCOPEFUN_API int usbHardwareIsOpened(SFContext* ctx, int* open)
 {
     int result = SCOPEFUN_FAILURE;
     apiLock(ctx);
-    if(ctx->api.active > 0)
+    if(ctx->api.active > 0 && replayIsOn(ctx))
+    {
+        result = replayIsOpened(ctx, open);
+    }
+    else if(ctx->api.active > 0)
     {
         struct UsbContext* pUsbCtx = (struct UsbContext*)ctx->usb;
         *open = usbFxxIsConnected(pUsbCtx);
@@ -1544,7 +2353,11 @@ SCOPEFUN_API int usbHardwareReset(SFContext* ctx)
 {
     int result = SCOPEFUN_FAILURE;
     apiLock(ctx);
-    if(ctx->api.active > 0)
+    if(ctx->api.active > 0 && replayIsOn(ctx))
+    {
+        result = SCOPEFUN_SUCCESS;
+    }
+    else if(ctx->api.active > 0)
     {
         struct UsbContext* pUsbCtx = (struct UsbContext*)ctx->usb;
         int ret = PUREUSB_FAILURE;
@@ -1565,7 +2378,11 @@ SCOPEFUN_API int usbHardwareConfig1(SFContext* ctx, SHardware1* hw)
 {
     int result = SCOPEFUN_FAILURE;
     apiLock(ctx);
-    if(ctx->api.active > 0)
+    if(ctx->api.active > 0 && replayIsOn(ctx))
+    {
+        result = SCOPEFUN_SUCCESS;
+    }
+    else if(ctx->api.active > 0)
     {
         struct UsbContext* pUsbCtx = (struct UsbContext*)ctx->usb;
         int swap = 0;
@@ -1580,7 +2397,11 @@ SCOPEFUN_API int usbHardwareConfig2(SFContext* ctx, SHardware2* hw)
 {
     int result = SCOPEFUN_FAILURE;
     apiLock(ctx);
-    if(ctx->api.active > 0)
+    if(ctx->api.active > 0 && replayIsOn(ctx))
+    {
+        result = SCOPEFUN_SUCCESS;
+    }
+    else if(ctx->api.active > 0)
     {
         struct UsbContext* pUsbCtx = (struct UsbContext*)ctx->usb;
         int swap = 1;
@@ -1595,7 +2416,11 @@ SCOPEFUN_API int usbHardwareClose(SFContext* ctx)
 {
     int result = SCOPEFUN_FAILURE;
     apiLock(ctx);
-    if(ctx->api.active > 0)
+    if(ctx->api.active > 0 && replayIsOn(ctx))
+    {
+        result = replayClose(ctx);
+    }
+    else if(ctx->api.active > 0)
     {
         struct UsbContext* pUsbCtx = (struct UsbContext*)ctx->usb;
         usbFxxClose(pUsbCtx);
@@ -1609,21 +2434,66 @@ SCOPEFUN_API int usbHardwareCapture(SFContext* ctx, SFrameData* dest, int size,
 {
     int result = SCOPEFUN_FAILURE;
     size = apiMin(size, SCOPEFUN_FRAME_MEMORY);
-    if(ctx->api.active > 0)
+    if(ctx->api.active > 0 && replayIsOn(ctx))
+    {
+        result = replayCapture(ctx, dest, size, transfer);
+    }
+    else if(ctx->api.active > 0)
     {
         struct UsbContext* pUsbCtx = (struct UsbContext*)ctx->usb;
         int swap = 0;
+        // queued mode keeps ctx->api.queue transfers in flight on ep 6
+        if(ctx->api.queue > 0 && !pUsbCtx->stream.active)
+        {
+            usbFxxStreamStart(pUsbCtx, 6, ctx->api.queue, ctx->api.queueSize);
+        }
         int ret = usbFxxTransferDataIn(pUsbCtx, 6, (byte*)dest->data.bytes, size, swap, ctx->api.timeout, transfer);
         result = apiResult(ret);
     }
     return result;
 }
 
+SCOPEFUN_API int usbHardwareCaptureBatch(SFContext* ctx, SFrameData* buffer, int header, int data, int frames, SFrameBatch* batch, int* captured)
+{
+    int result = SCOPEFUN_FAILURE;
+    *captured = 0;
+    int i = 0;
+    for(i = 0; i < frames; i++)
+    {
+        byte* dest = &buffer->data.bytes[batch->offset.bytes[i]];
+        int   headerBytes = 0;
+        int   dataBytes   = 0;
+        if(header > 0)
+        {
+            result = usbHardwareCapture(ctx, (SFrameData*)dest, header, &headerBytes);
+            if(result != SCOPEFUN_SUCCESS)
+            {
+                break;
+            }
+        }
+        if(data > 0)
+        {
+            result = usbHardwareCapture(ctx, (SFrameData*)(dest + header), data, &dataBytes);
+            if(result != SCOPEFUN_SUCCESS)
+            {
+                break;
+            }
+        }
+        batch->length.bytes[i] = headerBytes + dataBytes;
+        *captured = i + 1;
+    }
+    return result;
+}
+
 SCOPEFUN_API int usbHardwareUploadFx2(SFContext* ctx, SFx2* fx2)
 {
     int result = SCOPEFUN_FAILURE;
     apiLock(ctx);
-    if(ctx->api.active > 0)
+    if(ctx->api.active > 0 && replayIsOn(ctx))
+    {
+        result = SCOPEFUN_SUCCESS;
+    }
+    else if(ctx->api.active > 0)
     {
         struct UsbContext* pUsbCtx = (struct UsbContext*)ctx->usb;
         if(pUsbCtx->version == HARDWARE_VERSION_1)
@@ -1646,7 +2516,11 @@ SCOPEFUN_API int usbHardwareUploadFpga(SFContext* ctx, SFpga* buffer)
 {
     int result = SCOPEFUN_FAILURE;
     apiLock(ctx);
-    if(ctx->api.active > 0)
+    if(ctx->api.active > 0 && replayIsOn(ctx))
+    {
+        result = SCOPEFUN_SUCCESS;
+    }
+    else if(ctx->api.active > 0)
     {
         struct UsbContext* pUsbCtx = (struct UsbContext*)ctx->usb;
         if(pUsbCtx->version == HARDWARE_VERSION_1)
@@ -1670,7 +2544,11 @@ SCOPEFUN_API int usbHardwareUploadGenerator(SFContext* ctx, SGenerator* buffer)
 {
     int result = SCOPEFUN_FAILURE;
     apiLock(ctx);
-    if(ctx->api.active > 0)
+    if(ctx->api.active > 0 && replayIsOn(ctx))
+    {
+        result = SCOPEFUN_SUCCESS;
+    }
+    else if(ctx->api.active > 0)
     {
         struct UsbContext* pUsbCtx = (struct UsbContext*)ctx->usb;
         int transfered = 0;
@@ -1684,7 +2562,11 @@ SCOPEFUN_API int usbHardwareEepromRead(SFContext* ctx, SEeprom* buffer, int size
 {
     int result = SCOPEFUN_FAILURE;
     apiLock(ctx);
-    if(ctx->api.active > 0)
+    if(ctx->api.active > 0 && replayIsOn(ctx))
+    {
+        result = replayEepromRead(buffer, size);
+    }
+    else if(ctx->api.active > 0)
     {
         struct UsbContext* pUsbCtx = (struct UsbContext*)ctx->usb;
         if(pUsbCtx->version == HARDWARE_VERSION_1)
@@ -1706,7 +2588,11 @@ SCOPEFUN_API int usbHardwareEepromReadFirmwareID(SFContext* ctx, SEeprom* buffer
 {
    int result = SCOPEFUN_FAILURE;
    apiLock(ctx);
-   if (ctx->api.active > 0)
+   if (ctx->api.active > 0 && replayIsOn(ctx))
+   {
+      result = replayEepromRead(buffer, SCOPEFUN_EEPROM_FIRMWARE_NAME_BYTES);
+   }
+   else if (ctx->api.active > 0)
    {
       struct UsbContext* pUsbCtx = (struct UsbContext*)ctx->usb;
       if (pUsbCtx->version == HARDWARE_VERSION_1)
@@ -1729,7 +2615,11 @@ SCOPEFUN_API int usbHardwareEepromWrite(SFContext* ctx, SEeprom* buffer, int siz
 {
     int result = SCOPEFUN_FAILURE;
     apiLock(ctx);
-    if(ctx->api.active > 0)
+    if(ctx->api.active > 0 && replayIsOn(ctx))
+    {
+        result = SCOPEFUN_SUCCESS;
+    }
+    else if(ctx->api.active > 0)
     {
         struct UsbContext* pUsbCtx = (struct UsbContext*)ctx->usb;
         if(pUsbCtx->version == HARDWARE_VERSION_1)
@@ -1750,7 +2640,11 @@ SCOPEFUN_API int usbHardwareEepromErase(SFContext* ctx)
 {
     int result = SCOPEFUN_FAILURE;
     apiLock(ctx);
-    if(ctx->api.active > 0)
+    if(ctx->api.active > 0 && replayIsOn(ctx))
+    {
+        result = SCOPEFUN_SUCCESS;
+    }
+    else if(ctx->api.active > 0)
     {
         struct UsbContext* pUsbCtx = (struct UsbContext*)ctx->usb;
         UsbEEPROM eeprom;
@@ -1845,6 +2739,7 @@ SCOPEFUN_API int sfHardwareConfig2(SFContext* ctx, SHardware2* hw)
 SCOPEFUN_API int sfHardwareCapture(SFContext* ctx, SFrameData* buffer, int len, int* received,int type)
 {
     int      ret = 0;
+    ularge start = SDL_GetPerformanceCounter();
     if(sfIsSimulate(ctx))
     {
         apiLock(ctx);
@@ -1874,6 +2769,104 @@ SCOPEFUN_API int sfHardwareCapture(SFContext* ctx, SFrameData* buffer, int len,
         ret = netHardwareCapture(ctx, buffer, len, received, type);
         apiUnlock(ctx);
     }
+    apiLock(ctx);
+    captureStats(ctx, start, *received);
+    apiUnlock(ctx);
+    return ret;
+}
+
+SCOPEFUN_API int sfHardwareCaptureBatch(SFContext* ctx, SFrameData* buffer, int size, int header, int data, int frames, SFrameBatch* batch, int* captured)
+{
+    int ret = SCOPEFUN_FAILURE;
+    *captured = 0;
+    header = SDL_max(header, 0);
+    data   = SDL_max(data, 0);
+    int stride = header + data;
+    if(!buffer || !batch || stride <= 0 || size < stride)
+    {
+        return ret;
+    }
+    // frames are laid out back to back with a fixed stride
+    frames = SDL_min(frames, SCOPEFUN_BATCH_FRAMES);
+    frames = SDL_min(frames, apiMin(size, SCOPEFUN_FRAME_MEMORY) / stride);
+    int i = 0;
+    for(i = 0; i < frames; i++)
+    {
+        batch->offset.bytes[i] = i * stride;
+        batch->length.bytes[i] = 0;
+    }
+    // mode queries take the api lock themselves
+    int simulate = sfIsSimulate(ctx);
+    int usb      = sfIsUsb(ctx);
+    int network  = sfIsNetwork(ctx);
+    ularge start = SDL_GetPerformanceCounter();
+    apiLock(ctx);
+    if(simulate)
+    {
+        for(i = 0; i < frames; i++)
+        {
+            if(SDL_AtomicGet((SDL_atomic_t*)&ctx->simulate.on) > 0)
+            {
+                softwareGenerator(ctx->frame.info.version, ctx->frame.info.header, ctx->frame.info.data, ctx->frame.info.packet, ctx, &ctx->simulate.data, (double)SDL_GetTicks() / 1000.0);
+            }
+            int simLen = apiMin(stride, ctx->frame.maxMemory);
+            SDL_memcpy(&buffer->data.bytes[batch->offset.bytes[i]], &ctx->frame.data->data.bytes[0], simLen);
+            batch->length.bytes[i] = simLen;
+        }
+        *captured = frames;
+        ret = SCOPEFUN_SUCCESS;
+    }
+    else if(usb)
+    {
+        ret = usbHardwareCaptureBatch(ctx, buffer, header, data, frames, batch, captured);
+    }
+    else if(network)
+    {
+        ret = netHardwareCaptureBatch(ctx, buffer, header, data, frames, batch, captured);
+    }
+    int bytes = 0;
+    for(i = 0; i < *captured; i++)
+    {
+        bytes += batch->length.bytes[i];
+    }
+    captureStats(ctx, start, bytes);
+    apiUnlock(ctx);
+    return ret;
+}
+
+SCOPEFUN_API int sfHardwareSubscribe(SFContext* ctx, int len, int type, int credit)
+{
+    int ret = SCOPEFUN_FAILURE;
+    if(sfIsNetwork(ctx) && credit > 0)
+    {
+        apiLock(ctx);
+        ret = netHardwareSubscribe(ctx, len, type, credit);
+        apiUnlock(ctx);
+    }
+    return ret;
+}
+SCOPEFUN_API int sfHardwareStream(SFContext* ctx, SFrameData* buffer, int len, int* received, int* sequence)
+{
+    int ret = SCOPEFUN_FAILURE;
+    *received = 0;
+    *sequence = 0;
+    if(sfIsNetwork(ctx))
+    {
+        apiLock(ctx);
+        ret = netHardwareStream(ctx, buffer, len, received, sequence);
+        apiUnlock(ctx);
+    }
+    return ret;
+}
+SCOPEFUN_API int sfHardwareUnsubscribe(SFContext* ctx)
+{
+    int ret = SCOPEFUN_FAILURE;
+    if(sfIsNetwork(ctx))
+    {
+        apiLock(ctx);
+        ret = netHardwareUnsubscribe(ctx);
+        apiUnlock(ctx);
+    }
     return ret;
 }
 
@@ -1982,6 +2975,86 @@ SCOPEFUN_API int sfHardwareClose(SFContext* ctx)
     return ret;
 }
 
+/*--------------------------------------------------------------------
+
+   frame
+
+---------------------------------------------------------------------*/
+ishort frameSign10(uint value)
+{
+    return (ishort)((int)(value << 22) >> 22);
+}
+
+void frameDecode1(byte* data, uint count, ishort* ch0, ishort* ch1, ushort* digital)
+{
+    uint i = 0;
+    for(i = 0; i < count; i++)
+    {
+        byte*  sample = data + i * 6;
+        ushort raw0   = (ushort)(sample[0] | (sample[1] << 8));
+        ushort raw1   = (ushort)(sample[2] | (sample[3] << 8));
+        if(ch0)
+        {
+            ch0[i] = frameSign10(raw0 & 0x3FF);
+        }
+        if(ch1)
+        {
+            ch1[i] = frameSign10(raw1 & 0x3FF);
+        }
+        if(digital)
+        {
+            digital[i] = (ushort)(sample[4] | (sample[5] << 8));
+        }
+    }
+}
+
+void frameDecode2(byte* data, uint count, ishort* ch0, ishort* ch1, ushort* digital)
+{
+    uint i = 0;
+    // 32 bit big endian word: ch0[31:22] ch1[21:12] digital[11:0]
+    for(i = 0; i < count; i++)
+    {
+        byte* sample = data + i * 4;
+        uint  word   = ((uint)sample[0] << 24) | ((uint)sample[1] << 16) | ((uint)sample[2] << 8) | (uint)sample[3];
+        if(ch0)
+        {
+            ch0[i] = (ishort)((int)word >> 22);
+        }
+        if(ch1)
+        {
+            ch1[i] = (ishort)((int)(word << 10) >> 22);
+        }
+        if(digital)
+        {
+            digital[i] = (ushort)(word & 0xFFF);
+        }
+    }
+}
+
+SCOPEFUN_API int sfFrameDecode(SFContext* ctx, SFrameData* frame, int offset, ishort* ch0, ishort* ch1, ushort* digital, int samples, int* decoded)
+{
+    *decoded = 0;
+    if(!frame || offset < 0 || offset >= SCOPEFUN_FRAME_MEMORY || samples <= 0)
+    {
+        return SCOPEFUN_FAILURE;
+    }
+    apiLock(ctx);
+    uint version = ctx->frame.info.version;
+    apiUnlock(ctx);
+    uint sampleSize = (version == HARDWARE_VERSION_1) ? 6 : 4;
+    uint count = apiMin((uint)samples, (SCOPEFUN_FRAME_MEMORY - (uint)offset) / sampleSize);
+    if(version == HARDWARE_VERSION_1)
+    {
+        frameDecode1(&frame->data.bytes[offset], count, ch0, ch1, digital);
+    }
+    else
+    {
+        frameDecode2(&frame->data.bytes[offset], count, ch0, ch1, digital);
+    }
+    *decoded = (int)count;
+    return SCOPEFUN_SUCCESS;
+}
+
 /*--------------------------------------------------------------------
 
    simulate
@@ -1993,36 +3066,252 @@ SCOPEFUN_API int sfHardwareClose(SFContext* ctx)
 #define NUM_SAMPLESF 10000.f
 #define MAXOSCVALUE  511.f
 
-float clamp(float a, float min, float max)
+/*--------------------------------------------------------------------
+   generator
+
+   Waveform phases are 32 bit fixed point cycles, sample j of a frame
+   is at phase + j * step so there is no loop carried state. Samples
+   are produced in blocks with the waveform switch outside the inner
+   loops, which leaves plain arithmetic loops the compiler vectorizes.
+   Noise comes from a counter based hash of (seed, frame, sample), the
+   same seed and time always produce the same frames. On x86 the same
+   loops are compiled a second time for avx2 and picked at runtime.
+---------------------------------------------------------------------*/
+#define GENERATOR_BLOCK 256
+#define GENERATOR_CYCLE 4294967296.0
+
+#if defined(__GNUC__) || defined(__clang__)
+    #define GENERATOR_INLINE static inline __attribute__((always_inline))
+    #if defined(__i386__) || defined(__x86_64__)
+        #define GENERATOR_AVX2
+        #define GENERATOR_TARGET_AVX2 __attribute__((target("avx2")))
+    #endif
+#else
+    #define GENERATOR_INLINE static __forceinline
+#endif
+
+typedef struct
+{
+    ESimulateType type;
+    uint          phase;
+    uint          step;
+    uint          window;
+    uint          windowStep;
+    uint          width;
+    uint          half;
+    float         peakToPeak;
+    float         scale;
+    uint          key;
+} GeneratorChannel;
+
+GENERATOR_INLINE uint generatorHash(uint x)
 {
-    if(a < min)
+    x ^= x >> 16;
+    x *= 0x7FEB352D;
+    x ^= x >> 15;
+    x *= 0x846CA68B;
+    x ^= x >> 16;
+    return x;
+}
+
+uint generatorPhase(double cycles)
+{
+    if(!(cycles == cycles) || cycles > 1e15 || cycles < -1e15)
     {
-        return min;
+        return 0;
     }
-    if(a > max)
+    return (uint)(ularge)((cycles - floor(cycles)) * GENERATOR_CYCLE);
+}
+
+uint generatorWindow(double width)
+{
+    if(!(width > 0))
     {
-        return max;
+        return 0;
     }
-    return a;
+    return width >= 1.0 ? 0xFFFFFFFF : (uint)(width * GENERATOR_CYCLE);
 }
 
-float rand_FloatRange(float a, float b)
+GENERATOR_INLINE float generatorSin(uint phase)
 {
-    return (float)((b - a) * ((float)rand() / RAND_MAX)) + a;
+    // phase as signed is [-1/2,1/2) cycle, sin(pi - x) = sin(x) folds it to [-1/4,1/4]
+    phase = (phase + 0x40000000 > 0x80000000) ? 0x80000000 - phase : phase;
+    float z  = (float)(int)phase * (float)(2.0 * 3.14159265358979323846 / GENERATOR_CYCLE);
+    float z2 = z * z;
+    return z * (1.f + z2 * (-1.f / 6.f + z2 * (1.f / 120.f + z2 * (-1.f / 5040.f + z2 * (1.f / 362880.f)))));
 }
 
-int softwareGenerator1(int frameVersion, int frameHeader, int frameData, int framePacket, SFContext* ctx, SSimulate* sim, double timer)
+void generatorSetup(GeneratorChannel* c, SSimulate* sim, int channel, uint numSamples, double timer, uint frameKey)
+{
+    double numSamplesD = (double)numSamples;
+    double captureTime = sim->time * numSamplesD;
+    double period      = (channel == 0 ? sim->period0 : sim->period1) * numSamplesD / NUM_SAMPLESF;
+    double speed       = channel == 0 ? sim->speed0 : sim->speed1;
+    double volt        = channel == 0 ? sim->voltage0 : sim->voltage1;
+    double cycles      = captureTime / period;
+    double start       = timer * speed;
+    c->type       = channel == 0 ? sim->type0 : sim->type1;
+    c->peakToPeak = channel == 0 ? sim->peakToPeak0 : sim->peakToPeak1;
+    c->scale      = volt != 0 ? (float)(1.0 / (5.0 * volt)) : 0.f;
+    // sin, cos, inc and dec run at (sample / numSamples + start) * captureTime / period cycles
+    c->phase      = generatorPhase(start * cycles);
+    c->step       = generatorPhase(cycles / numSamplesD);
+    // square and delta use the frame itself as the cycle and period / captureTime as pulse width
+    c->window     = generatorPhase(start);
+    c->windowStep = generatorPhase(1.0 / numSamplesD);
+    c->width      = generatorWindow(period / captureTime);
+    c->half       = generatorWindow(period / captureTime / 2.0);
+    c->key        = generatorHash(frameKey + 1 + channel);
+}
+
+GENERATOR_INLINE void generatorAnalog(GeneratorChannel* c, uint first, uint count, ishort* out)
+{
+    float value[GENERATOR_BLOCK];
+    float peakToPeak = c->peakToPeak;
+    float maxpeak    = peakToPeak / 2.f;
+    float minpeak    = -maxpeak;
+    float width      = (float)c->width * (float)(1.0 / GENERATOR_CYCLE);
+    uint  phase      = c->phase + first * c->step;
+    uint  window     = c->window + first * c->windowStep;
+    uint  k = 0;
+    switch(c->type)
+    {
+        case stSin:
+            for(k = 0; k < count; k++)
+            {
+                value[k] = maxpeak * generatorSin(phase + k * c->step);
+            }
+            break;
+        case stCos:
+            for(k = 0; k < count; k++)
+            {
+                value[k] = maxpeak * generatorSin(phase + k * c->step + 0x40000000);
+            }
+            break;
+        case stInc:
+            for(k = 0; k < count; k++)
+            {
+                value[k] = (float)(phase + k * c->step) * (float)(1.0 / GENERATOR_CYCLE) * peakToPeak + minpeak;
+            }
+            break;
+        case stDec:
+            for(k = 0; k < count; k++)
+            {
+                value[k] = (1.f - (float)(phase + k * c->step) * (float)(1.0 / GENERATOR_CYCLE)) * peakToPeak + minpeak;
+            }
+            break;
+        case stConstant:
+            for(k = 0; k < count; k++)
+            {
+                value[k] = peakToPeak;
+            }
+            break;
+        case stRandom:
+            for(k = 0; k < count; k++)
+            {
+                value[k] = (float)(int)generatorHash(c->key + first + k) * (float)(1.0 / 2147483648.0) * maxpeak;
+            }
+            break;
+        case stSquare:
+            for(k = 0; k < count; k++)
+            {
+                value[k] = (window + k * c->windowStep) < c->width ? peakToPeak : 0.f;
+            }
+            break;
+        case stDelta:
+            for(k = 0; k < count; k++)
+            {
+                uint  time = window + k * c->windowStep;
+                float t    = (float)time * (float)(1.0 / GENERATOR_CYCLE) / width / 2.f;
+                float up   = 4.f * t * peakToPeak;
+                float down = 4.f * (0.5f - t) * peakToPeak;
+                value[k] = time < c->half ? up : (time < c->width ? down : 0.f);
+            }
+            break;
+        default:
+            SDL_memset(value, 0, count * sizeof(float));
+            break;
+    };
+    // clamp to [-1,1] without compares so the loop stays branch free
+    float scale = c->scale;
+    for(k = 0; k < count; k++)
+    {
+        float normalized = value[k] * scale;
+        normalized = 0.5f * (fabsf(normalized + 1.f) - fabsf(normalized - 1.f));
+        out[k] = (ishort)(normalized * MAXOSCVALUE);
+    }
+}
+
+GENERATOR_INLINE void generatorBlocks(int frameVersion, byte* data, uint numSamples, GeneratorChannel* channel, uint digitalKey)
+{
+    ishort ch0[GENERATOR_BLOCK];
+    ishort ch1[GENERATOR_BLOCK];
+    uint   first = 0;
+    uint   k = 0;
+    for(first = 0; first < numSamples; first += GENERATOR_BLOCK)
+    {
+        uint count = apiMin(GENERATOR_BLOCK, numSamples - first);
+        generatorAnalog(&channel[0], first, count, ch0);
+        generatorAnalog(&channel[1], first, count, ch1);
+        if(frameVersion == HARDWARE_VERSION_1)
+        {
+            // three little endian 16 bit words: ch0[9:0], ch1[9:0], digital[15:0]
+            ushort* sample = (ushort*)(data + first * 6);
+            for(k = 0; k < count; k++)
+            {
+                sample[k * 3 + 0] = (ushort)(ch0[k] & 0x3FF);
+                sample[k * 3 + 1] = (ushort)(ch1[k] & 0x3FF);
+                sample[k * 3 + 2] = (ushort)generatorHash(digitalKey + first + k);
+            }
+        }
+        else
+        {
+            // 32 bit big endian word: ch0[31:22] ch1[21:12] digital[11:0]
+            uint* sample = (uint*)(data + first * 4);
+            for(k = 0; k < count; k++)
+            {
+                uint word = ((uint)(ch0[k] & 0x3FF) << 22) | ((uint)(ch1[k] & 0x3FF) << 12) | ((generatorHash(digitalKey + first + k) >> 4) & 0xFFF);
+                sample[k] = SDL_SwapBE32(word);
+            }
+        }
+    }
+}
+
+void generatorSamplesScalar(int frameVersion, byte* data, uint numSamples, GeneratorChannel* channel, uint digitalKey)
+{
+    generatorBlocks(frameVersion, data, numSamples, channel, digitalKey);
+}
+
+#if defined(GENERATOR_AVX2)
+GENERATOR_TARGET_AVX2 void generatorSamplesAvx2(int frameVersion, byte* data, uint numSamples, GeneratorChannel* channel, uint digitalKey)
+{
+    generatorBlocks(frameVersion, data, numSamples, channel, digitalKey);
+}
+#endif
+
+void generatorSamples(int frameVersion, byte* data, uint numSamples, SSimulate* sim, double timer, uint frameKey)
+{
+    GeneratorChannel channel[2];
+    generatorSetup(&channel[0], sim, 0, numSamples, timer, frameKey);
+    generatorSetup(&channel[1], sim, 1, numSamples, timer, frameKey);
+    uint digitalKey = generatorHash(frameKey + 3);
+    #if defined(GENERATOR_AVX2)
+    if(SDL_HasAVX2())
+    {
+        generatorSamplesAvx2(frameVersion, data, numSamples, channel, digitalKey);
+        return;
+    }
+    #endif
+    generatorSamplesScalar(frameVersion, data, numSamples, channel, digitalKey);
+}
+
+int softwareGenerator1(int frameVersion, int frameHeader, int frameData, int framePacket, SFContext* ctx, SSimulate* sim, double timer, uint frameKey)
 {
     ctx->frame.received = 0;
     // header, channel0, channel1 and digital bits
     byte* packet = &ctx->frame.data->data.bytes[0];
     uint  numSamples  = (uint)frameData / 6;
-    float numSamplesF = (float)numSamples;
-    // header, channel0, channel1 and digital bits
-    byte*       header = packet;
-    ushort*   channel0 = (ushort*)(packet + frameHeader + 0);
-    ushort*   channel1 = (ushort*)(packet + frameHeader + 2);
-    ushort*   digital = (ushort*)(packet + frameHeader + 4);
+    byte* header = packet;
     // header
     SDL_memset(header, 0, frameHeader);
     // magic
@@ -2035,7 +3324,7 @@ int softwareGenerator1(int frameVersion, int frameHeader, int frameData, int fra
     header[frameHeader - 3] = (frameSize >> 16) & 0xff;
     header[frameHeader - 2] = (frameSize >> 24) & 0xff;
     // ets
-    uint ets = rand() % 32;
+    uint ets = generatorHash(frameKey + 4) % 32;
     header[sim->etsIndex] = ets;
     if(sim->etsActive > 0)
     {
@@ -2049,205 +3338,19 @@ int softwareGenerator1(int frameVersion, int frameHeader, int frameData, int fra
     }
     byte byteCRC = (crc % frameHeader) & 0xFF;
     header[frameHeader - 1] = byteCRC;
-    // analog
-    for(int i = 0; i < 2; i++)
-    {
-        // capture
-        float captureTime = sim->time * numSamplesF;
-        float captureVolt = 0;
-        if(i == 0)
-        {
-            captureVolt = sim->voltage0;
-        }
-        if(i == 1)
-        {
-            captureVolt = sim->voltage1;
-        }
-        // generateTime
-        float generateTime = 0;
-        if(i == 0)
-        {
-            generateTime = (float)timer * sim->speed0;
-        }
-        if(i == 1)
-        {
-            generateTime = (float)timer * sim->speed1;
-        }
-        // peakToPeak
-        float peakToPeak = 0;
-        if(i == 0)
-        {
-            peakToPeak = sim->peakToPeak0;
-        }
-        if(i == 1)
-        {
-            peakToPeak = sim->peakToPeak1;
-        }
-        // peakToPeak
-        ESimulateType type = stSin;
-        if(i == 0)
-        {
-            type = sim->type0;
-        }
-        if(i == 1)
-        {
-            type = sim->type1;
-        }
-        // period
-        float period = 0;
-        if(i == 0)
-        {
-            period = sim->period0;
-        }
-        if(i == 1)
-        {
-            period = sim->period1;
-        }
-        // min/max peak
-        float minpeak = -peakToPeak / 2.f;
-        float maxpeak = peakToPeak / 2.f;
-        // frame size
-        float displayFrameSize = numSamplesF;
-        // period
-        period = period * numSamplesF / NUM_SAMPLESF;
-        // generate
-        srand((uint)SDL_GetPerformanceCounter());
-        float value = 0;
-        for(uint j = 0; j < numSamples; j++)
-        {
-            float sample = (float)j;
-            switch(type)
-            {
-                case stSin:
-                case stCos:
-                    {
-                        float  normalizedTime = sample / displayFrameSize + generateTime;
-                        float  signaltime = (normalizedTime * captureTime);
-                        float            t = signaltime / period;
-                        float    angle2Pi = 2.f * PI * t;
-                        switch(type)
-                        {
-                            case stSin:
-                                value = maxpeak * sinf(angle2Pi);
-                                break;
-                            case stCos:
-                                value = maxpeak * cosf(angle2Pi);
-                                break;
-                            default:
-                                break;
-                        };
-                    }
-                    break;
-                case stDec:
-                case stInc:
-                    {
-                        float  normalizedTime = sample / displayFrameSize + generateTime;
-                        float  normalizedPeriod = period / captureTime;
-                        float mod = fmodf(normalizedTime, normalizedPeriod);
-                        float div = mod / normalizedPeriod;
-                        switch(type)
-                        {
-                            case stInc:
-                                value = div * peakToPeak + minpeak;
-                                break;
-                            case stDec:
-                                value = (1.f - div) * peakToPeak + minpeak;
-                                break;
-                            default:
-                                break;
-                        };
-                    }
-                    break;
-                case stConstant:
-                    value = peakToPeak;
-                    break;
-                case stRandom:
-                    value = rand_FloatRange(-1.f, 1.f) * (peakToPeak / 2.f);
-                    break;
-                case stSquare:
-                    {
-                        float  normalizedTime = sample / displayFrameSize + generateTime;
-                        float  normalizedPeriod = period / captureTime;
-                        float  time = fmodf(normalizedTime, 1.0f);
-                        if(time < normalizedPeriod)
-                        {
-                            value = peakToPeak;
-                        }
-                        else
-                        {
-                            value = 0.f;
-                        }
-                    }
-                    break;
-                case stDelta:
-                    {
-                        float  normalizedTime = sample / displayFrameSize + generateTime;
-                        float  normalizedPeriod = period / captureTime;
-                        float  time = fmodf(normalizedTime, 1.0f);
-                        float      t = time / normalizedPeriod / 2.f;
-                        if(time < normalizedPeriod / 2.f)
-                        {
-                            value = 4.0f * t * peakToPeak;
-                        }
-                        else if(time < normalizedPeriod)
-                        {
-                            value = 4.0f * (0.5f - t) * peakToPeak;
-                        }
-                        else
-                        {
-                            value = 0.f;
-                        }
-                    }
-                    break;
-            };
-            float normalized = value / (5.f * captureVolt);
-            normalized = clamp(normalized, -1.0f, 1.0f);
-            ishort val = (ishort)(normalized * MAXOSCVALUE);
-            if(i == 0)
-            {
-                channel0[j * 3] = val;
-            }
-            if(i == 1)
-            {
-                channel1[j * 3] = val;
-            }
-        }
-    }
-    // digital
-    srand((uint)SDL_GetPerformanceCounter());
-    for(uint i = 0; i < numSamples; i++)
-    {
-        byte digital0 = rand() % 2;
-        byte digital1 = rand() % 2;
-        byte digital2 = rand() % 2;
-        byte digital3 = rand() % 2;
-        byte digital4 = rand() % 2;
-        byte digital5 = rand() % 2;
-        byte digital6 = rand() % 2;
-        byte digital7 = rand() % 2;
-        byte digital8 = rand() % 2;
-        byte digital9 = rand() % 2;
-        byte digital10 = rand() % 2;
-        byte digital11 = rand() % 2;
-        byte digital12 = rand() % 2;
-        byte digital13 = rand() % 2;
-        byte digital14 = rand() % 2;
-        byte digital15 = rand() % 2;
-        ushort bits = digital0 | (digital1 << 1) | (digital2 << 2) | (digital3 << 3) | (digital4 << 4) | (digital5 << 5) | (digital6 << 6) | (digital7 << 7);
-        bits |= digital8 << 8 | (digital9 << 9) | (digital10 << 10) | (digital11 << 11) | (digital12 << 12) | (digital13 << 13) | (digital14 << 14) | (digital15 << 15);
-        digital[i * 3] = bits;
-    }
+    // samples
+    generatorSamples(HARDWARE_VERSION_1, packet + frameHeader, numSamples, sim, timer, frameKey);
+    SDL_memset(packet + frameHeader + numSamples * 6, 0, frameData - numSamples * 6);
     return 0;
 }
 
-int softwareGenerator2(int frameVersion, int frameHeader, int frameData, int framePacket, SFContext* ctx, SSimulate* sim, double timer)
+int softwareGenerator2(int frameVersion, int frameHeader, int frameData, int framePacket, SFContext* ctx, SSimulate* sim, double timer, uint frameKey)
 {
     ctx->frame.received = 0;
     // header, channel0, channel1 and digital bits
     byte* packet = &ctx->frame.data->data.bytes[0];
     SFrameHeader2* header = (SFrameHeader2*)packet;
     uint  numSamples  = (uint)frameData / 4;
-    float numSamplesF = (float)numSamples;
     // header
     SDL_memset(header, 0, frameHeader);
     // magic
@@ -2261,235 +3364,37 @@ int softwareGenerator2(int frameVersion, int frameHeader, int frameData, int fra
     header->hardware.bytes[32 + 2] = (numSamples >> 8) & 0xff;
     header->hardware.bytes[32 + 3] = (numSamples >> 0) & 0xff;
     // ets
-    header->etsDelay.bytes[0] = (byte)(rand() % 32);
+    header->etsDelay.bytes[0] = (byte)(generatorHash(frameKey + 4) % 32);
     if(sim->etsActive > 0)
     {
         timer = 0;
     }
     // crc
     header->crc.bytes[0] = 0;
-    // analog
-    for(int i = 0; i < 2; i++)
-    {
-        // capture
-        float captureTime = sim->time * numSamplesF;
-        float captureVolt = 0;
-        if(i == 0)
-        {
-            captureVolt = sim->voltage0;
-        }
-        if(i == 1)
-        {
-            captureVolt = sim->voltage1;
-        }
-        // generateTime
-        float generateTime = 0;
-        if(i == 0)
-        {
-            generateTime = (float)timer * sim->speed0;
-        }
-        if(i == 1)
-        {
-            generateTime = (float)timer * sim->speed1;
-        }
-        // peakToPeak
-        float peakToPeak = 0;
-        if(i == 0)
-        {
-            peakToPeak = sim->peakToPeak0;
-        }
-        if(i == 1)
-        {
-            peakToPeak = sim->peakToPeak1;
-        }
-        // peakToPeak
-        ESimulateType type = stSin;
-        if(i == 0)
-        {
-            type = sim->type0;
-        }
-        if(i == 1)
-        {
-            type = sim->type1;
-        }
-        // period
-        float period = 0;
-        if(i == 0)
-        {
-            period = sim->period0;
-        }
-        if(i == 1)
-        {
-            period = sim->period1;
-        }
-        // min/max peak
-        float minpeak = -peakToPeak / 2.f;
-        float maxpeak = peakToPeak / 2.f;
-        // frame size
-        float displayFrameSize = numSamplesF;
-        // period
-        period = period * numSamplesF / NUM_SAMPLESF;
-        // generate
-        srand((uint)SDL_GetPerformanceCounter());
-        float value = 0;
-        for(uint j = 0; j < numSamples; j++)
-        {
-            float sample = (float)j;
-            switch(type)
-            {
-                case stSin:
-                case stCos:
-                    {
-                        float  normalizedTime = sample / displayFrameSize + generateTime;
-                        float  signaltime = (normalizedTime * captureTime);
-                        float            t = (signaltime / period);
-                        float    angle2Pi = 2.f * PI * t;
-                        switch(type)
-                        {
-                            case stSin:
-                                value = maxpeak * sinf(angle2Pi);
-                                break;
-                            case stCos:
-                                value = maxpeak * cosf(angle2Pi);
-                                break;
-                            default:
-                                break;
-                        };
-                    }
-                    break;
-                case stDec:
-                case stInc:
-                    {
-                        float  normalizedTime = sample / displayFrameSize + generateTime;
-                        float  normalizedPeriod = period / captureTime;
-                        float mod = fmodf(normalizedTime, normalizedPeriod);
-                        float div = mod / (normalizedPeriod);
-                        switch(type)
-                        {
-                            case stInc:
-                                value = div * peakToPeak + minpeak;
-                                break;
-                            case stDec:
-                                value = (1.f - div) * peakToPeak + minpeak;
-                                break;
-                            default:
-                                break;
-                        };
-                    }
-                    break;
-                case stConstant:
-                    value = peakToPeak;
-                    break;
-                case stRandom:
-                    value = rand_FloatRange(-1.f, 1.f) * (peakToPeak / 2.f);
-                    break;
-                case stSquare:
-                    {
-                        float  normalizedTime = sample / displayFrameSize + generateTime;
-                        float  normalizedPeriod = period / captureTime;
-                        float  time = fmodf(normalizedTime, 1.0f);
-                        if(time < normalizedPeriod)
-                        {
-                            value = peakToPeak;
-                        }
-                        else
-                        {
-                            value = 0.f;
-                        }
-                    }
-                    break;
-                case stDelta:
-                    {
-                        float  normalizedTime = sample / displayFrameSize + generateTime;
-                        float  normalizedPeriod = period / captureTime;
-                        float  time = fmodf(normalizedTime, 1.0f);
-                        float      t = time / normalizedPeriod / 2.f;
-                        if(time < normalizedPeriod / 2.f)
-                        {
-                            value = 4.0f * t * peakToPeak;
-                        }
-                        else if(time < normalizedPeriod)
-                        {
-                            value = 4.0f * (0.5f - t) * peakToPeak;
-                        }
-                        else
-                        {
-                            value = 0.f;
-                        }
-                    }
-                    break;
-            };
-            float normalized = value / (5.f * captureVolt);
-            normalized = clamp(normalized, -1.0f, 1.0f);
-            ishort ival = (ishort)(normalized * MAXOSCVALUE);
-            byte*  data = packet + frameHeader + j * 4;
-            byte* byte0 = (byte*)(data + 0);
-            byte* byte1 = (byte*)(data + 1);
-            byte* byte2 = (byte*)(data + 2);
-            byte* byte3 = (byte*)(data + 3);
-            uint val = ival & 0x1FF;
-            if(ival < 0)
-            {
-                val |= 0x200;
-            }
-            if(i == 0)
-            {
-                ishort shifted0 = (val >> 2);
-                *byte0 = *byte0 | (byte)(shifted0);
-                *byte1 = *byte1 | (byte)(val & 0x3);
-                *byte1 = (*byte1 << 6);
-            }
-            if(i == 1)
-            {
-                ishort shifted1 = (val >> 4);
-                *byte1 = *byte1 | (byte)(shifted1);
-                *byte2 = *byte2 | (byte)(val & 0xF);
-                *byte2 = (*byte2 << 4);
-            }
-        }
-    }
-    // digital
-    srand((uint)SDL_GetPerformanceCounter());
-    for(uint i = 0; i < numSamples; i++)
-    {
-        byte digital0 = rand() % 2;
-        byte digital1 = rand() % 2;
-        byte digital2 = rand() % 2;
-        byte digital3 = rand() % 2;
-        byte digital4 = rand() % 2;
-        byte digital5 = rand() % 2;
-        byte digital6 = rand() % 2;
-        byte digital7 = rand() % 2;
-        byte digital8 = rand() % 2;
-        byte digital9 = rand()  % 2;
-        byte digital10 = rand() % 2;
-        byte digital11 = rand() % 2;
-        byte digital12 = rand() % 2;
-        byte digital13 = rand() % 2;
-        byte digital14 = rand() % 2;
-        byte digital15 = rand() % 2;
-        ushort bits = digital0 | (digital1 << 1) | (digital2 << 2) | (digital3 << 3) | (digital4 << 4) | (digital5 << 5) | (digital6 << 6) | (digital7 << 7);
-        bits |= digital8 << 8 | (digital9 << 9) | (digital10 << 10) | (digital11 << 11) | (digital12 << 12) | (digital13 << 13) | (digital14 << 14) | (digital15 << 15);
-        byte* byte0 = (byte*)(packet + frameHeader + i * 4 + 0);
-        byte* byte1 = (byte*)(packet + frameHeader + i * 4 + 1);
-        byte* byte2 = (byte*)(packet + frameHeader + i * 4 + 2);
-        byte* byte3 = (byte*)(packet + frameHeader + i * 4 + 3);
-        *byte2 = *byte2 | (byte)(bits >> 12);
-        *byte3 = *byte3 | (byte)(bits >> 4);
-    }
+    // samples
+    generatorSamples(HARDWARE_VERSION_2, packet + frameHeader, numSamples, sim, timer, frameKey);
+    SDL_memset(packet + frameHeader + numSamples * 4, 0, frameData - numSamples * 4);
     return 0;
 }
 
 int softwareGenerator(int frameVersion, int frameHeader, int frameData, int framePacket, SFContext* ctx, SSimulate* sim, double time)
 {
-    SDL_memset(&ctx->frame.data->data.bytes[0], 0, apiMin(sizeof(SFrameData), frameHeader + frameData));
+    // frame has to fit into the context buffer
+    if(frameHeader <= 0 || frameData < 0 || (uint)frameHeader > ctx->frame.maxMemory)
+    {
+        return 0;
+    }
+    frameData = apiMin(frameData, ctx->frame.maxMemory - frameHeader);
+    // every frame gets its own noise stream
+    uint frameKey = generatorHash(ctx->simulate.seed ^ generatorHash(ctx->simulate.frame));
+    ctx->simulate.frame++;
     if(frameVersion == HARDWARE_VERSION_1)
     {
-        return softwareGenerator1(frameVersion, frameHeader, frameData, framePacket, ctx, sim, time);
+        return softwareGenerator1(frameVersion, frameHeader, frameData, framePacket, ctx, sim, time, frameKey);
     }
     if(frameVersion == HARDWARE_VERSION_2)
     {
-        return softwareGenerator2(frameVersion, frameHeader, frameData, framePacket, ctx, sim, time);
+        return softwareGenerator2(frameVersion, frameHeader, frameData, framePacket, ctx, sim, time, frameKey);
     }
     return 0;
 }
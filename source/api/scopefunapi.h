@@ -80,6 +80,23 @@ typedef unsigned long long ularge;
 #define SCOPEFUN_CAPTURE_TYPE_HEADER 1
 #define SCOPEFUN_CAPTURE_TYPE_DATA   2
 
+/*----------------------------------------
+
+      ScopeFun API - capture batch
+
+----------------------------------------*/
+#define SCOPEFUN_BATCH_FRAMES        4096
+#define SCOPEFUN_BATCH_WINDOW        8
+
+/*----------------------------------------
+   latency histogram, values below linear
+   get one bucket each, above that every
+   power of two is split into sub buckets
+----------------------------------------*/
+#define SCOPEFUN_LATENCY_LINEAR      32
+#define SCOPEFUN_LATENCY_SUB         16
+#define SCOPEFUN_LATENCY_BUCKETS     (SCOPEFUN_LATENCY_LINEAR + 27 * SCOPEFUN_LATENCY_SUB)
+
 /*----------------------------------------
 
       ScopeFun API - Errors
@@ -92,6 +109,11 @@ typedef unsigned long long ularge;
 
     ScopeFun API - Array
 
+    memory(first,count) returns a writable
+    memoryview over count elements without
+    copying, numpy.frombuffer can wrap it.
+    The view does not keep the owner alive.
+
 ----------------------------------------*/
 #define SCOPEFUN_ARRAY_SWIG(type,size)             \
     %extend{                                     \
@@ -104,6 +126,12 @@ typedef unsigned long long ularge;
         {                                         \
             self->bytes[i] = v;                    \
         }                                         \
+        PyObject* memory(int first,int count)     \
+        {                                         \
+            first = SCOPEFUN_CLAMP(first,0,size);  \
+            count = SCOPEFUN_CLAMP(count,0,size-first); \
+            return SCOPEFUN_MEMORY_VIEW(&self->bytes[first], count * sizeof(type)); \
+        }                                         \
     }                                            \
 
 #ifdef SWIG
@@ -310,6 +338,51 @@ typedef struct
     SArrayFrameData data;
 } SFrameData;
 
+/*----------------------------------------
+   SFrameBatch
+
+   frame i starts at offset[i] bytes in
+   the capture buffer, header first, and
+   length[i] bytes of it were received
+----------------------------------------*/
+SCOPEFUN_ARRAY(SArrayBatchOffset, uint, SCOPEFUN_BATCH_FRAMES);
+SCOPEFUN_ARRAY(SArrayBatchLength, uint, SCOPEFUN_BATCH_FRAMES);
+typedef struct
+{
+    SArrayBatchOffset offset;
+    SArrayBatchLength length;
+} SFrameBatch;
+
+/*----------------------------------------
+   SLatency
+
+   microseconds, percentiles are within
+   1/SCOPEFUN_LATENCY_SUB of the value
+----------------------------------------*/
+SCOPEFUN_ARRAY(SArrayLatency, uint, SCOPEFUN_LATENCY_BUCKETS);
+typedef struct
+{
+    ularge        count;
+    ularge        sum;
+    uint          max;
+    SArrayLatency bucket;
+} SLatency;
+
+/*----------------------------------------
+   SCaptureStats
+
+   one latency sample per sfHardwareCapture
+   or sfHardwareCaptureBatch call, empty
+   counts calls that received nothing
+----------------------------------------*/
+typedef struct
+{
+    ularge   calls;
+    ularge   empty;
+    ularge   bytes;
+    SLatency latency;
+} SCaptureStats;
+
 /*----------------------------------------
    SEEPROM
 ----------------------------------------*/
@@ -536,6 +609,9 @@ typedef enum _EMessage
     mHardwareEepromWrite,
     mHardwareEepromErase,
     mHardwareClose,
+    mHardwareSubscribe,
+    mHardwareCredit,
+    mHardwareStream,
     mLast,
 } EMessage;
 
@@ -637,6 +713,20 @@ typedef struct
     uint                    type;
 } csHardwareCapture;
 
+typedef struct
+{
+    messageHeader           header;
+    uint                    len;
+    uint                    type;
+    uint                    credit;
+} csHardwareSubscribe;
+
+typedef struct
+{
+    messageHeader           header;
+    uint                    credit;
+} csHardwareCredit;
+
 typedef struct
 {
     messageHeader           header;
@@ -781,6 +871,20 @@ typedef struct
     SFrameData              data;
 } scHardwareCapture;
 
+typedef struct
+{
+    messageHeader           header;
+    uint                    credit;
+} scHardwareSubscribe;
+
+typedef struct
+{
+    messageHeader           header;
+    uint                    bytes;
+    uint                    sequence;
+    SFrameData              data;
+} scHardwareStream;
+
 typedef struct
 {
     messageHeader           header;
@@ -845,6 +949,8 @@ typedef struct
     SAtomic           on;
     SSimulate         data;
     uint              active;
+    uint              seed;
+    uint              frame;
 } SCtxSimulate;
 
 typedef struct
@@ -870,6 +976,8 @@ typedef struct
     SAtomic           thread;
     SSpinLock         lock;
     uint              timeout;
+    uint              queue;
+    uint              queueSize;
 } SCtxApi;
 
 typedef struct
@@ -881,6 +989,7 @@ typedef struct
 {
     uint              id;
     uint              connected;
+    uint              stream;
     SDisplay          display;
 } SCtxClient;
 
@@ -893,6 +1002,8 @@ typedef struct
     SCtxClient        client;
     byte*             net;
     byte*             usb;
+    byte*             replay;
+    SCaptureStats     stats;
 } SFContext;
 
 /*----------------------------------------
@@ -922,6 +1033,8 @@ SCOPEFUN_CREATE(SFpga)
 SCOPEFUN_CREATE(SGenerator)
 SCOPEFUN_CREATE(SEeprom)
 SCOPEFUN_CREATE(SActiveClients)
+SCOPEFUN_CREATE(SFrameBatch)
+SCOPEFUN_CREATE(SCaptureStats)
 extern SFrameData* sfCreateSFrameData(SFContext* ctx, int memory);
 
 /*----------------------------------------
@@ -941,6 +1054,8 @@ SCOPEFUN_DELETE(SFpga)
 SCOPEFUN_DELETE(SGenerator)
 SCOPEFUN_DELETE(SEeprom)
 SCOPEFUN_DELETE(SActiveClients)
+SCOPEFUN_DELETE(SFrameBatch)
+SCOPEFUN_DELETE(SCaptureStats)
 
 #ifdef SWIG
 
@@ -979,6 +1094,9 @@ SCOPEFUN_DELETE(SActiveClients)
     SCOPEFUN_API int sfSetFramePacket(SFContext* INPUT, int INPUT);
     SCOPEFUN_API int sfSetSimulateData(SFContext* INPUT, SSimulate* INPUT);
     SCOPEFUN_API int sfSetSimulateOnOff(SFContext* INPUT, int INPUT);
+    SCOPEFUN_API int sfSetSimulateSeed(SFContext* INPUT, int INPUT);
+    SCOPEFUN_API int sfSetCaptureQueue(SFContext* INPUT, int INPUT, int INPUT);
+    SCOPEFUN_API int sfSetReplay(SFContext* INPUT, const char* INPUT, int INPUT);
 
 
     /*----------------------------------------
@@ -993,6 +1111,7 @@ SCOPEFUN_DELETE(SActiveClients)
     SCOPEFUN_API int sfGetClientId(SFContext* INPUT, int* OUTPUT);
     SCOPEFUN_API int sfGetClientActiveIds(SFContext* INPUT, SActiveClients* INOUT);
     SCOPEFUN_API int sfGetSimulateData(SFContext* INPUT, SSimulate* INOUT);
+    SCOPEFUN_API int sfGetCaptureQueue(SFContext* INPUT, int* OUTPUT, int* OUTPUT);
 
 
     /*----------------------------------------
@@ -1017,6 +1136,10 @@ SCOPEFUN_DELETE(SActiveClients)
     SCOPEFUN_API int sfHardwareConfig1(SFContext* INPUT, SHardware1* INPUT);
     SCOPEFUN_API int sfHardwareConfig2(SFContext* INPUT, SHardware2* INPUT);
     SCOPEFUN_API int sfHardwareCapture(SFContext* INPUT, SFrameData* INOUT, int INPUT, int* OUTPUT, int INPUT);
+    SCOPEFUN_API int sfHardwareCaptureBatch(SFContext* INPUT, SFrameData* INOUT, int INPUT, int INPUT, int INPUT, int INPUT, SFrameBatch* INOUT, int* OUTPUT);
+    SCOPEFUN_API int sfHardwareSubscribe(SFContext* INPUT, int INPUT, int INPUT, int INPUT);
+    SCOPEFUN_API int sfHardwareStream(SFContext* INPUT, SFrameData* INOUT, int INPUT, int* OUTPUT, int* OUTPUT);
+    SCOPEFUN_API int sfHardwareUnsubscribe(SFContext* INPUT);
     SCOPEFUN_API int sfHardwareUploadFx2(SFContext* INPUT, SFx2* INPUT);
     SCOPEFUN_API int sfHardwareUploadFpga(SFContext* INPUT, SFpga* INPUT);
     SCOPEFUN_API int sfHardwareUploadGenerator(SFContext* INPUT, SGenerator* INPUT);
@@ -1026,6 +1149,13 @@ SCOPEFUN_DELETE(SActiveClients)
     SCOPEFUN_API int sfHardwareEepromErase(SFContext* INPUT);
     SCOPEFUN_API int sfHardwareClose(SFContext* INPUT);
 
+    /*----------------------------------------
+    stats
+    ----------------------------------------*/
+    SCOPEFUN_API int sfGetCaptureStats(SFContext* INPUT, SCaptureStats* INOUT);
+    SCOPEFUN_API int sfClearCaptureStats(SFContext* INPUT);
+    SCOPEFUN_API int sfLatencyPercentile(SLatency* INPUT, double INPUT, int* OUTPUT);
+
     /*----------------------------------------
     Simulate
     ----------------------------------------*/
@@ -1084,6 +1214,18 @@ SCOPEFUN_DELETE(SActiveClients)
     SCOPEFUN_API int sfSetFramePacket(SFContext* ctx, int packet);
     SCOPEFUN_API int sfSetSimulateData(SFContext* ctx, SSimulate* sim);
     SCOPEFUN_API int sfSetSimulateOnOff(SFContext* ctx, int on);
+    SCOPEFUN_API int sfSetSimulateSeed(SFContext* ctx, int seed);
+    SCOPEFUN_API int sfSetCaptureQueue(SFContext* ctx, int count, int size);
+
+    /*----------------------------------------
+    replay
+
+    usb mode streams frames from a recorded
+    .osc, raw or .rle file instead of the
+    device, rate is in bytes per second and
+    0 is unthrottled, empty path turns it off
+    ----------------------------------------*/
+    SCOPEFUN_API int sfSetReplay(SFContext* ctx, const char* path, int rate);
 
     /*----------------------------------------
     get
@@ -1097,6 +1239,7 @@ SCOPEFUN_DELETE(SActiveClients)
     SCOPEFUN_API int sfGetClientActiveIds(SFContext* ctx, SActiveClients* id);
     SCOPEFUN_API int sfGetClientDisplay(SFContext* ctx, SDisplay* display);
     SCOPEFUN_API int sfGetSimulateData(SFContext* ctx, SSimulate* sim);
+    SCOPEFUN_API int sfGetCaptureQueue(SFContext* ctx, int* depth, int* dropped);
 
     /*----------------------------------------
     client
@@ -1120,7 +1263,11 @@ SCOPEFUN_DELETE(SActiveClients)
     SCOPEFUN_API int sfHardwareConfig1(SFContext* ctx, SHardware1* hw);
     SCOPEFUN_API int sfHardwareConfig2(SFContext* ctx, SHardware2* hw);
     SCOPEFUN_API int sfHardwareCapture(SFContext* ctx, SFrameData* buffer, int len, int* received, int type);
+    SCOPEFUN_API int sfHardwareCaptureBatch(SFContext* ctx, SFrameData* buffer, int size, int header, int data, int frames, SFrameBatch* batch, int* captured);
     SCOPEFUN_API int sfHardwareCaptureOff(SFContext* ctx);
+    SCOPEFUN_API int sfHardwareSubscribe(SFContext* ctx, int len, int type, int credit);
+    SCOPEFUN_API int sfHardwareStream(SFContext* ctx, SFrameData* buffer, int len, int* received, int* sequence);
+    SCOPEFUN_API int sfHardwareUnsubscribe(SFContext* ctx);
     SCOPEFUN_API int sfHardwareUploadFx2(SFContext* ctx, SFx2* fx2);
     SCOPEFUN_API int sfHardwareUploadFpga(SFContext* ctx, SFpga* fpgs);
     SCOPEFUN_API int sfHardwareUploadGenerator(SFContext* ctx, SGenerator* gen);
@@ -1130,6 +1277,28 @@ SCOPEFUN_DELETE(SActiveClients)
     SCOPEFUN_API int sfHardwareEepromErase(SFContext* ctx);
     SCOPEFUN_API int sfHardwareClose(SFContext* ctx);
 
+    /*----------------------------------------
+    frame
+
+    decodes samples starting at byte offset
+    into separate ch0, ch1 and digital arrays,
+    any of them can be NULL
+    ----------------------------------------*/
+    SCOPEFUN_API int sfFrameDecode(SFContext* ctx, SFrameData* frame, int offset, ishort* ch0, ishort* ch1, ushort* digital, int samples, int* decoded);
+
+    /*----------------------------------------
+    stats
+
+    capture stats of a context are a copy,
+    the latency helpers work on any SLatency
+    and are not thread safe
+    ----------------------------------------*/
+    SCOPEFUN_API int sfGetCaptureStats(SFContext* ctx, SCaptureStats* stats);
+    SCOPEFUN_API int sfClearCaptureStats(SFContext* ctx);
+    SCOPEFUN_API int sfLatencyClear(SLatency* latency);
+    SCOPEFUN_API int sfLatencyRecord(SLatency* latency, uint us);
+    SCOPEFUN_API int sfLatencyPercentile(SLatency* latency, double percentile, int* us);
+
     /*----------------------------------------
     simulate
     ----------------------------------------*/
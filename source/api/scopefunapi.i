@@ -5,11 +5,74 @@
 
 #define SCOPEFUN_API_EXPORT
 #include "scopefunapi.h"
-   
+
+#if PY_VERSION_HEX >= 0x03030000
+    #define SCOPEFUN_MEMORY_VIEW(ptr,bytes) PyMemoryView_FromMemory((char*)(ptr), (Py_ssize_t)(bytes), PyBUF_WRITE)
+#else
+    #define SCOPEFUN_MEMORY_VIEW(ptr,bytes) PyBuffer_FromReadWriteMemory((void*)(ptr), (Py_ssize_t)(bytes))
+#endif
+#define SCOPEFUN_CLAMP(v,lo,hi) ((v) < (lo) ? (lo) : ((v) > (hi) ? (hi) : (v)))
+
 %}
 
 // swig
 %include "cpointer.i"
 %include "carrays.i"
 %include "typemaps.i"
-%include "scopefunapi.h"
\ No newline at end of file
+%include "scopefunapi.h"
+
+// frame decode into numpy arrays or any other writable 16 bit buffers, None skips the channel
+%rename(sfFrameDecode) pyFrameDecode;
+%inline %{
+PyObject* pyFrameDecode(SFContext* ctx, SFrameData* frame, int offset, PyObject* ch0, PyObject* ch1, PyObject* digital)
+{
+    PyObject*  input[3] = { ch0, ch1, digital };
+    Py_buffer  view[3];
+    void*      ptr[3]   = { 0, 0, 0 };
+    PyObject*  result   = 0;
+    Py_ssize_t samples  = 0x7FFFFFFF;
+    int        decoded  = 0;
+    int        ret      = SCOPEFUN_FAILURE;
+    int        i        = 0;
+    for(i = 0; i < 3; i++)
+    {
+        view[i].obj = 0;
+    }
+    for(i = 0; i < 3; i++)
+    {
+        if(input[i] == Py_None)
+        {
+            continue;
+        }
+        if(PyObject_GetBuffer(input[i], &view[i], PyBUF_WRITABLE | PyBUF_C_CONTIGUOUS) != 0)
+        {
+            view[i].obj = 0;
+            goto release;
+        }
+        if(view[i].itemsize != 2)
+        {
+            PyErr_SetString(PyExc_TypeError, "sfFrameDecode expects 16 bit buffers");
+            goto release;
+        }
+        ptr[i]  = view[i].buf;
+        samples = SCOPEFUN_CLAMP(view[i].len / 2, 0, samples);
+    }
+    if(samples == 0x7FFFFFFF)
+    {
+        samples = 0;
+    }
+    Py_BEGIN_ALLOW_THREADS
+    ret = sfFrameDecode(ctx, frame, offset, (ishort*)ptr[0], (ishort*)ptr[1], (ushort*)ptr[2], (int)samples, &decoded);
+    Py_END_ALLOW_THREADS
+    result = Py_BuildValue("(ii)", ret, decoded);
+release:
+    for(i = 0; i < 3; i++)
+    {
+        if(view[i].obj)
+        {
+            PyBuffer_Release(&view[i]);
+        }
+    }
+    return result;
+}
+%}
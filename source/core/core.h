@@ -28,6 +28,8 @@ extern "C" {
 #include<core/purec/purec.h>
 #include<core/purec/pureusb.h>
 #include<core/purec/puresocket.h>
+#include<core/purec/puremap.h>
+#include<core/purec/purerle.h>
 };
 
 ////////////////////////////////////////////////////////////////////////////////
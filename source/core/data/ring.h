@@ -158,6 +158,144 @@ public:
     }
 };
 
+////////////////////////////////////////////////////////////////////////////////
+//
+// SpscRing
+//
+//   lock free single producer / single consumer ring, one slot is kept empty
+//   so a ring initialized with size n holds n-1 elements, head and tail are
+//   kept on separate cache lines, the consumer can optionally block in wait()
+//
+///////////////////////////////////////////////////////////////////////////////
+#define CACHE_LINE_SIZE 64
+
+template<class T> class SpscRing
+{
+private:
+    SDL_atomic_t head;
+    byte         padHead[CACHE_LINE_SIZE - sizeof(SDL_atomic_t)];
+    SDL_atomic_t tail;
+    byte         padTail[CACHE_LINE_SIZE - sizeof(SDL_atomic_t)];
+    SDL_atomic_t waiters;
+    SDL_mutex*   mutex;
+    SDL_cond*    cond;
+    T*           data;
+    uint         size;
+    ularge       waitTicks;
+public:
+    SpscRing() : mutex(0), cond(0), data(0), size(0), waitTicks(0)
+    {
+        SDL_AtomicSet(&head, 0);
+        SDL_AtomicSet(&tail, 0);
+        SDL_AtomicSet(&waiters, 0);
+    };
+public:
+    void init(T* buffer, uint isize, int blocking)
+    {
+        destroy();
+        data = buffer;
+        size = isize;
+        waitTicks = 0;
+        SDL_AtomicSet(&head, 0);
+        SDL_AtomicSet(&tail, 0);
+        SDL_AtomicSet(&waiters, 0);
+        if(blocking)
+        {
+            mutex = SDL_CreateMutex();
+            cond  = SDL_CreateCond();
+        }
+    }
+
+    void destroy()
+    {
+        if(cond)
+        {
+            SDL_DestroyCond(cond);
+        }
+        if(mutex)
+        {
+            SDL_DestroyMutex(mutex);
+        }
+        cond  = 0;
+        mutex = 0;
+    }
+public:
+    int isEmpty()
+    {
+        return SDL_AtomicGet(&head) == SDL_AtomicGet(&tail);
+    }
+
+    uint getCount()
+    {
+        uint h = SDL_AtomicGet(&head);
+        uint t = SDL_AtomicGet(&tail);
+        return (h + size - t) % size;
+    }
+
+    ularge getWaitTicks()
+    {
+        return waitTicks;
+    }
+public:
+    // producer
+    int push(const T& elem)
+    {
+        uint h    = SDL_AtomicGet(&head);
+        uint next = (h + 1) % size;
+        if(next == uint(SDL_AtomicGet(&tail)))
+        {
+            return 0;
+        }
+        data[h] = elem;
+        // full barrier, publishes the element and orders the store before the waiters load
+        SDL_AtomicAdd(&head, int(next) - int(h));
+        if(cond && SDL_AtomicGet(&waiters) > 0)
+        {
+            SDL_LockMutex(mutex);
+            SDL_CondSignal(cond);
+            SDL_UnlockMutex(mutex);
+        }
+        return 1;
+    }
+
+    // consumer
+    int pop(T& elem)
+    {
+        uint t = SDL_AtomicGet(&tail);
+        if(t == uint(SDL_AtomicGet(&head)))
+        {
+            return 0;
+        }
+        elem = data[t];
+        SDL_AtomicAdd(&tail, int((t + 1) % size) - int(t));
+        return 1;
+    }
+
+    // consumer, returns non zero when an element is ready
+    int wait(uint timeoutMs)
+    {
+        if(!isEmpty())
+        {
+            return 1;
+        }
+        if(!cond)
+        {
+            return 0;
+        }
+        ularge start = SDL_GetPerformanceCounter();
+        SDL_LockMutex(mutex);
+        SDL_AtomicAdd(&waiters, 1);
+        if(isEmpty())
+        {
+            SDL_CondWaitTimeout(cond, mutex, timeoutMs);
+        }
+        SDL_AtomicAdd(&waiters, -1);
+        SDL_UnlockMutex(mutex);
+        waitTicks += SDL_GetPerformanceCounter() - start;
+        return !isEmpty();
+    }
+};
+
 #endif
 ////////////////////////////////////////////////////////////////////////////////
 //
@@ -30,6 +30,7 @@
     #define FORCE_INLINE            __inline__
     #define CLASS_CDECL             __attribute__ ((__cdecl__))
     #define CLASS_ALIGN(size)       __attribute__ ((aligned(size)))
+    #define THREAD_LOCAL            __thread
 
 #endif
 
@@ -42,6 +43,7 @@
     #define FORCE_INLINE            __forceinline
     #define CLASS_CDECL              __cdecl
     #define CLASS_ALIGN(size)       __declspec(align(size))
+    #define THREAD_LOCAL            __declspec(thread)
 
     #pragma warning( disable : 4200 )
     #pragma warning( disable : 4244 )
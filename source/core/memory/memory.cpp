@@ -25,9 +25,36 @@
 ///////////////////////////////////////////////////////////////////////////////
 MANAGER_REGISTER(Memory);
 
+static THREAD_LOCAL MemoryCache memoryCache;
+
+static MemoryBlock* memoryHeader(void* ptr)
+{
+    return (MemoryBlock*)((byte*)ptr - MEMORY_HEADER);
+}
+
+static void* memoryPayload(MemoryBlock* block)
+{
+    return (byte*)block + MEMORY_HEADER;
+}
+
+static uint memoryClassIndex(ularge size)
+{
+    uint index = 0;
+    while(index < MEMORY_CLASS_COUNT && (ularge(1) << (index + MEMORY_CLASS_SHIFT)) < size)
+    {
+        index++;
+    }
+    return index;
+}
+
 MemoryManager::MemoryManager()
 {
     lock = 0;
+    SDL_memset(sizeClass, 0, sizeof(sizeClass));
+    for(uint i = 0; i < MEMORY_CLASS_COUNT; i++)
+    {
+        sizeClass[i].blockSize = ularge(1) << (i + MEMORY_CLASS_SHIFT);
+    }
 }
 
 ularge MemoryManager::maximum(ularge min, ularge max)
@@ -50,35 +77,240 @@ ularge MemoryManager::maximum(ularge min, ularge max)
     return allocated;
 }
 
-void* MemoryManager::allocate(ularge size, int align)
+////////////////////////////////////////////////////////////////////////////////
+// size classes
+////////////////////////////////////////////////////////////////////////////////
+void MemoryManager::classLock(MemoryClass& mc)
 {
-    SDL_AtomicLock(&lock);
-    void* ptr = SDL_malloc(size);
-    if(!ptr)
+    if(SDL_AtomicTryLock(&mc.lock) == SDL_FALSE)
+    {
+        SDL_AtomicLock(&mc.lock);
+        mc.stats.contention++;
+    }
+}
+
+void MemoryManager::classPublish(uint index, MemoryCache& cache)
+{
+    MemoryClass& mc = sizeClass[index];
+    mc.stats.allocs += cache.allocs[index];
+    mc.stats.frees  += cache.frees[index];
+    cache.allocs[index] = 0;
+    cache.frees[index]  = 0;
+}
+
+int MemoryManager::classRefill(uint index, MemoryCache& cache)
+{
+    MemoryClass& mc = sizeClass[index];
+    classLock(mc);
+    classPublish(index, cache);
+    // carve a new chunk when the shared list is empty
+    if(!mc.free)
+    {
+        ularge stride = MEMORY_HEADER + mc.blockSize;
+        ularge blocks = max<ularge>(MEMORY_CACHE_BATCH, MEMORY_CHUNK_SIZE / stride);
+        ularge bytes  = blocks * stride + MEMORY_ALIGN;
+        byte*  chunk  = (byte*)SDL_malloc(bytes);
+        if(!chunk)
+        {
+            SDL_AtomicUnlock(&mc.lock);
+            return 0;
+        }
+        byte* aligned = (byte*)((ularge(chunk) + MEMORY_ALIGN - 1) & ~ularge(MEMORY_ALIGN - 1));
+        for(ularge i = 0; i < blocks; i++)
+        {
+            MemoryBlock* block = (MemoryBlock*)(aligned + (blocks - 1 - i) * stride);
+            block->base      = chunk;
+            block->size      = 0;
+            block->sizeClass = index;
+            block->align     = MEMORY_ALIGN;
+            block->next      = mc.free;
+            mc.free          = block;
+        }
+        mc.stats.bytesReserved += bytes;
+    }
+    // move a batch into the thread cache
+    for(uint i = 0; i < MEMORY_CACHE_BATCH && mc.free; i++)
+    {
+        MemoryBlock* block = mc.free;
+        mc.free            = block->next;
+        block->next        = cache.free[index];
+        cache.free[index]  = block;
+        cache.count[index]++;
+    }
+    SDL_AtomicUnlock(&mc.lock);
+    return 1;
+}
+
+void MemoryManager::classSpill(uint index, MemoryCache& cache, uint keep)
+{
+    MemoryClass& mc = sizeClass[index];
+    classLock(mc);
+    classPublish(index, cache);
+    while(cache.count[index] > keep)
+    {
+        MemoryBlock* block = cache.free[index];
+        cache.free[index]  = block->next;
+        cache.count[index]--;
+        block->next = mc.free;
+        mc.free     = block;
+    }
+    SDL_AtomicUnlock(&mc.lock);
+}
+
+void MemoryManager::threadFlush()
+{
+    MemoryCache& cache = memoryCache;
+    for(uint i = 0; i < MEMORY_CLASS_COUNT; i++)
+    {
+        classSpill(i, cache, 0);
+    }
+}
+
+ularge MemoryManager::getClassSize(uint index)
+{
+    return sizeClass[min<uint>(index, MEMORY_LARGE)].blockSize;
+}
+
+void MemoryManager::getStats(uint index, MemoryClassStats& stats)
+{
+    MemoryClass& mc = sizeClass[min<uint>(index, MEMORY_LARGE)];
+    SDL_AtomicLock(&mc.lock);
+    stats = mc.stats;
+    if(index < MEMORY_LARGE)
+    {
+        stats.bytesLive = stats.allocs > stats.frees ? (stats.allocs - stats.frees) * mc.blockSize : 0;
+    }
+    SDL_AtomicUnlock(&mc.lock);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// allocate
+////////////////////////////////////////////////////////////////////////////////
+void* MemoryManager::allocateLarge(ularge size, int align)
+{
+    MemoryClass& mc = sizeClass[MEMORY_LARGE];
+    ularge bytes = size + MEMORY_HEADER + align;
+    byte*  base  = (byte*)SDL_malloc(bytes);
+    if(!base)
     {
         CORE_ABORT("memory allocation failed", 0);
+        return 0;
     }
-    SDL_AtomicUnlock(&lock);
+    byte* ptr = (byte*)((ularge(base) + MEMORY_HEADER + align - 1) & ~ularge(align - 1));
+    MemoryBlock* block = memoryHeader(ptr);
+    block->next      = 0;
+    block->base      = base;
+    block->size      = size;
+    block->sizeClass = MEMORY_LARGE;
+    block->align     = align;
+    classLock(mc);
+    mc.stats.allocs++;
+    mc.stats.bytesLive     += size;
+    mc.stats.bytesReserved += bytes;
+    SDL_AtomicUnlock(&mc.lock);
     return ptr;
 }
 
+void* MemoryManager::allocate(ularge size, int align)
+{
+    align = max<int>(align, 16);
+    uint index = memoryClassIndex(size);
+    if(index == MEMORY_LARGE || align > MEMORY_ALIGN)
+    {
+        return allocateLarge(size, align);
+    }
+    MemoryCache& cache = memoryCache;
+    if(!cache.free[index] && !classRefill(index, cache))
+    {
+        CORE_ABORT("memory allocation failed", 0);
+        return 0;
+    }
+    MemoryBlock* block = cache.free[index];
+    cache.free[index]  = block->next;
+    cache.count[index]--;
+    cache.allocs[index]++;
+    block->next = 0;
+    block->size = size;
+    return memoryPayload(block);
+}
+
 void* MemoryManager::reallocate(void* ptr, ularge newsize)
 {
-    SDL_AtomicLock(&lock);
-    void* newptr = SDL_realloc(ptr, newsize);
-    if(!newptr)
+    if(!ptr)
     {
-        CORE_ABORT("memory reallocation failed", 0);
+        return allocate(newsize);
     }
-    SDL_AtomicUnlock(&lock);
+    MemoryBlock* block = memoryHeader(ptr);
+    // pooled block still fits
+    if(block->sizeClass < MEMORY_LARGE && newsize <= sizeClass[block->sizeClass].blockSize)
+    {
+        block->size = newsize;
+        return ptr;
+    }
+    // large block, let the system grow it in place when it can
+    if(block->sizeClass == MEMORY_LARGE && newsize > sizeClass[MEMORY_LARGE - 1].blockSize)
+    {
+        MemoryClass& mc = sizeClass[MEMORY_LARGE];
+        int    align   = block->align;
+        ularge oldsize = block->size;
+        ularge offset  = (byte*)ptr - (byte*)block->base;
+        ularge oldbytes = oldsize + MEMORY_HEADER + align;
+        ularge bytes   = newsize + MEMORY_HEADER + align;
+        byte*  base    = (byte*)SDL_realloc(block->base, bytes);
+        if(!base)
+        {
+            CORE_ABORT("memory reallocation failed", 0);
+            return 0;
+        }
+        byte* newptr = (byte*)((ularge(base) + MEMORY_HEADER + align - 1) & ~ularge(align - 1));
+        if(newptr != base + offset)
+        {
+            SDL_memmove(newptr - MEMORY_HEADER, base + offset - MEMORY_HEADER, MEMORY_HEADER + min(oldsize, newsize));
+        }
+        block = memoryHeader(newptr);
+        block->base = base;
+        block->size = newsize;
+        classLock(mc);
+        mc.stats.bytesLive     += newsize - oldsize;
+        mc.stats.bytesReserved += bytes - oldbytes;
+        SDL_AtomicUnlock(&mc.lock);
+        return newptr;
+    }
+    // move between classes
+    void* newptr = allocate(newsize, block->align);
+    SDL_memcpy(newptr, ptr, min(block->size, newsize));
+    free(ptr);
     return newptr;
 }
 
 void MemoryManager::free(void* ptr)
 {
-    SDL_AtomicLock(&lock);
-    SDL_free(ptr);
-    SDL_AtomicUnlock(&lock);
+    if(!ptr)
+    {
+        return;
+    }
+    MemoryBlock* block = memoryHeader(ptr);
+    uint index = block->sizeClass;
+    if(index == MEMORY_LARGE)
+    {
+        MemoryClass& mc = sizeClass[MEMORY_LARGE];
+        classLock(mc);
+        mc.stats.frees++;
+        mc.stats.bytesLive     -= block->size;
+        mc.stats.bytesReserved -= block->size + MEMORY_HEADER + block->align;
+        SDL_AtomicUnlock(&mc.lock);
+        SDL_free(block->base);
+        return;
+    }
+    MemoryCache& cache = memoryCache;
+    block->next       = cache.free[index];
+    cache.free[index] = block;
+    cache.count[index]++;
+    cache.frees[index]++;
+    if(cache.count[index] > MEMORY_CACHE_BLOCKS)
+    {
+        classSpill(index, cache, MEMORY_CACHE_BATCH);
+    }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
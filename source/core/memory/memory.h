@@ -21,6 +21,81 @@
 #ifndef __CORE__MEMORY__
 #define __CORE__MEMORY__
 
+#define MEMORY_ALIGN         64
+#define MEMORY_HEADER        64
+#define MEMORY_CLASS_SHIFT   6
+#define MEMORY_CLASS_COUNT   11
+#define MEMORY_LARGE         MEMORY_CLASS_COUNT
+#define MEMORY_CACHE_BLOCKS  32
+#define MEMORY_CACHE_BATCH   16
+#define MEMORY_CHUNK_SIZE    (256 * 1024)
+
+////////////////////////////////////////////////////////////////////////////////
+//
+// MemoryBlock
+//
+//   header stored in front of every allocation, pooled blocks are carved
+//   from MEMORY_ALIGN aligned chunks, large blocks come from SDL_malloc
+//
+////////////////////////////////////////////////////////////////////////////////
+class MemoryBlock
+{
+public:
+    MemoryBlock* next;
+    void*        base;
+    ularge       size;
+    int          sizeClass;
+    int          align;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+//
+// MemoryClassStats
+//
+//   counters are published from the thread caches in batches, so they lag
+//   by at most MEMORY_CACHE_BLOCKS per class and thread
+//
+////////////////////////////////////////////////////////////////////////////////
+class MemoryClassStats
+{
+public:
+    ularge allocs;
+    ularge frees;
+    ularge bytesLive;
+    ularge bytesReserved;
+    ularge contention;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+//
+// MemoryClass
+//
+////////////////////////////////////////////////////////////////////////////////
+class MemoryClass
+{
+public:
+    SDL_SpinLock     lock;
+    ularge           blockSize;
+    MemoryBlock*     free;
+    MemoryClassStats stats;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+//
+// MemoryCache
+//
+//   per thread free lists, no locking on the fast path
+//
+////////////////////////////////////////////////////////////////////////////////
+class MemoryCache
+{
+public:
+    MemoryBlock* free[MEMORY_CLASS_COUNT];
+    uint         count[MEMORY_CLASS_COUNT];
+    ularge       allocs[MEMORY_CLASS_COUNT];
+    ularge       frees[MEMORY_CLASS_COUNT];
+};
+
 ////////////////////////////////////////////////////////////////////////////////
 //
 // MemoryManager
@@ -30,6 +105,8 @@ class MemoryManager : public Manager
 {
 public:
     SDL_SpinLock lock;
+private:
+    MemoryClass  sizeClass[MEMORY_CLASS_COUNT + 1];
 public:
     MemoryManager();
 public:
@@ -37,6 +114,18 @@ public:
     void*  reallocate(void* ptr, ularge newsize);
     void   free(void* ptr);
     ularge maximum(ularge min, ularge max);
+public:
+    // return the calling thread cache to the shared pools, call before a thread that
+    // frees through pMemory exits, threads that never allocate or free have no cache
+    void   threadFlush();
+    ularge getClassSize(uint index);
+    void   getStats(uint index, MemoryClassStats& stats);
+private:
+    void   classLock(MemoryClass& mc);
+    void   classPublish(uint index, MemoryCache& cache);
+    int    classRefill(uint index, MemoryCache& cache);
+    void   classSpill(uint index, MemoryCache& cache, uint keep);
+    void*  allocateLarge(ularge size, int align);
 };
 
 MANAGER_POINTER(Memory);
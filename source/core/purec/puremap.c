@@ -0,0 +1,389 @@
+////////////////////////////////////////////////////////////////////////////////
+//    ScopeFun Oscilloscope ( http://www.scopefun.com )
+//    Copyright (C) 2016 - 2019 David Košenina
+//
+//    This file is part of ScopeFun Oscilloscope.
+//
+//    ScopeFun Oscilloscope is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    ScopeFun Oscilloscope is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with this ScopeFun Oscilloscope.  If not, see <http://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////
+#include<core/purec/purec.h>
+#include<core/purec/puremap.h>
+
+#include<string.h>
+
+#if defined(PLATFORM_WIN) || defined(PLATFORM_MINGW)
+    #define PSAPI_VERSION 2
+    #include <windows.h>
+    #include <psapi.h>
+#else
+    #include <sys/mman.h>
+    #include <sys/types.h>
+    #include <sys/resource.h>
+    #include <fcntl.h>
+    #include <unistd.h>
+    #include <stdio.h>
+#endif
+#if defined(PLATFORM_MAC)
+    #include <mach/mach.h>
+#endif
+
+#define PUREMAP_GRANULARITY 65536ULL
+
+/*--------------------------------------------------------------------
+   windows are aligned to the allocation granularity so one window
+   never has to be split by the caller
+--------------------------------------------------------------------*/
+static int mapView(MapContext* ctx, MapView* view, unsigned long long pos)
+{
+    unsigned long long offset = pos - (pos % ctx->window);
+    unsigned long long size   = ctx->window;
+    if(view->ptr && view->offset == offset)
+    {
+        return PUREMAP_SUCCESS;
+    }
+    mapRelease(ctx, view);
+    if(offset >= ctx->size)
+    {
+        return PUREMAP_FAILURE;
+    }
+    if(offset + size > ctx->size)
+    {
+        size = ctx->size - offset;
+    }
+    #if defined(PLATFORM_WIN) || defined(PLATFORM_MINGW)
+    view->ptr = (char*)MapViewOfFile((HANDLE)ctx->mapping, FILE_MAP_ALL_ACCESS, (DWORD)(offset >> 32), (DWORD)(offset & 0xFFFFFFFF), (SIZE_T)size);
+    if(!view->ptr)
+    {
+        return PUREMAP_FAILURE;
+    }
+    #else
+    void* ptr = mmap(0, (size_t)size, PROT_READ | PROT_WRITE, MAP_SHARED, ctx->file, (off_t)offset);
+    if(ptr == MAP_FAILED)
+    {
+        view->ptr = 0;
+        return PUREMAP_FAILURE;
+    }
+    view->ptr = (char*)ptr;
+    if(view->advice == PUREMAP_SEQUENTIAL)
+    {
+        madvise(ptr, (size_t)size, MADV_SEQUENTIAL);
+    }
+    if(view->advice == PUREMAP_RANDOM)
+    {
+        madvise(ptr, (size_t)size, MADV_RANDOM);
+    }
+    #endif
+    view->offset = offset;
+    view->size   = size;
+    return PUREMAP_SUCCESS;
+}
+
+static int mapCopy(MapContext* ctx, MapView* view, unsigned long long pos, char* buffer, unsigned long long size, int write)
+{
+    if(pos + size > ctx->size)
+    {
+        return PUREMAP_FAILURE;
+    }
+    while(size > 0)
+    {
+        if(mapView(ctx, view, pos) != PUREMAP_SUCCESS)
+        {
+            return PUREMAP_FAILURE;
+        }
+        unsigned long long at    = pos - view->offset;
+        unsigned long long chunk = view->size - at;
+        if(chunk > size)
+        {
+            chunk = size;
+        }
+        if(write)
+        {
+            memcpy(view->ptr + at, buffer, (size_t)chunk);
+        }
+        else
+        {
+            memcpy(buffer, view->ptr + at, (size_t)chunk);
+        }
+        buffer += chunk;
+        pos    += chunk;
+        size   -= chunk;
+    }
+    return PUREMAP_SUCCESS;
+}
+
+int mapOpen(MapContext* ctx, const char* path, unsigned long long size, unsigned long long window)
+{
+    memset(ctx, 0, sizeof(MapContext));
+    window = window - (window % PUREMAP_GRANULARITY);
+    if(window < PUREMAP_GRANULARITY)
+    {
+        window = PUREMAP_GRANULARITY;
+    }
+    ctx->window = window;
+    #if defined(PLATFORM_WIN) || defined(PLATFORM_MINGW)
+    HANDLE file = CreateFileA(path, GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ | FILE_SHARE_WRITE, 0, CREATE_ALWAYS, FILE_ATTRIBUTE_TEMPORARY, 0);
+    if(file == INVALID_HANDLE_VALUE)
+    {
+        return PUREMAP_FAILURE;
+    }
+    ctx->file = (void*)file;
+    #else
+    ctx->file = open(path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if(ctx->file < 0)
+    {
+        return PUREMAP_FAILURE;
+    }
+    #endif
+    if(mapResize(ctx, size) != PUREMAP_SUCCESS)
+    {
+        mapClose(ctx);
+        return PUREMAP_FAILURE;
+    }
+    return PUREMAP_SUCCESS;
+}
+
+/*--------------------------------------------------------------------
+   all views must be released before resizing, growing reserves the
+   blocks so a full disk fails here instead of faulting a mapped write
+--------------------------------------------------------------------*/
+int mapResize(MapContext* ctx, unsigned long long size)
+{
+    #if defined(PLATFORM_WIN) || defined(PLATFORM_MINGW)
+    LARGE_INTEGER end;
+    end.QuadPart = (LONGLONG)size;
+    if(ctx->mapping)
+    {
+        CloseHandle((HANDLE)ctx->mapping);
+        ctx->mapping = 0;
+    }
+    if(!SetFilePointerEx((HANDLE)ctx->file, end, 0, FILE_BEGIN) || !SetEndOfFile((HANDLE)ctx->file))
+    {
+        return PUREMAP_FAILURE;
+    }
+    ctx->mapping = (void*)CreateFileMappingA((HANDLE)ctx->file, 0, PAGE_READWRITE, (DWORD)(size >> 32), (DWORD)(size & 0xFFFFFFFF), 0);
+    if(!ctx->mapping)
+    {
+        return PUREMAP_FAILURE;
+    }
+    #else
+    if(size > ctx->size)
+    {
+        #if defined(PLATFORM_MAC)
+        fstore_t store;
+        memset(&store, 0, sizeof(fstore_t));
+        store.fst_flags   = F_ALLOCATEALL;
+        store.fst_posmode = F_PEOFPOSMODE;
+        store.fst_length  = (off_t)(size - ctx->size);
+        if(fcntl(ctx->file, F_PREALLOCATE, &store) == -1 || ftruncate(ctx->file, (off_t)size) != 0)
+        {
+            return PUREMAP_FAILURE;
+        }
+        #else
+        if(posix_fallocate(ctx->file, 0, (off_t)size) != 0)
+        {
+            return PUREMAP_FAILURE;
+        }
+        #endif
+    }
+    else if(ftruncate(ctx->file, (off_t)size) != 0)
+    {
+        return PUREMAP_FAILURE;
+    }
+    #endif
+    ctx->size = size;
+    return PUREMAP_SUCCESS;
+}
+
+int mapRead(MapContext* ctx, MapView* view, unsigned long long pos, void* buffer, unsigned long long size)
+{
+    return mapCopy(ctx, view, pos, (char*)buffer, size, 0);
+}
+
+int mapWrite(MapContext* ctx, MapView* view, unsigned long long pos, const void* buffer, unsigned long long size)
+{
+    return mapCopy(ctx, view, pos, (char*)buffer, size, 1);
+}
+
+/*--------------------------------------------------------------------
+   dirty pages are scheduled for write back without waiting on them
+--------------------------------------------------------------------*/
+int mapRelease(MapContext* ctx, MapView* view)
+{
+    if(!view->ptr)
+    {
+        return PUREMAP_SUCCESS;
+    }
+    #if defined(PLATFORM_WIN) || defined(PLATFORM_MINGW)
+    UnmapViewOfFile(view->ptr);
+    #else
+    msync(view->ptr, (size_t)view->size, MS_ASYNC);
+    munmap(view->ptr, (size_t)view->size);
+    #endif
+    view->ptr    = 0;
+    view->offset = 0;
+    view->size   = 0;
+    return PUREMAP_SUCCESS;
+}
+
+int mapClose(MapContext* ctx)
+{
+    #if defined(PLATFORM_WIN) || defined(PLATFORM_MINGW)
+    if(ctx->mapping)
+    {
+        CloseHandle((HANDLE)ctx->mapping);
+    }
+    if(ctx->file)
+    {
+        CloseHandle((HANDLE)ctx->file);
+    }
+    ctx->mapping = 0;
+    ctx->file    = 0;
+    #else
+    if(ctx->file >= 0)
+    {
+        close(ctx->file);
+    }
+    ctx->file = -1;
+    #endif
+    ctx->size = 0;
+    return PUREMAP_SUCCESS;
+}
+
+/*--------------------------------------------------------------------
+   anonymous memory, on windows the range is reserved and committed
+   in pieces, elsewhere the kernel backs pages on first touch and
+   commit only has to make sure the range is inside the reservation
+--------------------------------------------------------------------*/
+void* mapReserve(unsigned long long size)
+{
+    #if defined(PLATFORM_WIN) || defined(PLATFORM_MINGW)
+    return VirtualAlloc(0, (SIZE_T)size, MEM_RESERVE, PAGE_NOACCESS);
+    #else
+    int flags = MAP_PRIVATE | MAP_ANONYMOUS;
+    #if defined(MAP_NORESERVE)
+    flags |= MAP_NORESERVE;
+    #endif
+    void* ptr = mmap(0, (size_t)size, PROT_READ | PROT_WRITE, flags, -1, 0);
+    if(ptr == MAP_FAILED)
+    {
+        return 0;
+    }
+    return ptr;
+    #endif
+}
+
+int mapCommit(void* base, unsigned long long offset, unsigned long long size)
+{
+    if(!base)
+    {
+        return PUREMAP_FAILURE;
+    }
+    #if defined(PLATFORM_WIN) || defined(PLATFORM_MINGW)
+    if(!VirtualAlloc((char*)base + offset, (SIZE_T)size, MEM_COMMIT, PAGE_READWRITE))
+    {
+        return PUREMAP_FAILURE;
+    }
+    #endif
+    return PUREMAP_SUCCESS;
+}
+
+int mapUnreserve(void* base, unsigned long long size)
+{
+    if(!base)
+    {
+        return PUREMAP_SUCCESS;
+    }
+    #if defined(PLATFORM_WIN) || defined(PLATFORM_MINGW)
+    return VirtualFree(base, 0, MEM_RELEASE) ? PUREMAP_SUCCESS : PUREMAP_FAILURE;
+    #else
+    return munmap(base, (size_t)size) == 0 ? PUREMAP_SUCCESS : PUREMAP_FAILURE;
+    #endif
+}
+
+/*--------------------------------------------------------------------
+   memory that can be used without swapping, linux reports
+   MemAvailable which includes reclaimable page cache
+--------------------------------------------------------------------*/
+unsigned long long mapMemoryAvailable()
+{
+    #if defined(PLATFORM_WIN) || defined(PLATFORM_MINGW)
+    MEMORYSTATUSEX status;
+    status.dwLength = sizeof(status);
+    if(!GlobalMemoryStatusEx(&status))
+    {
+        return 0;
+    }
+    return status.ullAvailPhys;
+    #elif defined(PLATFORM_MAC)
+    vm_statistics64_data_t stats;
+    mach_msg_type_number_t count = HOST_VM_INFO64_COUNT;
+    if(host_statistics64(mach_host_self(), HOST_VM_INFO64, (host_info64_t)&stats, &count) != KERN_SUCCESS)
+    {
+        return 0;
+    }
+    return (unsigned long long)(stats.free_count + stats.inactive_count) * (unsigned long long)sysconf(_SC_PAGESIZE);
+    #else
+    unsigned long long available = 0;
+    FILE* f = fopen("/proc/meminfo", "r");
+    if(f)
+    {
+        char line[256];
+        while(fgets(line, sizeof(line), f))
+        {
+            unsigned long long kb = 0;
+            if(sscanf(line, "MemAvailable: %llu kB", &kb) == 1)
+            {
+                available = kb * 1024ULL;
+                break;
+            }
+        }
+        fclose(f);
+    }
+    if(available == 0)
+    {
+        available = (unsigned long long)sysconf(_SC_AVPHYS_PAGES) * (unsigned long long)sysconf(_SC_PAGESIZE);
+    }
+    return available;
+    #endif
+}
+
+unsigned long long mapPeakResident()
+{
+    #if defined(PLATFORM_WIN) || defined(PLATFORM_MINGW)
+    PROCESS_MEMORY_COUNTERS counters;
+    if(!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+    {
+        return 0;
+    }
+    return counters.PeakWorkingSetSize;
+    #else
+    struct rusage usage;
+    if(getrusage(RUSAGE_SELF, &usage) != 0)
+    {
+        return 0;
+    }
+    #if defined(PLATFORM_MAC)
+    return (unsigned long long)usage.ru_maxrss;
+    #else
+    return (unsigned long long)usage.ru_maxrss * 1024ULL;
+    #endif
+    #endif
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//
+//
+////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,92 @@
+////////////////////////////////////////////////////////////////////////////////
+//    ScopeFun Oscilloscope ( http://www.scopefun.com )
+//    Copyright (C) 2016 - 2019 David Košenina
+//
+//    This file is part of ScopeFun Oscilloscope.
+//
+//    ScopeFun Oscilloscope is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    ScopeFun Oscilloscope is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with this ScopeFun Oscilloscope.  If not, see <http://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////
+#ifndef __PUREC_MAP__
+#define __PUREC_MAP__
+
+#define PUREMAP_SUCCESS  0
+#define PUREMAP_FAILURE -1
+
+////////////////////////////////////////////////////////////////////////////////
+// access hints
+////////////////////////////////////////////////////////////////////////////////
+#define PUREMAP_NORMAL      0
+#define PUREMAP_SEQUENTIAL  1
+#define PUREMAP_RANDOM      2
+
+////////////////////////////////////////////////////////////////////////////////
+// MapContext
+////////////////////////////////////////////////////////////////////////////////
+struct MapContext
+{
+#if defined(PLATFORM_WIN) || defined(PLATFORM_MINGW)
+    void*              file;
+    void*              mapping;
+#else
+    int                file;
+#endif
+    unsigned long long size;
+    unsigned long long window;
+};
+typedef struct MapContext MapContext;
+
+////////////////////////////////////////////////////////////////////////////////
+// MapView, one window of the file, each thread should use its own view
+////////////////////////////////////////////////////////////////////////////////
+struct MapView
+{
+    char*              ptr;
+    unsigned long long offset;
+    unsigned long long size;
+    int                advice;
+};
+typedef struct MapView MapView;
+
+////////////////////////////////////////////////////////////////////////////////
+// api
+////////////////////////////////////////////////////////////////////////////////
+int        mapOpen(MapContext* ctx, const char* path, unsigned long long size, unsigned long long window);
+int        mapResize(MapContext* ctx, unsigned long long size);
+int        mapRead(MapContext* ctx, MapView* view, unsigned long long pos, void* buffer, unsigned long long size);
+int        mapWrite(MapContext* ctx, MapView* view, unsigned long long pos, const void* buffer, unsigned long long size);
+int        mapRelease(MapContext* ctx, MapView* view);
+int        mapClose(MapContext* ctx);
+
+////////////////////////////////////////////////////////////////////////////////
+// anonymous memory, address space is reserved up front and only backed
+// by pages once committed and touched
+////////////////////////////////////////////////////////////////////////////////
+void*              mapReserve(unsigned long long size);
+int                mapCommit(void* base, unsigned long long offset, unsigned long long size);
+int                mapUnreserve(void* base, unsigned long long size);
+
+////////////////////////////////////////////////////////////////////////////////
+// process / system memory in bytes
+////////////////////////////////////////////////////////////////////////////////
+unsigned long long mapMemoryAvailable();
+unsigned long long mapPeakResident();
+
+#endif
+////////////////////////////////////////////////////////////////////////////////
+//
+//
+//
+//
+////////////////////////////////////////////////////////////////////////////////
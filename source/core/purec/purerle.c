@@ -0,0 +1,85 @@
+////////////////////////////////////////////////////////////////////////////////
+//    ScopeFun Oscilloscope ( http://www.scopefun.com )
+//    Copyright (C) 2016 - 2019 David Košenina
+//
+//    This file is part of ScopeFun Oscilloscope.
+//
+//    ScopeFun Oscilloscope is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    ScopeFun Oscilloscope is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with this ScopeFun Oscilloscope.  If not, see <http://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////
+#include<core/purec/purerle.h>
+
+#include<string.h>
+
+/*--------------------------------------------------------------------
+   control byte above 128 is followed by (control - 128) literal bytes,
+   otherwise the next byte is repeated control times. Runs that go past
+   the end of the input or output are cut short. With a null dest only
+   the decoded size is counted.
+--------------------------------------------------------------------*/
+unsigned long long rleDecode(unsigned char* dest, unsigned long long destSize, const unsigned char* src, unsigned int srcSize)
+{
+    unsigned long long written = 0;
+    unsigned int       i = 0;
+    while(i < srcSize && written < destSize)
+    {
+        unsigned int control = src[i++];
+        if(control > 128)
+        {
+            // literal
+            unsigned long long count = control - 128;
+            if(count > srcSize - i)
+            {
+                count = srcSize - i;
+            }
+            if(count > destSize - written)
+            {
+                count = destSize - written;
+            }
+            if(dest)
+            {
+                memcpy(dest + written, src + i, (size_t)count);
+            }
+            written += count;
+            i += control - 128;
+        }
+        else
+        {
+            // run
+            if(i >= srcSize)
+            {
+                break;
+            }
+            unsigned long long count = control;
+            if(count > destSize - written)
+            {
+                count = destSize - written;
+            }
+            if(dest)
+            {
+                memset(dest + written, src[i], (size_t)count);
+            }
+            written += count;
+            i++;
+        }
+    }
+    return written;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//
+//
+//
+////////////////////////////////////////////////////////////////////////////////
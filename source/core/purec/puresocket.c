@@ -233,6 +233,22 @@ int socketSend(SocketContext* ctx, char* buf, int len, int flags, int* transfere
     return PURESOCKET_SUCCESS;
 }
 
+int socketWait(SocketContext* ctx, int timeout)
+{
+    fd_set read;
+    FD_ZERO(&read);
+    FD_SET(ctx->socket, &read);
+    struct timeval tv;
+    tv.tv_sec  = timeout / 1000;
+    tv.tv_usec = (timeout % 1000) * 1000;
+    int ret = select((int)ctx->socket + 1, &read, 0, 0, &tv);
+    if(ret > 0)
+    {
+        return PURESOCKET_SUCCESS;
+    }
+    return PURESOCKET_FAILURE;
+}
+
 int socketClose(SocketContext* ctx)
 {
     #if defined(PLATFORM_WIN) || defined(PLATFORM_MINGW)
@@ -56,6 +56,7 @@ int        socketAccept(SocketContext* ctx, SocketContext* client);
 int        socketConnect(SocketContext* ctx, const char* serverip, int port);
 int        socketRecv(SocketContext* ctx, char* buf, int len, int flags, int* transfered);
 int        socketSend(SocketContext* ctx, char* buf, int len, int flags, int* transfered);
+int        socketWait(SocketContext* ctx, int timeout);
 int        socketClose(SocketContext* ctx);
 int        socketShutDown(SocketContext* ctx);
 int        socketExit();
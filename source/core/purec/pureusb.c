@@ -541,6 +541,10 @@ void usbFxxInit(UsbContext* ctx)
 int usbFxxTransferDataIn(UsbContext* ctx, int endPoint, char* dest, int size, int swapBytes, int timeout, int* transfered)
 {
     int ret = 0;
+    if(ctx->stream.active && ctx->stream.endPoint == endPoint)
+    {
+        return usbFxxStreamRead(ctx, dest, size, swapBytes, timeout, transfered);
+    }
     if(usbFxxIsConnected(ctx))
     {
         *transfered = 0;
@@ -755,6 +759,8 @@ void usbFxxClose(UsbContext* ctx)
     {
         return;
     }
+    // stream
+    usbFxxStreamStop(ctx);
     // release
     usbFxxReleaseInterface(ctx, 0);
     // close
@@ -801,6 +807,272 @@ void usbFxxExit(UsbContext* ctx)
 }
 
 
+////////////////////////////////////////////////////////////////////////////////
+//
+// stream
+//
+////////////////////////////////////////////////////////////////////////////////
+
+int usbStreamIndex(UsbContext* ctx, struct libusb_transfer* transfer)
+{
+    for(int i = 0; i < ctx->stream.count; i++)
+    {
+        if(ctx->stream.transfer[i] == transfer)
+        {
+            return i;
+        }
+    }
+    return -1;
+}
+
+int usbStreamSubmit(UsbContext* ctx, int index)
+{
+    struct libusb_transfer* transfer = (struct libusb_transfer*)ctx->stream.transfer[index];
+    if(libusb_submit_transfer(transfer) != 0)
+    {
+        ctx->stream.dropped++;
+        return PUREUSB_FAILURE;
+    }
+    ctx->stream.inFlight++;
+    return PUREUSB_SUCCESS;
+}
+
+void LIBUSB_CALL usbStreamTransferCallback(struct libusb_transfer* transfer)
+{
+    UsbContext* ctx = (UsbContext*)transfer->user_data;
+    int       index = usbStreamIndex(ctx, transfer);
+    ctx->stream.inFlight--;
+    if(index < 0)
+    {
+        return;
+    }
+    // stopping, buffer is released by usbFxxStreamStop
+    if(transfer->status == LIBUSB_TRANSFER_CANCELLED || !ctx->stream.active)
+    {
+        return;
+    }
+    if(transfer->status == LIBUSB_TRANSFER_NO_DEVICE)
+    {
+        ctx->stream.dropped++;
+        return;
+    }
+    // timed out transfers can still carry a partial buffer
+    int valid = transfer->status == LIBUSB_TRANSFER_COMPLETED || transfer->status == LIBUSB_TRANSFER_TIMED_OUT;
+    if(!valid)
+    {
+        ctx->stream.dropped++;
+    }
+    if(!valid || transfer->actual_length <= 0)
+    {
+        usbStreamSubmit(ctx, index);
+        return;
+    }
+    ctx->stream.completed++;
+    ctx->stream.length[index] = transfer->actual_length;
+    // callback consumes the buffer right away
+    if(ctx->stream.callback)
+    {
+        ctx->stream.callback(ctx->stream.user, ctx->stream.buffer[index], transfer->actual_length);
+        usbStreamSubmit(ctx, index);
+        return;
+    }
+    // queue keeps the buffer until usbFxxStreamRead has consumed it
+    int last = (ctx->stream.readyStart + ctx->stream.readyCount) % ctx->stream.count;
+    ctx->stream.ready[last] = index;
+    ctx->stream.readyCount++;
+}
+
+int usbFxxStreamStart(UsbContext* ctx, int endPoint, int count, int size)
+{
+    if(!usbFxxIsConnected(ctx) || ctx->stream.active)
+    {
+        return PUREUSB_FAILURE;
+    }
+    if(count < 1 || count > USB_STREAM_MAX_TRANSFER || size <= 0)
+    {
+        return PUREUSB_FAILURE;
+    }
+    // a stop that timed out still owns transfers in flight, their memory can not be reused before they are back
+    if(ctx->stream.count > 0 && usbFxxStreamStop(ctx) != PUREUSB_SUCCESS)
+    {
+        return PUREUSB_FAILURE;
+    }
+    #if defined(MAC)
+    if(size > 64 * 1024)
+    {
+        size = 64 * 1024;
+    }
+    #endif
+    usbStreamCallback callback = ctx->stream.callback;
+    void*             user     = ctx->stream.user;
+    cMemSet((char*)&ctx->stream, 0, sizeof(UsbStream));
+    ctx->stream.callback = callback;
+    ctx->stream.user     = user;
+    ctx->stream.endPoint = endPoint;
+    ctx->stream.count    = count;
+    ctx->stream.size     = size;
+    for(int i = 0; i < count; i++)
+    {
+        struct libusb_transfer* transfer = libusb_alloc_transfer(0);
+        char*                   buffer   = (char*)cMalloc(size);
+        if(!transfer || !buffer)
+        {
+            if(transfer)
+            {
+                libusb_free_transfer(transfer);
+            }
+            cFree(buffer);
+            ctx->stream.count = i;
+            usbFxxStreamStop(ctx);
+            return PUREUSB_FAILURE;
+        }
+        libusb_fill_bulk_transfer(transfer, (libusb_device_handle*)ctx->device, endPoint | LIBUSB_ENDPOINT_IN, (unsigned char*)buffer, size, usbStreamTransferCallback, ctx, 0);
+        ctx->stream.transfer[i] = transfer;
+        ctx->stream.buffer[i]   = buffer;
+    }
+    ctx->stream.active = 1;
+    for(int i = 0; i < count; i++)
+    {
+        usbStreamSubmit(ctx, i);
+    }
+    if(ctx->stream.inFlight == 0)
+    {
+        usbFxxStreamStop(ctx);
+        return PUREUSB_FAILURE;
+    }
+    return PUREUSB_SUCCESS;
+}
+
+int usbFxxStreamCallback(UsbContext* ctx, usbStreamCallback callback, void* user)
+{
+    if(ctx->stream.active)
+    {
+        return PUREUSB_FAILURE;
+    }
+    ctx->stream.callback = callback;
+    ctx->stream.user     = user;
+    return PUREUSB_SUCCESS;
+}
+
+int usbFxxStreamUpdate(UsbContext* ctx, int timeOut)
+{
+    if(!ctx->stream.active)
+    {
+        return PUREUSB_FAILURE;
+    }
+    struct timeval tv;
+    tv.tv_sec  = timeOut / 1000;
+    tv.tv_usec = (timeOut % 1000) * 1000;
+    if(libusb_handle_events_timeout_completed(0, &tv, 0) != 0)
+    {
+        return PUREUSB_FAILURE;
+    }
+    return PUREUSB_SUCCESS;
+}
+
+int usbFxxStreamRead(UsbContext* ctx, char* dest, int size, int swapBytes, int timeOut, int* transfered)
+{
+    *transfered = 0;
+    if(!ctx->stream.active || ctx->stream.callback)
+    {
+        return PUREUSB_FAILURE;
+    }
+    // wait for at least one completed buffer
+    if(ctx->stream.readyCount == 0)
+    {
+        usbFxxStreamUpdate(ctx, timeOut);
+    }
+    // drain without blocking anything that is already on the host
+    usbFxxStreamUpdate(ctx, 0);
+    char* write = dest;
+    while(*transfered < size && ctx->stream.readyCount > 0)
+    {
+        int   index  = ctx->stream.ready[ctx->stream.readyStart];
+        int   left   = ctx->stream.length[index] - ctx->stream.readOffset;
+        int   bytes  = left < (size - *transfered) ? left : (size - *transfered);
+        cMemCpy(write, ctx->stream.buffer[index] + ctx->stream.readOffset, bytes);
+        write                  += bytes;
+        *transfered            += bytes;
+        ctx->stream.readOffset += bytes;
+        if(ctx->stream.readOffset == ctx->stream.length[index])
+        {
+            ctx->stream.readOffset = 0;
+            ctx->stream.readyStart = (ctx->stream.readyStart + 1) % ctx->stream.count;
+            ctx->stream.readyCount--;
+            usbStreamSubmit(ctx, index);
+        }
+    }
+    if(swapBytes)
+    {
+        int                count = (*transfered) / 4;
+        unsigned int* swapBuffer = (unsigned int*)dest;
+        for(int i = 0; i < count; i++)
+        {
+            swapBuffer[i] = cSwap32(&swapBuffer[i]);
+        }
+    }
+    if(ctx->stream.inFlight == 0 && ctx->stream.readyCount == 0)
+    {
+        return PUREUSB_FAILURE;
+    }
+    return PUREUSB_SUCCESS;
+}
+
+int usbFxxStreamStatus(UsbContext* ctx, int* depth, int* dropped)
+{
+    *depth   = ctx->stream.active ? ctx->stream.readyCount : 0;
+    *dropped = (int)ctx->stream.dropped;
+    return PUREUSB_SUCCESS;
+}
+
+int usbFxxStreamStop(UsbContext* ctx)
+{
+    if(ctx->stream.count == 0)
+    {
+        return PUREUSB_SUCCESS;
+    }
+    ctx->stream.active = 0;
+    // cancel and wait for every transfer to come back
+    for(int i = 0; i < ctx->stream.count; i++)
+    {
+        if(ctx->stream.transfer[i])
+        {
+            libusb_cancel_transfer((struct libusb_transfer*)ctx->stream.transfer[i]);
+        }
+    }
+    int retry = 100;
+    while(ctx->stream.inFlight > 0 && retry > 0)
+    {
+        struct timeval tv = { 0, 10000 };
+        libusb_handle_events_timeout_completed(0, &tv, 0);
+        retry--;
+    }
+    // unconsumed buffers are lost
+    ctx->stream.dropped   += ctx->stream.readyCount;
+    ctx->stream.readyCount = 0;
+    if(ctx->stream.inFlight > 0)
+    {
+        return PUREUSB_FAILURE;
+    }
+    for(int i = 0; i < ctx->stream.count; i++)
+    {
+        if(ctx->stream.transfer[i])
+        {
+            libusb_free_transfer((struct libusb_transfer*)ctx->stream.transfer[i]);
+        }
+        cFree(ctx->stream.buffer[i]);
+        ctx->stream.transfer[i] = 0;
+        ctx->stream.buffer[i]   = 0;
+    }
+    ctx->stream.count      = 0;
+    ctx->stream.readyStart = 0;
+    ctx->stream.readyCount = 0;
+    ctx->stream.readOffset = 0;
+    ctx->stream.inFlight   = 0;
+    return PUREUSB_SUCCESS;
+}
+
+
 ////////////////////////////////////////////////////////////////////////////////
 //
 // test
@@ -71,6 +71,32 @@ typedef struct UsbGuid UsbGuid;
 #define USB_CALLBACK_DEVICE_LEFT   0x2
 typedef int(*usbCallback)(char* ctx, int flag);
 
+////////////////////////////////////////////////////////////////////////////////
+// UsbStream
+////////////////////////////////////////////////////////////////////////////////
+#define USB_STREAM_MAX_TRANSFER 32
+typedef int(*usbStreamCallback)(void* user, char* data, int size);
+struct UsbStream
+{
+    int                   active;
+    int                   endPoint;
+    int                   count;
+    int                   size;
+    void*                 transfer[USB_STREAM_MAX_TRANSFER];
+    char*                 buffer[USB_STREAM_MAX_TRANSFER];
+    int                   length[USB_STREAM_MAX_TRANSFER];
+    int                   ready[USB_STREAM_MAX_TRANSFER];
+    int                   readyStart;
+    int                   readyCount;
+    int                   readOffset;
+    int                   inFlight;
+    unsigned int          completed;
+    unsigned int          dropped;
+    usbStreamCallback     callback;
+    void*                 user;
+};
+typedef struct UsbStream UsbStream;
+
 ////////////////////////////////////////////////////////////////////////////////
 // UsbContext
 ////////////////////////////////////////////////////////////////////////////////
@@ -88,6 +114,7 @@ struct UsbContext
     char                  serialBuffer[1024];
     int                   serialBufferSize;
     usbCallback           callback;
+    UsbStream             stream;
 };
 typedef struct UsbContext UsbContext;
 
@@ -135,6 +162,16 @@ void usbFxxReleaseInterface(UsbContext* ctx, int i);
 void usbFxxUpdate(UsbContext* ctx);
 void usbFxxExit(UsbContext* ctx);
 
+////////////////////////////////////////////////////////////////////////////////
+// Stream
+////////////////////////////////////////////////////////////////////////////////
+int  usbFxxStreamStart(UsbContext* ctx, int endPoint, int count, int size);
+int  usbFxxStreamCallback(UsbContext* ctx, usbStreamCallback callback, void* user);
+int  usbFxxStreamRead(UsbContext* ctx, char* dest, int size, int swapBytes, int timeOut, int* transfered);
+int  usbFxxStreamUpdate(UsbContext* ctx, int timeOut);
+int  usbFxxStreamStatus(UsbContext* ctx, int* depth, int* dropped);
+int  usbFxxStreamStop(UsbContext* ctx);
+
 ////////////////////////////////////////////////////////////////////////////////
 // test
 ////////////////////////////////////////////////////////////////////////////////
@@ -35,11 +35,21 @@ OsciloskopStorage::OsciloskopStorage(wxWindow* parent)
 void OsciloskopStorage::m_choiceStorageOnChoice(wxCommandEvent& event)
 {
     // TODO: Implement m_choiceStorageOnChoice
-    if(m_choiceStorage->GetSelection() == 0)
+    pOsciloscope->window.storage.type = (MemoryType)m_choiceStorage->GetSelection();
+    if(pOsciloscope->window.storage.type == mtRAM)
     {
         m_textCtrlStorage->Disable();
         pOsciloscope->captureBuffer->setMemory();
     }
+    else if(pOsciloscope->window.storage.type == mtMapped)
+    {
+        wxString tempDir = wxStandardPaths::Get().GetTempDir();
+        FORMAT_BUFFER();
+        FORMAT("%s/memory.map", tempDir.data().AsChar());
+        pOsciloscope->captureBuffer->historyMapped.init(formatBuffer, 2048 * MEGABYTE, pOsciloscope->window.storage.getPacketSize());
+        m_textCtrlStorage->Enable();
+        pOsciloscope->captureBuffer->setMapped();
+    }
     else
     {
         wxString tempDir = wxStandardPaths::Get().GetTempDir();
@@ -4453,7 +4453,7 @@ Storage::Storage( wxWindow* parent, wxWindowID id, const wxString& title, const
 	m_staticText112->Wrap( -1 );
 	bSizer144->Add( m_staticText112, 1, wxALL|wxALIGN_CENTER_VERTICAL, 5 );
 
-	wxString m_choiceStorageChoices[] = { _("Memory"), _("Disk") };
+	wxString m_choiceStorageChoices[] = { _("Memory"), _("Disk"), _("Mapped Disk") };
 	int m_choiceStorageNChoices = sizeof( m_choiceStorageChoices ) / sizeof( wxString );
 	m_choiceStorage = new wxChoice( this, wxID_ANY, wxDefaultPosition, wxDefaultSize, m_choiceStorageNChoices, m_choiceStorageChoices, 0 );
 	m_choiceStorage->SetSelection( 0 );
@@ -32,6 +32,7 @@ extern "C" {
 // osciloscope
 #include<osciloscope/window/tool.h>
 #include<osciloscope/osciloscope/oscsignal.h>
+#include<osciloscope/osciloscope/oscdecode.h>
 #include<osciloscope/osciloscope/oscfile.h>
 #include<osciloscope/osciloscope/oscsettings.h>
 #include<osciloscope/osciloscope/oscfft.h>
@@ -0,0 +1,408 @@
+////////////////////////////////////////////////////////////////////////////////
+//    ScopeFun Oscilloscope ( http://www.scopefun.com )
+//    Copyright (C) 2016 - 2019 David Košenina
+//
+//    This file is part of ScopeFun Oscilloscope.
+//
+//    ScopeFun Oscilloscope is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    ScopeFun Oscilloscope is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with this ScopeFun Oscilloscope.  If not, see <http://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////
+#include<osciloscope/osciloscope.h>
+
+#if defined(__i386__) || defined(__x86_64__) || defined(_M_IX86) || defined(_M_X64)
+    #define DECODE_X86
+    #include <emmintrin.h>
+    #include <immintrin.h>
+    #if defined(__GNUC__) || defined(__clang__)
+        #define DECODE_TARGET_SSE2 __attribute__((target("sse2")))
+        #define DECODE_TARGET_AVX2 __attribute__((target("avx2")))
+    #else
+        #define DECODE_TARGET_SSE2
+        #define DECODE_TARGET_AVX2
+    #endif
+#endif
+
+typedef void (*DecodeSamples)(byte* data, uint first, uint step, uint count, ishort* analog0, ishort* analog1, ushort* digital, byte* attr);
+
+ishort leadBitShift(ushort value);
+
+////////////////////////////////////////////////////////////////////////////////
+// sample
+////////////////////////////////////////////////////////////////////////////////
+inline void decodeSample(byte* data, uint version, uint i, ishort& ch0, ishort& ch1, ushort& dig, byte& attribute)
+{
+    attribute = 0;
+    if(version == 1)
+    {
+        byte*  sample = data + i * 6;
+        ushort raw0   = *(ushort*)(sample + 0);
+        ushort raw1   = *(ushort*)(sample + 2);
+        dig = *(ushort*)(sample + 4);
+        if(raw0 & 0x8000)
+        {
+            attribute |= FRAME_ATTRIBUTE_HIDE_SIGNAL;
+        }
+        if(raw0 & 0x4000)
+        {
+            attribute |= FRAME_ATTRIBUTE_TRIGGERED_LED;
+        }
+        if(raw0 & 0x2000)
+        {
+            attribute |= FRAME_ATTRIBUTE_ROLL_DISPLAY;
+        }
+        ch0 = leadBitShift(raw0 & 0x000003FF);
+        ch1 = leadBitShift(raw1 & 0x000003FF);
+    }
+    else
+    {
+        // 32 bit big endian word: ch0[31:22] ch1[21:12] digital[11:0]
+        byte* sample = data + i * 4;
+        uint  word   = (uint(sample[0]) << 24) | (uint(sample[1]) << 16) | (uint(sample[2]) << 8) | uint(sample[3]);
+        ch0 = ishort(int(word) >> 22);
+        ch1 = ishort(int(word << 10) >> 22);
+        dig = ushort(word & 0xFFF);
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// scalar
+////////////////////////////////////////////////////////////////////////////////
+void decodeScalar1(byte* data, uint first, uint step, uint count, ishort* analog0, ishort* analog1, ushort* digital, byte* attr)
+{
+    for(uint k = 0; k < count; k++)
+    {
+        decodeSample(data, 1, first + k * step, analog0[k], analog1[k], digital[k], attr[k]);
+    }
+}
+
+void decodeScalar2(byte* data, uint first, uint step, uint count, ishort* analog0, ishort* analog1, ushort* digital, byte* attr)
+{
+    for(uint k = 0; k < count; k++)
+    {
+        decodeSample(data, 2, first + k * step, analog0[k], analog1[k], digital[k], attr[k]);
+    }
+}
+
+#if defined(DECODE_X86)
+
+////////////////////////////////////////////////////////////////////////////////
+// sse2
+////////////////////////////////////////////////////////////////////////////////
+DECODE_TARGET_SSE2 inline __m128i decodeSwapSse2(__m128i x)
+{
+    x = _mm_or_si128(_mm_slli_epi16(x, 8), _mm_srli_epi16(x, 8));
+    x = _mm_shufflelo_epi16(x, _MM_SHUFFLE(2, 3, 0, 1));
+    return _mm_shufflehi_epi16(x, _MM_SHUFFLE(2, 3, 0, 1));
+}
+
+DECODE_TARGET_SSE2 inline __m128i decodeLoadSse2(byte* data, uint i, uint step)
+{
+    if(step == 1)
+    {
+        return _mm_loadu_si128((__m128i*)(data + i * 4));
+    }
+    return _mm_set_epi32(*(int*)(data + (i + 3 * step) * 4), *(int*)(data + (i + 2 * step) * 4), *(int*)(data + (i + step) * 4), *(int*)(data + i * 4));
+}
+
+DECODE_TARGET_SSE2 void decodeSse2(byte* data, uint first, uint step, uint count, ishort* analog0, ishort* analog1, ushort* digital, byte* attr)
+{
+    const __m128i mask = _mm_set1_epi32(0xFFF);
+    uint k = 0;
+    for(; k + 8 <= count; k += 8)
+    {
+        uint   i  = first + k * step;
+        __m128i w0 = decodeSwapSse2(decodeLoadSse2(data, i, step));
+        __m128i w1 = decodeSwapSse2(decodeLoadSse2(data, i + 4 * step, step));
+        __m128i c0 = _mm_packs_epi32(_mm_srai_epi32(w0, 22), _mm_srai_epi32(w1, 22));
+        __m128i c1 = _mm_packs_epi32(_mm_srai_epi32(_mm_slli_epi32(w0, 10), 22), _mm_srai_epi32(_mm_slli_epi32(w1, 10), 22));
+        __m128i d  = _mm_packs_epi32(_mm_and_si128(w0, mask), _mm_and_si128(w1, mask));
+        _mm_storeu_si128((__m128i*)(analog0 + k), c0);
+        _mm_storeu_si128((__m128i*)(analog1 + k), c1);
+        _mm_storeu_si128((__m128i*)(digital + k), d);
+    }
+    SDL_memset(attr, 0, k);
+    decodeScalar2(data, first + k * step, step, count - k, analog0 + k, analog1 + k, digital + k, attr + k);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// avx2
+////////////////////////////////////////////////////////////////////////////////
+DECODE_TARGET_AVX2 inline __m256i decodeLoadAvx2(byte* data, uint i, uint step, __m256i index)
+{
+    if(step == 1)
+    {
+        return _mm256_loadu_si256((__m256i*)(data + i * 4));
+    }
+    return _mm256_i32gather_epi32((int*)(data + i * 4), index, 4);
+}
+
+DECODE_TARGET_AVX2 void decodeAvx2(byte* data, uint first, uint step, uint count, ishort* analog0, ishort* analog1, ushort* digital, byte* attr)
+{
+    const __m256i mask  = _mm256_set1_epi32(0xFFF);
+    const __m256i swap  = _mm256_setr_epi8(3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12,
+                                           3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12);
+    const __m256i index = _mm256_mullo_epi32(_mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7), _mm256_set1_epi32(int(step)));
+    uint k = 0;
+    for(; k + 16 <= count; k += 16)
+    {
+        uint    i  = first + k * step;
+        __m256i w0 = _mm256_shuffle_epi8(decodeLoadAvx2(data, i, step, index), swap);
+        __m256i w1 = _mm256_shuffle_epi8(decodeLoadAvx2(data, i + 8 * step, step, index), swap);
+        // packs works per 128 bit lane, permute restores sample order
+        __m256i c0 = _mm256_packs_epi32(_mm256_srai_epi32(w0, 22), _mm256_srai_epi32(w1, 22));
+        __m256i c1 = _mm256_packs_epi32(_mm256_srai_epi32(_mm256_slli_epi32(w0, 10), 22), _mm256_srai_epi32(_mm256_slli_epi32(w1, 10), 22));
+        __m256i d  = _mm256_packs_epi32(_mm256_and_si256(w0, mask), _mm256_and_si256(w1, mask));
+        _mm256_storeu_si256((__m256i*)(analog0 + k), _mm256_permute4x64_epi64(c0, _MM_SHUFFLE(3, 1, 2, 0)));
+        _mm256_storeu_si256((__m256i*)(analog1 + k), _mm256_permute4x64_epi64(c1, _MM_SHUFFLE(3, 1, 2, 0)));
+        _mm256_storeu_si256((__m256i*)(digital + k), _mm256_permute4x64_epi64(d,  _MM_SHUFFLE(3, 1, 2, 0)));
+    }
+    SDL_memset(attr, 0, k);
+    decodeScalar2(data, first + k * step, step, count - k, analog0 + k, analog1 + k, digital + k, attr + k);
+}
+
+#endif
+
+////////////////////////////////////////////////////////////////////////////////
+// kernel
+////////////////////////////////////////////////////////////////////////////////
+static DecodeKernel decodeSelected = DECODE_KERNEL_AUTO;
+
+const char* decodeKernelName(DecodeKernel kernel)
+{
+    switch(kernel)
+    {
+        case DECODE_KERNEL_SCALAR:
+            return "scalar";
+        case DECODE_KERNEL_SSE2:
+            return "sse2";
+        case DECODE_KERNEL_AVX2:
+            return "avx2";
+        default:
+            return "auto";
+    };
+}
+
+bool decodeKernelAvailable(DecodeKernel kernel)
+{
+    #if defined(DECODE_X86)
+    if(kernel == DECODE_KERNEL_SSE2)
+    {
+        return SDL_HasSSE2() == SDL_TRUE;
+    }
+    if(kernel == DECODE_KERNEL_AVX2)
+    {
+        return SDL_HasAVX2() == SDL_TRUE;
+    }
+    #endif
+    return kernel == DECODE_KERNEL_SCALAR;
+}
+
+DecodeKernel decodeKernel()
+{
+    if(decodeSelected == DECODE_KERNEL_AUTO)
+    {
+        decodeSelected = DECODE_KERNEL_SCALAR;
+        if(decodeKernelAvailable(DECODE_KERNEL_SSE2))
+        {
+            decodeSelected = DECODE_KERNEL_SSE2;
+        }
+        if(decodeKernelAvailable(DECODE_KERNEL_AVX2))
+        {
+            decodeSelected = DECODE_KERNEL_AVX2;
+        }
+    }
+    return decodeSelected;
+}
+
+void decodeSetKernel(DecodeKernel kernel)
+{
+    decodeSelected = kernel;
+}
+
+DecodeSamples decodeSamples(DecodeKernel kernel, uint version)
+{
+    if(version == 1)
+    {
+        return decodeScalar1;
+    }
+    #if defined(DECODE_X86)
+    if(kernel == DECODE_KERNEL_SSE2)
+    {
+        return decodeSse2;
+    }
+    if(kernel == DECODE_KERNEL_AVX2)
+    {
+        return decodeAvx2;
+    }
+    #endif
+    return decodeScalar2;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// DisplayDecode
+////////////////////////////////////////////////////////////////////////////////
+DisplayDecode::DisplayDecode()
+{
+    SDL_memset(this, 0, sizeof(DisplayDecode));
+    step = 1;
+}
+
+uint decodeDisplay(DisplayDecode& decode, DecodeKernel kernel)
+{
+    if(kernel == DECODE_KERNEL_AUTO)
+    {
+        kernel = decodeKernel();
+    }
+    uint step  = max<uint>(decode.step, 1);
+    uint first = ((decode.start + step - 1) / step) * step;
+    if(first >= decode.end || decode.capacity == 0)
+    {
+        return 0;
+    }
+    // first display sample holds the peak of everything before it
+    ishort minCh0 = 512;
+    ishort minCh1 = 512;
+    ishort maxCh0 = -512;
+    ishort maxCh1 = -512;
+    ushort digital = 0;
+    byte   attribute = 0;
+    for(uint i = decode.start; i <= first; i++)
+    {
+        ishort ch0 = 0;
+        ishort ch1 = 0;
+        ushort dig = 0;
+        byte   attr = 0;
+        decodeSample(decode.data, decode.version, i, ch0, ch1, dig, attr);
+        minCh0 = min(minCh0, ch0);
+        maxCh0 = max(maxCh0, ch0);
+        minCh1 = min(minCh1, ch1);
+        maxCh1 = max(maxCh1, ch1);
+        digital   |= dig;
+        attribute |= attr;
+    }
+    decode.analog0[0] = (-minCh0 > maxCh0) ? minCh0 : maxCh0;
+    decode.analog1[0] = (-minCh1 > maxCh1) ? minCh1 : maxCh1;
+    decode.digital[0] = digital;
+    decode.attr[0]    = attribute;
+    // after that every step-th sample is displayed as is
+    uint count = min<uint>((decode.end - first - 1) / step, decode.capacity - 1);
+    DecodeSamples samples = decodeSamples(kernel, decode.version);
+    samples(decode.data, first + step, step, count, decode.analog0 + 1, decode.analog1 + 1, decode.digital + 1, decode.attr + 1);
+    return count + 1;
+}
+
+uint decodeDisplayFrame(OsciloscopeFrame& frame, byte* data, uint version, uint start, uint end, uint step)
+{
+    frame.clear();
+    DisplayDecode decode;
+    decode.data     = data;
+    decode.version  = version;
+    decode.start    = start;
+    decode.end      = end;
+    decode.step     = step;
+    decode.analog0  = &frame.analog[0][0];
+    decode.analog1  = &frame.analog[1][0];
+    decode.digital  = &frame.digital[0];
+    decode.attr     = &frame.attr[0];
+    decode.capacity = NUM_SAMPLES;
+    uint count = decodeDisplay(decode);
+    frame.analog[0].setCount(count);
+    frame.analog[1].setCount(count);
+    frame.digital.setCount(count);
+    frame.attr.setCount(count);
+    return count;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// verify
+////////////////////////////////////////////////////////////////////////////////
+int decodeVerify()
+{
+    const uint samples = 4096;
+    byte* data = (byte*)SDL_malloc(samples * 6);
+    uint  seed = 0x5C0FF00D;
+    for(uint i = 0; i < samples * 6; i++)
+    {
+        seed = seed * 1664525 + 1013904223;
+        data[i] = byte(seed >> 24);
+    }
+    const uint outSize = samples + 1;
+    ishort* ref0 = (ishort*)SDL_malloc(outSize * sizeof(ishort) * 4);
+    ishort* ref1 = ref0 + outSize;
+    ishort* out0 = ref1 + outSize;
+    ishort* out1 = out0 + outSize;
+    ushort* refD = (ushort*)SDL_malloc(outSize * sizeof(ushort) * 2);
+    ushort* outD = refD + outSize;
+    byte*   refA = (byte*)SDL_malloc(outSize * 2);
+    byte*   outA = refA + outSize;
+    const uint steps[]  = { 1, 2, 3, 7, 25, 100 };
+    const uint starts[] = { 0, 1, 5, 33 };
+    int mismatch = 0;
+    for(uint version = 1; version <= 2; version++)
+    {
+        for(uint s = 0; s < sizeof(steps) / sizeof(uint); s++)
+        {
+            for(uint t = 0; t < sizeof(starts) / sizeof(uint); t++)
+            {
+                DisplayDecode decode;
+                decode.data     = data;
+                decode.version  = version;
+                decode.start    = starts[t];
+                decode.end      = samples - starts[t];
+                decode.step     = steps[s];
+                decode.capacity = outSize;
+                decode.analog0  = ref0;
+                decode.analog1  = ref1;
+                decode.digital  = refD;
+                decode.attr     = refA;
+                uint refCount = decodeDisplay(decode, DECODE_KERNEL_SCALAR);
+                for(int k = DECODE_KERNEL_SSE2; k < DECODE_KERNEL_LAST; k++)
+                {
+                    if(!decodeKernelAvailable((DecodeKernel)k))
+                    {
+                        continue;
+                    }
+                    decode.analog0 = out0;
+                    decode.analog1 = out1;
+                    decode.digital = outD;
+                    decode.attr    = outA;
+                    uint count = decodeDisplay(decode, (DecodeKernel)k);
+                    if(count != refCount ||
+                       SDL_memcmp(ref0, out0, count * sizeof(ishort)) ||
+                       SDL_memcmp(ref1, out1, count * sizeof(ishort)) ||
+                       SDL_memcmp(refD, outD, count * sizeof(ushort)) ||
+                       SDL_memcmp(refA, outA, count))
+                    {
+                        mismatch++;
+                    }
+                    decode.analog0 = ref0;
+                    decode.analog1 = ref1;
+                    decode.digital = refD;
+                    decode.attr    = refA;
+                }
+            }
+        }
+    }
+    SDL_free(refA);
+    SDL_free(refD);
+    SDL_free(ref0);
+    SDL_free(data);
+    return mismatch;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//
+//
+////////////////////////////////////////////////////////////////////////////////
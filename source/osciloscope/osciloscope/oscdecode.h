@@ -0,0 +1,79 @@
+////////////////////////////////////////////////////////////////////////////////
+//    ScopeFun Oscilloscope ( http://www.scopefun.com )
+//    Copyright (C) 2016 - 2019 David Košenina
+//
+//    This file is part of ScopeFun Oscilloscope.
+//
+//    ScopeFun Oscilloscope is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    ScopeFun Oscilloscope is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with this ScopeFun Oscilloscope.  If not, see <http://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////
+#ifndef __OSC__DECODE__
+#define __OSC__DECODE__
+
+////////////////////////////////////////////////////////////////////////////////
+//
+// DecodeKernel
+//
+////////////////////////////////////////////////////////////////////////////////
+enum DecodeKernel
+{
+    DECODE_KERNEL_AUTO,
+    DECODE_KERNEL_SCALAR,
+    DECODE_KERNEL_SSE2,
+    DECODE_KERNEL_AVX2,
+    DECODE_KERNEL_LAST,
+};
+
+////////////////////////////////////////////////////////////////////////////////
+//
+// DisplayDecode
+//
+// Unpacks samples [start,end) of a captured frame and decimates them the same
+// way CaptureBuffer::display always did: samples up to the first multiple of
+// step are folded into one peak |min/max| value, after that every step-th
+// sample is taken as is. Output goes straight to the frame arrays.
+//
+////////////////////////////////////////////////////////////////////////////////
+class DisplayDecode
+{
+public:
+    byte*   data;
+    uint    version;
+    uint    start;
+    uint    end;
+    uint    step;
+public:
+    ishort* analog0;
+    ishort* analog1;
+    ushort* digital;
+    byte*   attr;
+    uint    capacity;
+public:
+    DisplayDecode();
+};
+
+uint         decodeDisplay(DisplayDecode& decode, DecodeKernel kernel = DECODE_KERNEL_AUTO);
+uint         decodeDisplayFrame(OsciloscopeFrame& frame, byte* data, uint version, uint start, uint end, uint step);
+DecodeKernel decodeKernel();
+void         decodeSetKernel(DecodeKernel kernel);
+bool         decodeKernelAvailable(DecodeKernel kernel);
+const char*  decodeKernelName(DecodeKernel kernel);
+int          decodeVerify();
+
+#endif
+////////////////////////////////////////////////////////////////////////////////
+//
+//
+//
+////////////////////////////////////////////////////////////////////////////////
@@ -45,12 +45,69 @@ void OsciloscopeThreadRenderer::dftCalculate(iint n, double* inRe, double* inIm,
     }
 }
 
+////////////////////////////////////////////////////////////////////////////////
+//
+// plans are kept per renderer thread, least recently used plan is replaced
+//
+////////////////////////////////////////////////////////////////////////////////
+FFTPlan* OsciloscopeThreadRenderer::fftPlan(uint n, bool real)
+{
+    if(n == 0 || n > NUM_FFT)
+    {
+        return 0;
+    }
+    if(real && (n % 2))
+    {
+        return 0;
+    }
+    fftPlanUse++;
+    FFTPlan* plan = 0;
+    for(int i = 0; i < fftPlans.getCount(); i++)
+    {
+        FFTPlan& cached = fftPlans[i];
+        if(cached.size == n && real == (cached.real != 0))
+        {
+            cached.used = fftPlanUse;
+            return &cached;
+        }
+        if(!plan || cached.used < plan->used)
+        {
+            plan = &cached;
+        }
+    }
+    if(fftPlans.getCount() < FFT_PLAN_CACHE)
+    {
+        plan = &fftPlans.add();
+    }
+    else
+    {
+        pMemory->free(plan->memory);
+        *plan = FFTPlan();
+    }
+    size_t size = 0;
+    if(real)
+    {
+        kiss_fftr_alloc(n, 0, 0, &size);
+        plan->memory = (byte*)pMemory->allocate(size);
+        plan->real   = kiss_fftr_alloc(n, 0, plan->memory, &size);
+    }
+    else
+    {
+        kiss_fft_alloc(n, 0, 0, &size);
+        plan->memory  = (byte*)pMemory->allocate(size);
+        plan->complex = kiss_fft_alloc(n, 0, plan->memory, &size);
+    }
+    plan->size = n;
+    plan->used = fftPlanUse;
+    return plan;
+}
+
 void OsciloscopeThreadRenderer::fftCalculate(uint threadId, uint backward, uint n, double* real, double* imag)
 {
-    if(n <= NUM_FFT)
+    FFTPlan* plan = fftPlan(n, false);
+    if(plan)
     {
-        size_t          size = (size_t)cfgSize;
-        kiss_fft_cfg     cfg = kiss_fft_alloc(n, 0, cfgMem, &size);
+        kiss_fft_cfg     cfg = plan->complex;
         kiss_fft_cpx* fftIn  = in;
         kiss_fft_cpx* fftOut = out;
         for(uint i = 0; i < n; i++)
@@ -72,6 +129,81 @@ void OsciloscopeThreadRenderer::fftCalculate(uint threadId, uint backward, uint
     }
 }
 
+////////////////////////////////////////////////////////////////////////////////
+//
+// fftSpectrum
+//
+////////////////////////////////////////////////////////////////////////////////
+double* OsciloscopeThreadRenderer::fftSpectrum(uint threadId, OsciloscopeThreadData& threadData, OsciloscopeFFT& fft, OsciloscopeFrame& frame, uint source, iint p)
+{
+    WndMain& wndMain = threadData.window;
+    if(source >= FFT_SOURCES || p <= 0 || p > NUM_FFT)
+    {
+        return 0;
+    }
+    ////////////////////////////////////////////////////////////////////////////////
+    // input, hashed so measure and render of the same frame share one transform
+    ////////////////////////////////////////////////////////////////////////////////
+    ularge hash = 14695981039346656037ULL;
+    if(source == 2)
+    {
+        functionSamples(wndMain, wndMain.function.Type, frame, 0, uint(p), 1.0, 0.0, 1.0, 0.0, fft.aRe);
+    }
+    for(iint i = 0; i < p; i++)
+    {
+        if(source != 2)
+        {
+            fft.aRe[i] = frame.getAnalog(source, i);
+        }
+        double value = fft.aRe[i];
+        ularge bits = 0;
+        SDL_memcpy(&bits, &value, sizeof(double));
+        hash = (hash ^ bits) * 1099511628211ULL;
+    }
+    double* spectrum = fft.aSpectrum[source];
+    if(fft.spectrumSize[source] == p && fft.spectrumHash[source] == hash)
+    {
+        return spectrum;
+    }
+    ////////////////////////////////////////////////////////////////////////////////
+    // real input needs only p/2+1 bins, odd sizes take the complex transform
+    ////////////////////////////////////////////////////////////////////////////////
+    FFTPlan* plan = fftPlan(uint(p), true);
+    if(plan)
+    {
+        for(iint i = 0; i < p; i++)
+        {
+            scalar[i] = (kiss_fft_scalar)fft.aRe[i];
+        }
+        kiss_fftr(plan->real, scalar, out);
+    }
+    else
+    {
+        plan = fftPlan(uint(p), false);
+        if(!plan)
+        {
+            return 0;
+        }
+        for(iint i = 0; i < p; i++)
+        {
+            in[i].r = (kiss_fft_scalar)fft.aRe[i];
+            in[i].i = 0;
+        }
+        kiss_fft(plan->complex, in, out);
+    }
+    iint   count = p / 2 + 1;
+    double scale = double(max<iint>(p / 2, 1));
+    for(iint i = 0; i < count; i++)
+    {
+        double re = out[i].r / scale;
+        double im = out[i].i / scale;
+        spectrum[i] = re * re + im * im;
+    }
+    fft.spectrumSize[source] = p;
+    fft.spectrumHash[source] = hash;
+    return spectrum;
+}
+
 void OsciloscopeThreadRenderer::fftAmplitude(iint points, iint n, double* gAmp, double* gRe, double* gIm)
 {
     for(iint x = 0; x < n; x++)
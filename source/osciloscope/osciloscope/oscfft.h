@@ -22,6 +22,33 @@
 #define __OSC__FFT__
 
 #include<../lib/kiss_fft130/kiss_fft.h>
+#include<../lib/kiss_fft130/tools/kiss_fftr.h>
+
+#define FFT_PLAN_CACHE 4
+
+////////////////////////////////////////////////////////////////////////////////
+//
+// FFTPlan
+//
+////////////////////////////////////////////////////////////////////////////////
+class FFTPlan
+{
+public:
+    uint          size;
+    ularge        used;
+    byte*         memory;
+    kiss_fftr_cfg real;
+    kiss_fft_cfg  complex;
+public:
+    FFTPlan()
+    {
+        size    = 0;
+        used    = 0;
+        memory  = 0;
+        real    = 0;
+        complex = 0;
+    }
+};
 
 #endif
 ////////////////////////////////////////////////////////////////////////////////
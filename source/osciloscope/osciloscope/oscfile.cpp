@@ -44,23 +44,763 @@ void jsonToLarge(cJSON* json, const char* name, ularge& large)
 
 ////////////////////////////////////////////////////////////////////////////////
 //
-// Save
+// OscFileWriter
+//
+////////////////////////////////////////////////////////////////////////////////
+OscFileHeader::OscFileHeader()
+{
+    SDL_memset(this, 0, sizeof(OscFileHeader));
+}
+
+OscFileWriter::OscFileWriter()
+{
+    ctx       = 0;
+    frames    = 0;
+    frameMax  = 0;
+    chunks    = 0;
+    chunkMax  = 0;
+    chunk     = 0;
+    packed    = 0;
+    chunkFill = 0;
+    error     = 0;
+}
+
+OscFileWriter::~OscFileWriter()
+{
+    release();
+}
+
+void OscFileWriter::release()
+{
+    if(ctx)
+    {
+        SDL_RWclose(ctx);
+        ctx = 0;
+    }
+    pMemory->free(frames);
+    pMemory->free(chunks);
+    pMemory->free(chunk);
+    pMemory->free(packed);
+    frames = 0;
+    chunks = 0;
+    chunk  = 0;
+    packed = 0;
+}
+
+uint OscFileWriter::open(const char* path, uint hwVersion, uint hwHeader, uint hwData, uint hwPacket, uint chunkSize, uint compression)
+{
+    release();
+    ctx = SDL_RWFromFile(path, "w+b");
+    if(!ctx)
+    {
+        return 1;
+    }
+    header = OscFileHeader();
+    header.magic       = OSC_FILE_MAGIC;
+    header.version     = OSC_FILE_VERSION;
+    header.hwVersion   = hwVersion;
+    header.hwHeader    = hwHeader;
+    header.hwData      = hwData;
+    header.hwPacket    = hwPacket;
+    header.chunkSize   = clamp<uint>(chunkSize ? chunkSize : OSC_FILE_CHUNK, SCOPEFUN_FRAME_PACKET, OSC_FILE_CHUNK_MAX);
+    header.compression = compression < ofcLast ? compression : ofcNone;
+    frameMax  = 1024;
+    chunkMax  = 256;
+    frames    = (OscFileFrame*)pMemory->allocate(frameMax * sizeof(OscFileFrame));
+    chunks    = (OscFileChunk*)pMemory->allocate(chunkMax * sizeof(OscFileChunk));
+    chunk     = (byte*)pMemory->allocate(header.chunkSize);
+    packed    = (byte*)pMemory->allocate(header.chunkSize);
+    chunkFill = 0;
+    error     = 0;
+    // header is written again with the counts on close
+    if(SDL_RWwrite(ctx, &header, sizeof(OscFileHeader), 1) != 1)
+    {
+        error = 1;
+    }
+    return error;
+}
+
+uint OscFileWriter::frame(CaptureFrame& capture)
+{
+    if(header.frameCount == frameMax)
+    {
+        frameMax *= 2;
+        frames = (OscFileFrame*)pMemory->reallocate(frames, frameMax * sizeof(OscFileFrame));
+    }
+    OscFileFrame& entry = frames[header.frameCount++];
+    entry.offset    = header.dataSize;
+    entry.size      = 0;
+    entry.time      = capture.time;
+    entry.frameSize = capture.frameSize;
+    entry.version   = uint(capture.version);
+    entry.header    = uint(capture.header);
+    entry.data      = uint(capture.data);
+    entry.packet    = uint(capture.packet);
+    return 0;
+}
+
+uint OscFileWriter::write(byte* data, ularge size)
+{
+    if(!header.frameCount)
+    {
+        return 1;
+    }
+    frames[header.frameCount - 1].size += size;
+    header.dataSize += size;
+    while(size)
+    {
+        uint count = (uint)min<ularge>(size, header.chunkSize - chunkFill);
+        SDL_memcpy(chunk + chunkFill, data, count);
+        chunkFill += count;
+        data      += count;
+        size      -= count;
+        if(chunkFill == header.chunkSize)
+        {
+            flush();
+        }
+    }
+    return error;
+}
+
+uint OscFileWriter::flush()
+{
+    if(!chunkFill)
+    {
+        return 0;
+    }
+    if(header.chunkCount == chunkMax)
+    {
+        chunkMax *= 2;
+        chunks = (OscFileChunk*)pMemory->reallocate(chunks, chunkMax * sizeof(OscFileChunk));
+    }
+    OscFileChunk& entry = chunks[header.chunkCount++];
+    entry.offset      = SDL_RWtell(ctx);
+    entry.size        = chunkFill;
+    entry.compression = ofcNone;
+    byte* data = chunk;
+    if(header.compression == ofcRle)
+    {
+        // kept only when smaller, random data would grow
+        ularge size = rleEncode(packed, chunkFill - 1, chunk, chunkFill);
+        if(size)
+        {
+            entry.size        = uint(size);
+            entry.compression = ofcRle;
+            data              = packed;
+        }
+    }
+    if(SDL_RWwrite(ctx, data, entry.size, 1) != 1)
+    {
+        error = 1;
+    }
+    chunkFill = 0;
+    return error;
+}
+
+uint OscFileWriter::close()
+{
+    if(!ctx)
+    {
+        return 1;
+    }
+    flush();
+    header.indexOffset = SDL_RWtell(ctx);
+    if(header.frameCount && SDL_RWwrite(ctx, frames, sizeof(OscFileFrame) * header.frameCount, 1) != 1)
+    {
+        error = 1;
+    }
+    if(header.chunkCount && SDL_RWwrite(ctx, chunks, sizeof(OscFileChunk) * header.chunkCount, 1) != 1)
+    {
+        error = 1;
+    }
+    SDL_RWseek(ctx, 0, RW_SEEK_SET);
+    if(SDL_RWwrite(ctx, &header, sizeof(OscFileHeader), 1) != 1)
+    {
+        error = 1;
+    }
+    release();
+    return error;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//
+// OscFileReader
+//
+////////////////////////////////////////////////////////////////////////////////
+OscFileReader::OscFileReader()
+{
+    ctx         = 0;
+    frames      = 0;
+    chunks      = 0;
+    chunk       = 0;
+    packed      = 0;
+    chunkCached = ~ularge(0);
+}
+
+OscFileReader::~OscFileReader()
+{
+    close();
+}
+
+uint OscFileReader::isChunked(const char* path)
+{
+    uint magic = 0;
+    SDL_RWops* file = SDL_RWFromFile(path, "rb");
+    if(file)
+    {
+        if(SDL_RWread(file, &magic, sizeof(uint), 1) != 1)
+        {
+            magic = 0;
+        }
+        SDL_RWclose(file);
+    }
+    return magic == OSC_FILE_MAGIC;
+}
+
+uint OscFileReader::open(const char* path)
+{
+    close();
+    ctx = SDL_RWFromFile(path, "rb");
+    if(!ctx)
+    {
+        return 1;
+    }
+    Sint64 fileSize = SDL_RWsize(ctx);
+    if(SDL_RWread(ctx, &header, sizeof(OscFileHeader), 1) != 1 ||
+       header.magic != OSC_FILE_MAGIC ||
+       header.version != OSC_FILE_VERSION ||
+       header.chunkSize == 0 ||
+       header.chunkSize > OSC_FILE_CHUNK_MAX ||
+       header.chunkCount != (header.dataSize + header.chunkSize - 1) / header.chunkSize ||
+       header.indexOffset + header.frameCount * sizeof(OscFileFrame) + header.chunkCount * sizeof(OscFileChunk) > ularge(fileSize))
+    {
+        close();
+        return 1;
+    }
+    frames = (OscFileFrame*)pMemory->allocate(max<ularge>(header.frameCount, 1) * sizeof(OscFileFrame));
+    chunks = (OscFileChunk*)pMemory->allocate(max<ularge>(header.chunkCount, 1) * sizeof(OscFileChunk));
+    chunk  = (byte*)pMemory->allocate(header.chunkSize);
+    packed = (byte*)pMemory->allocate(header.chunkSize);
+    SDL_RWseek(ctx, header.indexOffset, RW_SEEK_SET);
+    if((header.frameCount && SDL_RWread(ctx, frames, sizeof(OscFileFrame) * header.frameCount, 1) != 1) ||
+       (header.chunkCount && SDL_RWread(ctx, chunks, sizeof(OscFileChunk) * header.chunkCount, 1) != 1))
+    {
+        close();
+        return 1;
+    }
+    return 0;
+}
+
+void OscFileReader::close()
+{
+    if(ctx)
+    {
+        SDL_RWclose(ctx);
+        ctx = 0;
+    }
+    pMemory->free(frames);
+    pMemory->free(chunks);
+    pMemory->free(chunk);
+    pMemory->free(packed);
+    frames = 0;
+    chunks = 0;
+    chunk  = 0;
+    packed = 0;
+    chunkCached = ~ularge(0);
+}
+
+ularge OscFileReader::frameCount()
+{
+    return header.frameCount;
+}
+
+uint OscFileReader::frame(ularge index, OscFileFrame& frame)
+{
+    if(index >= header.frameCount)
+    {
+        return 1;
+    }
+    frame = frames[index];
+    return 0;
+}
+
+uint OscFileReader::loadChunk(ularge index)
+{
+    if(chunkCached == index)
+    {
+        return 0;
+    }
+    chunkCached = ~ularge(0);
+    OscFileChunk& entry = chunks[index];
+    uint raw = (uint)min<ularge>(header.chunkSize, header.dataSize - index * header.chunkSize);
+    SDL_RWseek(ctx, entry.offset, RW_SEEK_SET);
+    if(entry.compression == ofcRle)
+    {
+        if(entry.size > header.chunkSize || SDL_RWread(ctx, packed, entry.size, 1) != 1 || rleDecode(chunk, raw, packed, entry.size) != raw)
+        {
+            return 1;
+        }
+    }
+    else
+    {
+        if(entry.size != raw || SDL_RWread(ctx, chunk, raw, 1) != 1)
+        {
+            return 1;
+        }
+    }
+    chunkCached = index;
+    return 0;
+}
+
+ularge OscFileReader::read(ularge index, ularge offset, byte* buffer, ularge size)
+{
+    if(index >= header.frameCount || offset >= frames[index].size)
+    {
+        return 0;
+    }
+    size = min(size, frames[index].size - offset);
+    ularge pos  = frames[index].offset + offset;
+    ularge done = 0;
+    while(done < size)
+    {
+        ularge c      = pos / header.chunkSize;
+        uint   within = uint(pos % header.chunkSize);
+        uint   count  = (uint)min<ularge>(size - done, header.chunkSize - within);
+        if(c >= header.chunkCount)
+        {
+            break;
+        }
+        if(chunks[c].compression == ofcNone && chunkCached != c)
+        {
+            // stored chunks are read in place
+            SDL_RWseek(ctx, chunks[c].offset + within, RW_SEEK_SET);
+            if(SDL_RWread(ctx, buffer + done, count, 1) != 1)
+            {
+                break;
+            }
+        }
+        else
+        {
+            if(loadChunk(c))
+            {
+                break;
+            }
+            SDL_memcpy(buffer + done, chunk + within, count);
+        }
+        done += count;
+        pos  += count;
+    }
+    return done;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//
+// OscExport
+//
+////////////////////////////////////////////////////////////////////////////////
+#define OSC_EXPORT_ROW 96
+
+static const char exportDigits[] =
+    "00010203040506070809101112131415161718192021222324252627282930313233343536373839404142434445464748495051525354555657585960616263646566676869707172737475767778798081828384858687888990919293949596979899";
+
+static const ularge exportScale[10] = { 1ULL, 10ULL, 100ULL, 1000ULL, 10000ULL, 100000ULL, 1000000ULL, 10000000ULL, 100000000ULL, 1000000000ULL };
+
+static const char* exportExtension[oefLast] = { ".csv", ".raw", ".bin" };
+
+static char* exportLarge(char* dest, ularge value)
+{
+    // two digits at a time from the back
+    char  digits[24];
+    char* end = digits + sizeof(digits);
+    char* pos = end;
+    while(value >= 100)
+    {
+        uint pair = uint(value % 100) * 2;
+        value /= 100;
+        *--pos = exportDigits[pair + 1];
+        *--pos = exportDigits[pair];
+    }
+    if(value >= 10)
+    {
+        uint pair = uint(value) * 2;
+        *--pos = exportDigits[pair + 1];
+        *--pos = exportDigits[pair];
+    }
+    else
+    {
+        *--pos = char('0' + value);
+    }
+    SDL_memcpy(dest, pos, end - pos);
+    return dest + (end - pos);
+}
+
+char* exportInteger(char* dest, ilarge value)
+{
+    if(value < 0)
+    {
+        *dest++ = '-';
+        return exportLarge(dest, ularge(0) - ularge(value));
+    }
+    return exportLarge(dest, ularge(value));
+}
+
+char* exportFixed(char* dest, double value, uint decimals)
+{
+    decimals = min<uint>(decimals, 9);
+    ularge scale    = exportScale[decimals];
+    double absolute = min(value < 0 ? -value : value, 1e18 / double(scale));
+    ularge scaled   = ularge(absolute * double(scale) + 0.5);
+    if(value < 0 && scaled)
+    {
+        *dest++ = '-';
+    }
+    dest = exportLarge(dest, scaled / scale);
+    if(decimals)
+    {
+        ularge fraction = scaled % scale;
+        *dest++ = '.';
+        for(uint i = decimals; i > 0; i--)
+        {
+            dest[i - 1] = char('0' + fraction % 10);
+            fraction /= 10;
+        }
+        dest += decimals;
+    }
+    return dest;
+}
+
+static inline byte* exportSample(byte* dest, ishort ch0, ishort ch1, ushort digital)
+{
+    dest[0] = byte(ushort(ch0));
+    dest[1] = byte(ushort(ch0) >> 8);
+    dest[2] = byte(ushort(ch1));
+    dest[3] = byte(ushort(ch1) >> 8);
+    dest[4] = byte(digital);
+    dest[5] = byte(digital >> 8);
+    return dest + OSC_EXPORT_SAMPLE;
+}
+
+OscExportHeader::OscExportHeader()
+{
+    SDL_memset(this, 0, sizeof(OscExportHeader));
+}
+
+OscExport::OscExport()
+{
+    ctx       = 0;
+    format    = oefCsv;
+    buffer    = 0;
+    fill      = 0;
+    analog0   = 0;
+    analog1   = 0;
+    digital   = 0;
+    attr      = 0;
+    firstTime = 0;
+    bytesIn   = 0;
+    bytesOut  = 0;
+    error     = 0;
+}
+
+OscExport::~OscExport()
+{
+    release();
+}
+
+const char* OscExport::extension(uint format)
+{
+    return exportExtension[format < oefLast ? format : oefCsv];
+}
+
+void OscExport::release()
+{
+    if(ctx)
+    {
+        SDL_RWclose(ctx);
+        ctx = 0;
+    }
+    pMemory->free(buffer);
+    pMemory->free(analog0);
+    pMemory->free(analog1);
+    pMemory->free(digital);
+    pMemory->free(attr);
+    buffer  = 0;
+    analog0 = 0;
+    analog1 = 0;
+    digital = 0;
+    attr    = 0;
+}
+
+uint OscExport::open(SDL_RWops* output, uint exportFormat)
+{
+    release();
+    if(!output)
+    {
+        return 1;
+    }
+    ctx      = output;
+    format   = exportFormat < oefLast ? exportFormat : oefCsv;
+    buffer   = (byte*)pMemory->allocate(OSC_EXPORT_BUFFER);
+    analog0  = (ishort*)pMemory->allocate(OSC_EXPORT_BLOCK * sizeof(ishort));
+    analog1  = (ishort*)pMemory->allocate(OSC_EXPORT_BLOCK * sizeof(ishort));
+    digital  = (ushort*)pMemory->allocate(OSC_EXPORT_BLOCK * sizeof(ushort));
+    attr     = (byte*)pMemory->allocate(OSC_EXPORT_BLOCK * sizeof(byte));
+    fill     = 0;
+    bytesIn  = 0;
+    bytesOut = 0;
+    error    = 0;
+    header   = OscExportHeader();
+    header.magic       = OSC_EXPORT_MAGIC;
+    header.version     = OSC_EXPORT_VERSION;
+    header.channels    = 2;
+    header.digitalBits = 16;
+    header.sampleBytes = OSC_EXPORT_SAMPLE;
+    header.frameBytes  = sizeof(OscExportFrame);
+    if(format == oefCsv)
+    {
+        const char* columns = "frame,time,ch0,ch1,digital\r\n";
+        fill = (uint)SDL_strlen(columns);
+        SDL_memcpy(buffer, columns, fill);
+    }
+    if(format == oefBinary)
+    {
+        // written again with the counts on close
+        SDL_memcpy(buffer, &header, sizeof(OscExportHeader));
+        fill = sizeof(OscExportHeader);
+    }
+    return 0;
+}
+
+uint OscExport::frame(byte* data, uint version, OscExportFrame& info)
+{
+    if(!ctx)
+    {
+        return 1;
+    }
+    if(!header.frameCount)
+    {
+        firstTime = info.time;
+    }
+    ularge frameId = header.frameCount++;
+    header.sampleCount += info.samples;
+    bytesIn += info.samples * (version == 1 ? 6 : 4);
+    if(format == oefBinary)
+    {
+        if(fill + sizeof(OscExportFrame) > OSC_EXPORT_BUFFER)
+        {
+            flush();
+        }
+        SDL_memcpy(buffer + fill, &info, sizeof(OscExportFrame));
+        fill += sizeof(OscExportFrame);
+    }
+    double seconds = double(info.time > firstTime ? info.time - firstTime : 0) / 1000000.0;
+    DisplayDecode decode;
+    decode.data     = data;
+    decode.version  = version;
+    decode.step     = 1;
+    decode.analog0  = analog0;
+    decode.analog1  = analog1;
+    decode.digital  = digital;
+    decode.attr     = attr;
+    decode.capacity = OSC_EXPORT_BLOCK;
+    for(ularge start = 0; start < info.samples; start += OSC_EXPORT_BLOCK)
+    {
+        decode.start = uint(start);
+        decode.end   = uint(min<ularge>(start + OSC_EXPORT_BLOCK, info.samples));
+        uint count = decodeDisplay(decode);
+        if(format == oefCsv)
+        {
+            if(fill + count * OSC_EXPORT_ROW > OSC_EXPORT_BUFFER)
+            {
+                flush();
+            }
+            char* row = (char*)buffer + fill;
+            for(uint k = 0; k < count; k++)
+            {
+                row = exportLarge(row, frameId);
+                *row++ = ',';
+                row = exportFixed(row, seconds + double(start + k) * info.timeStep, 9);
+                *row++ = ',';
+                row = exportFixed(row, double(analog0[k]) * info.voltStep0, 6);
+                *row++ = ',';
+                row = exportFixed(row, double(analog1[k]) * info.voltStep1, 6);
+                *row++ = ',';
+                row = exportLarge(row, digital[k]);
+                *row++ = '\r';
+                *row++ = '\n';
+            }
+            fill = uint(row - (char*)buffer);
+        }
+        else
+        {
+            if(fill + count * OSC_EXPORT_SAMPLE > OSC_EXPORT_BUFFER)
+            {
+                flush();
+            }
+            byte* sample = buffer + fill;
+            for(uint k = 0; k < count; k++)
+            {
+                sample = exportSample(sample, analog0[k], analog1[k], digital[k]);
+            }
+            fill = uint(sample - buffer);
+        }
+    }
+    return error;
+}
+
+uint OscExport::flush()
+{
+    if(!fill)
+    {
+        return error;
+    }
+    if(SDL_RWwrite(ctx, buffer, fill, 1) != 1)
+    {
+        error = 1;
+    }
+    bytesOut += fill;
+    fill = 0;
+    return error;
+}
+
+uint OscExport::close()
+{
+    if(!ctx)
+    {
+        return 1;
+    }
+    flush();
+    if(format == oefBinary)
+    {
+        SDL_RWseek(ctx, 0, RW_SEEK_SET);
+        if(SDL_RWwrite(ctx, &header, sizeof(OscExportHeader), 1) != 1)
+        {
+            error = 1;
+        }
+    }
+    release();
+    return error;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//
+// CaptureInterface
 //
 ////////////////////////////////////////////////////////////////////////////////
-class OscFileHeader
+uint CaptureInterface::saveFile(const char* path, uint chunkSize, uint compression, uint& progress, uint& active)
+{
+    lock();
+    int version = 0;
+    int frameHeader = 0;
+    int frameData = 0;
+    int framePacket = 0;
+    pOsciloscope->thread.getFrame(&version, &frameHeader, &frameData, &framePacket);
+    OscFileWriter writer;
+    if(writer.open(path, version, frameHeader, frameData, framePacket, chunkSize, compression))
+    {
+        unlock();
+        return 1;
+    }
+    // frames in capture order, each one as its packets back to back
+    openRead();
+    ularge count = ringFrame.getCount();
+    for(ularge i = 0; i < count; i++)
+    {
+        progress = uint((i * 100) / count);
+        active   = 1;
+        CaptureFrame* frame = ringFrame.peek((ringFrame.getStart() + i) % ringFrame.getSize());
+        writer.frame(*frame);
+        for(ularge p = 0; p < frame->packetCount; p++)
+        {
+            PacketData* packet = ringPacket.peek((frame->packetStart + p) % ringPacket.getSize());
+            read(packet->offset, transferPacket.data, packet->size);
+            writer.write(transferPacket.data, packet->size);
+        }
+    }
+    closeRead();
+    uint ret = writer.close();
+    unlock();
+    return ret;
+}
+
+uint CaptureInterface::loadFile(const char* path, uint& progress, uint& active)
 {
-public:
-    uint  historyStart;
-    uint  historyCount;
-    uint  historySize;
-};
+    OscFileReader reader;
+    if(reader.open(path))
+    {
+        SDL_ShowSimpleMessageBox(SDL_MESSAGEBOX_INFORMATION, "File is damaged.", path, 0);
+        return 1;
+    }
+    lock();
+    int version = 0;
+    int frameHeader = 0;
+    int frameData = 0;
+    int framePacket = 0;
+    pOsciloscope->thread.getFrame(&version, &frameHeader, &frameData, &framePacket);
+    OscFileHeader& header = reader.header;
+    if(header.hwVersion != uint(version) ||
+       header.hwHeader != uint(frameHeader) ||
+       header.hwData != uint(frameData) ||
+       header.hwPacket != uint(framePacket))
+    {
+        FORMAT_BUFFER();
+        FORMAT(" version is %d but %d expected \n header is %d but %d expected \n data is %d but %d expected \n packet is %d but %d expected \n", header.hwVersion, version, header.hwHeader, frameHeader, header.hwData, frameData, header.hwPacket, framePacket);
+        SDL_ShowSimpleMessageBox(SDL_MESSAGEBOX_INFORMATION, "File header is incompatible.", formatBuffer, 0);
+        unlock();
+        return 1;
+    }
+    // frames go through writePacket like a capture, a file larger than
+    // the history keeps its newest frames
+    ringFrame.clear();
+    ringPacket.clear();
+    openWrite();
+    ularge count = reader.frameCount();
+    for(ularge i = 0; i < count; i++)
+    {
+        progress = uint((i * 100) / count);
+        active   = 1;
+        OscFileFrame entry;
+        reader.frame(i, entry);
+        CaptureFrame frame;
+        frame.version     = entry.version;
+        frame.header      = entry.header;
+        frame.data        = entry.data;
+        frame.packet      = entry.packet;
+        frame.frameSize   = entry.frameSize;
+        frame.time        = entry.time;
+        frame.packetStart = ringPacket.getWrite();
+        ularge index = ringFrame.getWrite();
+        ringFrame.write(frame);
+        uint   packetSize = clamp<uint>(entry.packet ? entry.packet : header.hwPacket, 1, SCOPEFUN_FRAME_PACKET);
+        ularge packets = 0;
+        for(ularge offset = 0; offset < entry.size; offset += packetSize)
+        {
+            transferPacket.size = reader.read(i, offset, transferPacket.data, packetSize);
+            if(!transferPacket.size)
+            {
+                break;
+            }
+            writePacket(transferPacket, offset == 0);
+            packets++;
+        }
+        ringFrame.peek(index)->packetCount = packets;
+    }
+    closeWrite();
+    unlock();
+    return 0;
+}
 
+////////////////////////////////////////////////////////////////////////////////
+//
+// Save
+//
+////////////////////////////////////////////////////////////////////////////////
 int _saveToFile(void* param)
 {
     OscFileThread* fileThread = (OscFileThread*)param;
+    OscSettings*   settings   = pOsciloscope->settings.getSettings();
     pOsciloscope->window.progress.uiActive = 1;
     pOsciloscope->window.progress.uiRange  = 100;
-    pOsciloscope->captureBuffer->history->save(fileThread->file.asChar(), (uint&)pOsciloscope->window.progress.uiValue, (uint&)pOsciloscope->window.progress.uiActive);
+    pOsciloscope->captureBuffer->history->saveFile(fileThread->file.asChar(), settings->fileChunk * MEGABYTE, settings->fileCompression, (uint&)pOsciloscope->window.progress.uiValue, (uint&)pOsciloscope->window.progress.uiActive);
     pOsciloscope->window.progress.uiActive = 1;
     pOsciloscope->window.progress.uiRange = 100;
     pOsciloscope->window.progress.uiValue = 0;
@@ -80,160 +820,151 @@ int OsciloscopeManager::saveToFile(const char* file)
     return 0;
 }
 
-int _convertToText(void* param)
+void exportFrame(OscExport& exporter, byte* dataPtr, uint version, uint header, uint data, uint packet, ularge frameSize, ularge time)
+{
+    OscExportFrame info;
+    SDL_memset(&info, 0, sizeof(OscExportFrame));
+    info.time = time;
+    // v1 samples are 6 bytes, v2 samples 4 bytes, never past what was stored
+    uint   sampleBytes = version == 1 ? 6 : 4;
+    ularge stored      = min<ularge>(frameSize, SCOPEFUN_FRAME_MEMORY);
+    ularge samples     = pOsciloscope->captureBuffer->getFrameSamples(dataPtr, version, header, data, packet);
+    info.samples = stored > header ? min<ularge>(samples, (stored - header) / sampleBytes) : 0;
+    // scale from the hardware state stored in the frame header
+    uint yRange0 = 0;
+    uint yRange1 = 0;
+    int  xRange  = 0;
+    if(version == 1)
+    {
+        OsciloscopeControl1 control;
+        control.client1Set(*(SHardware1*)&((SFrameHeader1*)dataPtr)->hardware.bytes[0]);
+        yRange0 = control.getYRangeA();
+        yRange1 = control.getYRangeB();
+        xRange  = control.getXRange();
+    }
+    else
+    {
+        OsciloscopeControl2 control;
+        control.client2Set(*(SHardware2*)&((SFrameHeader2*)dataPtr)->hardware.bytes[0]);
+        yRange0 = control.getYRangeA();
+        yRange1 = control.getYRangeB();
+        xRange  = control.getXRange();
+    }
+    double yGridMax = 5.0;
+    info.timeStep  = captureTimeFromEnumVersion(xRange, version);
+    info.voltStep0 = double(captureVoltFromEnum(yRange0)) * yGridMax / 512.0;
+    info.voltStep1 = double(captureVoltFromEnum(yRange1)) * yGridMax / 512.0;
+    exporter.frame(dataPtr + header, version, info);
+}
+
+int _exportFile(void* param)
 {
     OscFileThread* fileThread = (OscFileThread*)param;
     pOsciloscope->window.progress.uiActive = 1;
     pOsciloscope->window.progress.uiRange = 100;
-    int& textPercent = pOsciloscope->window.progress.uiText;
     int& progress = pOsciloscope->window.progress.uiValue;
     int& active = pOsciloscope->window.progress.uiActive;
-    int frameHeader = 0;
-    int frameData   = 0;
-    int framePacket = 0;
-    // header
-    CaptureHeader header;
-    SDL_RWops* ctxRead = SDL_RWFromFile(fileThread->file.asChar(), "rb");
-    SDL_RWread(ctxRead, &header, sizeof(CaptureHeader), 1);
-    // allocate frames
-    Ring<CaptureFrame> ringFrame;
-    CaptureFrame* framePtr = (CaptureFrame*)pMemory->allocate(header.frameSize * sizeof(CaptureFrame));
-    ringFrame.init(framePtr, header.frameSize);
-    ringFrame.setStart(header.frameStart);
-    ringFrame.setCount(header.frameCount);
-    // read frames
-    for(int i = 0; i < header.frameSize; i++)
-    {
-        progress = (i * 100) / header.frameSize;
-        active = 1;
-        SDL_RWread(ctxRead, (void*)(framePtr + i), sizeof(CaptureFrame), 1);
-    }
-    // allocate packets
-    Ring<PacketData> ringPacket;
-    PacketData* packetPtr = (PacketData*)pMemory->allocate(header.packetSize * sizeof(PacketData));
-    ringPacket.init(packetPtr, header.packetSize);
-    ringPacket.setStart(header.packetStart);
-    ringPacket.setCount(header.packetCount);
-    // load packets
-    for(int i = 0; i < header.packetSize; i++)
-    {
-        progress = (i * 100) / header.packetSize;
-        active = 1;
-        SDL_RWread(ctxRead, (void*)(packetPtr + i), sizeof(PacketData), 1);
-    }
-    // count, start
-    ringFrame.setStart(header.frameStart);
-    ringFrame.setCount(header.frameCount);
-    ringPacket.setStart(header.packetStart);
-    ringPacket.setCount(header.packetCount);
     // output
-    String outputTextFile = fileThread->file;
-    outputTextFile.replace(".osc", ".txt");
-    SDL_RWops* ctxWrite = SDL_RWFromFile(outputTextFile.asChar(), "w+b");
-    // frame
-    byte*   dataPtr = (byte*)pMemory->allocate(SCOPEFUN_FRAME_MEMORY);
-    CaptureFrame frame;
-    PacketData   packet;
-    FORMAT_BUFFER();
-    uint frameId = 0;
-    int frameCount = ringFrame.getCount();
-    while(!ringFrame.isEmpty())
-    {
-        ringFrame.read(frame);
-        textPercent = (frameId * 100) / frameCount;
-        active = 1;
-        SDL_memset(dataPtr, 0, SCOPEFUN_FRAME_MEMORY);
-        uint offset = 0;
-        for(uint i = 0; i < frame.packetCount; i++)
+    String outputFile = fileThread->file;
+    outputFile.replace(".osc", OscExport::extension(fileThread->format));
+    OscExport exporter;
+    ularge    ticks   = SDL_GetPerformanceCounter();
+    byte*     dataPtr = (byte*)pMemory->allocate(SCOPEFUN_FRAME_MEMORY);
+    if(exporter.open(SDL_RWFromFile(outputFile.asChar(), "w+b"), fileThread->format) != 0)
+    {
+        // nothing to write to
+    }
+    else if(OscFileReader::isChunked(fileThread->file.asChar()))
+    {
+        // chunked file, frames are read one by one through the index
+        OscFileReader reader;
+        if(reader.open(fileThread->file.asChar()) == 0)
         {
-            progress = (i * 100) / frame.packetCount;
-            active = 1;
-            ringPacket.read(packet);
-            SDL_RWread(ctxRead, (void*)(dataPtr + offset), packet.size, 1);
-            offset += packet.size;
+            ularge frameCount = reader.frameCount();
+            for(ularge i = 0; i < frameCount; i++)
+            {
+                progress = int((i * 100) / frameCount);
+                active = 1;
+                OscFileFrame entry;
+                reader.frame(i, entry);
+                ularge size = reader.read(i, 0, dataPtr, SCOPEFUN_FRAME_MEMORY);
+                SDL_memset(dataPtr + size, 0, SCOPEFUN_FRAME_MEMORY - size);
+                exportFrame(exporter, dataPtr, entry.version, entry.header, entry.data, entry.packet, entry.frameSize, entry.time);
+            }
         }
-        // output to text file
+    }
+    else
+    {
         // header
-        SFrameHeader1* frameHeader1 = (SFrameHeader1*)dataPtr;
-        SFrameHeader2* frameHeader2 = (SFrameHeader2*)dataPtr;
-        uint  sampleCount = 0;
-        byte*   samplePtr = 0;
-        if(frame.version == 2)
-        {
-            OsciloscopeControl2 ctr2;
-            ctr2.client2Set(*(SHardware2*)&frameHeader2->hardware.bytes[0]);
-            uint sampleSize = ctr2.getSampleSize();
-            uint  frameSize = sampleSize * 4 + sizeof(SFrameHeader2);
-            FORMAT("frameId=%d\r\nmagic=%x\r\nframeSize=%d\r\n", frameId++, frameHeader2->magic, frameSize);
-            SDL_RWwrite(ctxWrite, formatBuffer, SDL_strlen(formatBuffer), 1);
-            sampleCount = (frame.frameSize - SCOPEFUN_FRAME_2_HEADER) / 6;
-            samplePtr   = (byte*)dataPtr + SCOPEFUN_FRAME_2_HEADER;
-        }
-        if(frame.version == 1)
+        CaptureHeader header;
+        SDL_RWops* ctxRead = SDL_RWFromFile(fileThread->file.asChar(), "rb");
+        SDL_RWread(ctxRead, &header, sizeof(CaptureHeader), 1);
+        // allocate frames
+        Ring<CaptureFrame> ringFrame;
+        CaptureFrame* framePtr = (CaptureFrame*)pMemory->allocate(header.frameSize * sizeof(CaptureFrame));
+        ringFrame.init(framePtr, header.frameSize);
+        // read frames
+        for(ularge i = 0; i < header.frameSize; i++)
         {
-            FORMAT("frameId=%d\r\nmagic=%x\r\nframeSize=%d\r\n", frameId++, frameHeader1->magic, frameHeader1->frameSize);
-            SDL_RWwrite(ctxWrite, formatBuffer, SDL_strlen(formatBuffer), 1);
-            sampleCount = (frame.frameSize - SCOPEFUN_FRAME_1_HEADER) / 6;
-            samplePtr = (byte*)dataPtr + SCOPEFUN_FRAME_1_HEADER;
-        }
-        // todo: configuration
-        // ch0
-        for(int i = 0; i < 2; i++)
-        {
-            progress = (i * 100) / 2;
-            active = 1;
-            FORMAT("ch%d=", i);
-            SDL_RWwrite(ctxWrite, formatBuffer, SDL_strlen(formatBuffer), 1);
-            for(uint i = 0; i < sampleCount; i++)
-            {
-                uint offset = i * 6;
-                ushort ch0 = *(ushort*)(samplePtr + offset + 0);
-                ushort ch1 = *(ushort*)(samplePtr + offset + 2);
-                ushort dig = *(ushort*)(samplePtr + offset + 4);
-                FORMAT("%d", i == 0 ? ch0 : ch1);
-                SDL_RWwrite(ctxWrite, formatBuffer, SDL_strlen(formatBuffer), 1);
-                if(i < sampleCount - 1)
-                {
-                    FORMAT(",", 0);
-                    SDL_RWwrite(ctxWrite, formatBuffer, SDL_strlen(formatBuffer), 1);
-                }
-            }
-            FORMAT("\r\n", 0);
-            SDL_RWwrite(ctxWrite, formatBuffer, SDL_strlen(formatBuffer), 1);
+            SDL_RWread(ctxRead, (void*)(framePtr + i), CAPTURE_FRAME_LEGACY, 1);
+            framePtr[i].time = 0;
         }
-        // dig
-        for(int d = 0; d < 16; d++)
+        // allocate packets
+        Ring<PacketData> ringPacket;
+        PacketData* packetPtr = (PacketData*)pMemory->allocate(header.packetSize * sizeof(PacketData));
+        ringPacket.init(packetPtr, header.packetSize);
+        // load packets
+        SDL_RWread(ctxRead, (void*)packetPtr, sizeof(PacketData), header.packetSize);
+        // count, start
+        ringFrame.setStart(header.frameStart);
+        ringFrame.setCount(header.frameCount);
+        ringPacket.setStart(header.packetStart);
+        ringPacket.setCount(header.packetCount);
+        // frame
+        CaptureFrame frame;
+        PacketData   packet;
+        uint frameId = 0;
+        uint frameCount = ringFrame.getCount();
+        while(!ringFrame.isEmpty())
         {
-            progress = (d * 100) / 16;
+            ringFrame.read(frame);
+            progress = int((frameId++ * 100) / frameCount);
             active = 1;
-            FORMAT("dig%d=", d);
-            SDL_RWwrite(ctxWrite, formatBuffer, SDL_strlen(formatBuffer), 1);
-            for(uint i = 0; i < sampleCount; i++)
+            uint offset = 0;
+            for(uint i = 0; i < frame.packetCount; i++)
             {
-                uint offset = i * 6;
-                ushort ch0 = *(ushort*)(samplePtr + offset + 0);
-                ushort ch1 = *(ushort*)(samplePtr + offset + 2);
-                ushort dig = *(ushort*)(samplePtr + offset + 4);
-                FORMAT("%d", (dig >> i) & 0x1);
-                SDL_RWwrite(ctxWrite, formatBuffer, SDL_strlen(formatBuffer), 1);
-                if(i < sampleCount - 1)
-                {
-                    FORMAT(",", 0);
-                    SDL_RWwrite(ctxWrite, formatBuffer, SDL_strlen(formatBuffer), 1);
-                }
+                ringPacket.read(packet);
+                uint size = min<uint>(packet.size, SCOPEFUN_FRAME_MEMORY - offset);
+                SDL_RWread(ctxRead, (void*)(dataPtr + offset), size, 1);
+                SDL_RWseek(ctxRead, packet.size - size, RW_SEEK_CUR);
+                offset += size;
             }
-            FORMAT("\r\n", 0);
-            SDL_RWwrite(ctxWrite, formatBuffer, SDL_strlen(formatBuffer), 1);
+            SDL_memset(dataPtr + offset, 0, SCOPEFUN_FRAME_MEMORY - offset);
+            exportFrame(exporter, dataPtr, uint(frame.version), uint(frame.header), uint(frame.data), uint(frame.packet), frame.frameSize, frame.time);
         }
+        SDL_RWclose(ctxRead);
+        pMemory->free(framePtr);
+        pMemory->free(packetPtr);
     }
     // close
-    SDL_RWclose(ctxRead);
-    SDL_RWclose(ctxWrite);
+    ularge frames   = exporter.header.frameCount;
+    ularge bytesIn  = exporter.bytesIn;
+    uint   error    = exporter.close();
+    ularge bytesOut = exporter.bytesOut;
     pMemory->free(dataPtr);
+    ticks = SDL_GetPerformanceCounter() - ticks;
+    double seconds = max(double(ticks) / double(SDL_GetPerformanceFrequency()), 0.000001);
+    SDL_Log("export: %s, %u frames, %u MB samples, %u MB written in %u ms, %u MB/s%s",
+            outputFile.asChar(),
+            uint(frames),
+            uint(bytesIn / MEGABYTE),
+            uint(bytesOut / MEGABYTE),
+            uint(seconds * 1000.0),
+            uint(double(bytesOut) / double(MEGABYTE) / seconds),
+            error ? ", write failed" : "");
     pOsciloscope->window.progress.uiActive = 1;
     pOsciloscope->window.progress.uiRange  = 100;
     pOsciloscope->window.progress.uiValue  = 0;
-    pOsciloscope->window.progress.uiText   = 0;
     SDL_AtomicSet(&fileThread->atomic, 0);
     return 0;
 }
@@ -248,7 +979,15 @@ int _loadFromFile(void* param)
     OscFileThread* fileThread = (OscFileThread*)param;
     pOsciloscope->window.progress.uiActive = 1;
     pOsciloscope->window.progress.uiRange = 100;
-    pOsciloscope->captureBuffer->history->load(fileThread->file.asChar(), (uint&)pOsciloscope->window.progress.uiValue, (uint&)pOsciloscope->window.progress.uiActive);
+    if(OscFileReader::isChunked(fileThread->file.asChar()))
+    {
+        pOsciloscope->captureBuffer->history->loadFile(fileThread->file.asChar(), (uint&)pOsciloscope->window.progress.uiValue, (uint&)pOsciloscope->window.progress.uiActive);
+    }
+    else
+    {
+        pOsciloscope->captureBuffer->history->load(fileThread->file.asChar(), (uint&)pOsciloscope->window.progress.uiValue, (uint&)pOsciloscope->window.progress.uiActive);
+    }
+    pOsciloscope->captureBuffer->newGeneration();
     pOsciloscope->window.progress.uiActive = 1;
     pOsciloscope->window.progress.uiRange = 100;
     pOsciloscope->window.progress.uiValue = 0;
@@ -269,11 +1008,17 @@ int OsciloscopeManager::loadFromFile(const char* file)
 
 int OsciloscopeManager::convertToText(const char* file)
 {
-    fileThread.file = file;
+    return exportFile(file, settings.getSettings()->fileExport);
+}
+
+int OsciloscopeManager::exportFile(const char* file, uint format)
+{
+    fileThread.file   = file;
+    fileThread.format = format;
     if(fileThread.file.posReverse(".osc") > 0)
     {
         SDL_AtomicSet(&fileThread.atomic, 1);
-        fileThread.thread = SDL_CreateThread(_convertToText, "OscConvertToText", &fileThread);
+        fileThread.thread = SDL_CreateThread(_exportFile, "OscExport", &fileThread);
     }
     return 0;
 }
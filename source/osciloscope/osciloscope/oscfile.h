@@ -21,6 +21,214 @@
 #ifndef __OSC__FILE__
 #define __OSC__FILE__
 
+////////////////////////////////////////////////////////////////////////////////
+//
+// OscFile, .osc container version 2
+//
+//   header | chunk 0 | chunk 1 | ... | frame index | chunk index
+//
+// Frames are stored back to back as one stream that is cut into fixed size
+// chunks, each chunk is rle compressed on its own when that makes it smaller.
+// The index at the end holds where every frame starts in the stream, so a
+// frame is read by seeking to its chunks only. Files without the magic are
+// the old layout with the history rings dumped as they are.
+//
+////////////////////////////////////////////////////////////////////////////////
+#define OSC_FILE_MAGIC    0x3243534F
+#define OSC_FILE_VERSION  2
+#define OSC_FILE_CHUNK    (4 * MEGABYTE)
+#define OSC_FILE_CHUNK_MAX (64 * MEGABYTE)
+
+enum OscFileCompression
+{
+    ofcNone,
+    ofcRle,
+    ofcLast,
+};
+
+class CaptureFrame;
+
+class OscFileHeader
+{
+public:
+    uint   magic;
+    uint   version;
+    uint   hwVersion;
+    uint   hwHeader;
+    uint   hwData;
+    uint   hwPacket;
+    uint   chunkSize;
+    uint   compression;
+    ularge frameCount;
+    ularge chunkCount;
+    ularge dataSize;
+    ularge indexOffset;
+public:
+    OscFileHeader();
+};
+
+class OscFileFrame
+{
+public:
+    ularge offset;    // in the uncompressed stream
+    ularge size;
+    ularge time;      // capture time in microseconds
+    ularge frameSize;
+    uint   version;
+    uint   header;
+    uint   data;
+    uint   packet;
+};
+
+class OscFileChunk
+{
+public:
+    ularge offset;    // in the file
+    uint   size;      // bytes stored, uncompressed size is header.chunkSize except for the last one
+    uint   compression;
+};
+
+class OscFileWriter
+{
+public:
+    SDL_RWops*    ctx;
+    OscFileHeader header;
+    OscFileFrame* frames;
+    ularge        frameMax;
+    OscFileChunk* chunks;
+    ularge        chunkMax;
+    byte*         chunk;
+    byte*         packed;
+    uint          chunkFill;
+    uint          error;
+public:
+    OscFileWriter();
+    ~OscFileWriter();
+public:
+    uint open(const char* path, uint hwVersion, uint hwHeader, uint hwData, uint hwPacket, uint chunkSize, uint compression);
+    uint frame(CaptureFrame& frame);
+    uint write(byte* data, ularge size);
+    uint close();
+private:
+    uint flush();
+    void release();
+};
+
+class OscFileReader
+{
+public:
+    SDL_RWops*    ctx;
+    OscFileHeader header;
+    OscFileFrame* frames;
+    OscFileChunk* chunks;
+    byte*         chunk;
+    byte*         packed;
+    ularge        chunkCached;
+public:
+    OscFileReader();
+    ~OscFileReader();
+public:
+    static uint isChunked(const char* path);
+public:
+    uint   open(const char* path);
+    ularge frameCount();
+    uint   frame(ularge index, OscFileFrame& frame);
+    ularge read(ularge index, ularge offset, byte* buffer, ularge size);
+    void   close();
+private:
+    uint   loadChunk(ularge index);
+};
+
+ularge rleEncode(byte* dest, ularge destSize, byte* src, ularge srcSize);
+
+////////////////////////////////////////////////////////////////////////////////
+//
+// OscExport, bulk export of recorded frames
+//
+//   csv    : frame,time,ch0,ch1,digital one row per sample, time in seconds
+//            since the first exported frame and analog values in volts
+//   raw    : samples back to back, ch0 ishort, ch1 ishort, digital ushort,
+//            little endian
+//   binary : header | frame 0 record | frame 0 samples | frame 1 record | ...
+//            samples as in raw, the record holds the scale to get seconds
+//            and volts from them
+//
+// Frames are decoded a block at a time and the output is collected in a large
+// buffer that is written out only when full.
+//
+////////////////////////////////////////////////////////////////////////////////
+#define OSC_EXPORT_MAGIC    0x58455346
+#define OSC_EXPORT_VERSION  1
+#define OSC_EXPORT_BLOCK    4096
+#define OSC_EXPORT_BUFFER   (4 * MEGABYTE)
+#define OSC_EXPORT_SAMPLE   6
+
+enum OscExportFormat
+{
+    oefCsv,
+    oefRaw,
+    oefBinary,
+    oefLast,
+};
+
+class OscExportHeader
+{
+public:
+    uint   magic;
+    uint   version;
+    uint   channels;
+    uint   digitalBits;
+    uint   sampleBytes;
+    uint   frameBytes;
+    ularge frameCount;
+    ularge sampleCount;
+public:
+    OscExportHeader();
+};
+
+class OscExportFrame
+{
+public:
+    ularge time;      // capture time in microseconds
+    ularge samples;
+    double timeStep;  // seconds per sample
+    double voltStep0; // volts per analog step
+    double voltStep1;
+};
+
+class OscExport
+{
+public:
+    SDL_RWops*      ctx;
+    OscExportHeader header;
+    uint            format;
+    byte*           buffer;
+    uint            fill;
+    ishort*         analog0;
+    ishort*         analog1;
+    ushort*         digital;
+    byte*           attr;
+    ularge          firstTime;
+    ularge          bytesIn;
+    ularge          bytesOut;
+    uint            error;
+public:
+    OscExport();
+    ~OscExport();
+public:
+    static const char* extension(uint format);
+public:
+    uint open(SDL_RWops* ctx, uint format);
+    uint frame(byte* data, uint version, OscExportFrame& frame);
+    uint flush();
+    uint close();
+private:
+    void release();
+};
+
+char* exportInteger(char* dest, ilarge value);
+char* exportFixed(char* dest, double value, uint decimals);
+
 #endif
 ////////////////////////////////////////////////////////////////////////////////
 //
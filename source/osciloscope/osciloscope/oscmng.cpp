@@ -46,6 +46,7 @@ OscFileThread::OscFileThread()
 {
     SDL_AtomicSet(&atomic, 0);
     thread = 0;
+    format = 0;
 }
 
 int OscFileThread::isRunning()
@@ -123,8 +124,19 @@ void OscContext::getDisplay(SDisplay* dis)
 ThreadApi::ThreadApi()
 {
    lock = 0;
-   SDL_AtomicSet(&sync, 0);
+   mutex     = SDL_CreateMutex();
+   queued    = SDL_CreateCond();
+   completed = SDL_CreateCond();
+   submitHandle   = 0;
+   completeHandle = 0;
+   SDL_memset(callResult, 0, sizeof(callResult));
    resultClearAll();
+   for (int i = 0; i < afLast; i++)
+   {
+      SDL_AtomicSet(&latencyDispatch[i], 0);
+      SDL_AtomicSet(&latencyComplete[i], 0);
+   }
+   SDL_AtomicSet(&lastFunction, afLast);
 
    SDL_AtomicSet(&open,0);
    SDL_AtomicSet(&connected,0);
@@ -160,21 +172,81 @@ ThreadApi::ThreadApi()
 // thread
 //
 ////////////////////////////////////////////////////////////////////////////////
-void ThreadApi::function(EThreadApiFunction f)
+ThreadApi::~ThreadApi()
 {
-   SDL_AtomicLock(&lock);
-      SDL_AtomicAdd(&sync, 1);
-      SDL_AtomicSet(&ret[func],0);
-      func.pushBack(f);
-   SDL_AtomicUnlock(&lock);
- }
+   SDL_DestroyCond(completed);
+   SDL_DestroyCond(queued);
+   SDL_DestroyMutex(mutex);
+}
+
+ularge ThreadApi::function(EThreadApiFunction f)
+{
+   SDL_LockMutex(mutex);
+      // queue full, wait for the control thread to take the pending calls
+      while (func.getCount() == THREAD_API_QUEUE)
+      {
+         SDL_CondWait(completed, mutex);
+      }
+      ThreadApiCall call;
+      call.handle   = ++submitHandle;
+      call.function = f;
+      call.queued   = SDL_GetPerformanceCounter();
+      SDL_AtomicSet(&ret[f], 0);
+      func.pushBack(call);
+      SDL_CondSignal(queued);
+   SDL_UnlockMutex(mutex);
+   return call.handle;
+}
 
 void ThreadApi::wait()
 {
-   while (SDL_AtomicCAS(&sync, 0, 0) == SDL_FALSE)
-   {
-      SDL_Delay(1);
-   }
+   SDL_LockMutex(mutex);
+      ularge handle = submitHandle;
+   SDL_UnlockMutex(mutex);
+   wait(handle);
+}
+
+void ThreadApi::wait(ularge handle)
+{
+   SDL_LockMutex(mutex);
+      while (completeHandle < handle)
+      {
+         SDL_CondWait(completed, mutex);
+      }
+   SDL_UnlockMutex(mutex);
+}
+
+void ThreadApi::idle(uint timeoutMs)
+{
+   SDL_LockMutex(mutex);
+      if (func.getCount() == 0)
+      {
+         SDL_CondWaitTimeout(queued, mutex, timeoutMs);
+      }
+   SDL_UnlockMutex(mutex);
+}
+
+int ThreadApi::dispatchLatency(EThreadApiFunction f)
+{
+   return SDL_AtomicGet(&latencyDispatch[f]);
+}
+
+int ThreadApi::completeLatency(EThreadApiFunction f)
+{
+   return SDL_AtomicGet(&latencyComplete[f]);
+}
+
+int ThreadApi::lastDispatched()
+{
+   return SDL_AtomicGet(&lastFunction);
+}
+
+int ThreadApi::result(ularge handle)
+{
+   SDL_LockMutex(mutex);
+      int iret = callResult[handle % THREAD_API_RESULTS];
+   SDL_UnlockMutex(mutex);
+   return iret;
 }
 
 int ThreadApi::result(EThreadApiFunction func)
@@ -208,21 +280,20 @@ void ThreadApi::update()
    SDL_AtomicSet(&open, iopened);
 
    // functions
-   int decr = 0;
-   Array<EThreadApiFunction, 22>  execute;
-   SDL_AtomicLock(&lock);
-   decr = -1 * func.getCount();
+   Array<ThreadApiCall, THREAD_API_QUEUE>  execute;
+   SDL_LockMutex(mutex);
    for (int i = 0; i < func.getCount(); i++)
       execute.pushBack(func[i]);
    func.clear();
-   SDL_AtomicUnlock(&lock);
-   while (true)
+   SDL_CondBroadcast(completed);
+   SDL_UnlockMutex(mutex);
+   ularge frequency = SDL_GetPerformanceFrequency();
+   for (int i = 0; i < execute.getCount(); i++)
    {
-      uint count = execute.getCount();
-      if (count == 0) break;
-
-      EThreadApiFunction f = execute.first();
-      execute.popFront();
+      ThreadApiCall&     call = execute[i];
+      EThreadApiFunction f    = call.function;
+      ularge started = SDL_GetPerformanceCounter();
+      SDL_AtomicSet(&latencyDispatch[f], int((started - call.queued) * 1000000 / frequency));
 
       int iret = 0;
       switch (f) {
@@ -369,8 +440,17 @@ void ThreadApi::update()
          break;
       };
       SDL_AtomicSet(&ret[f], iret);
+      ularge finished = SDL_GetPerformanceCounter();
+      SDL_AtomicSet(&latencyComplete[f], int((finished - call.queued) * 1000000 / frequency));
+      SDL_AtomicSet(&lastFunction, f);
+
+      // complete
+      SDL_LockMutex(mutex);
+      callResult[call.handle % THREAD_API_RESULTS] = iret;
+      completeHandle = call.handle;
+      SDL_CondBroadcast(completed);
+      SDL_UnlockMutex(mutex);
    }
-   SDL_AtomicAdd(&sync, decr);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -956,6 +1036,14 @@ OsciloscopeManager::OsciloscopeManager()
     sliderMode  = 0;
     openglFocus = 1;
     SDL_AtomicSet(&etsClear, 1);
+    SDL_AtomicSet(&bandWidth, 0);
+    SDL_AtomicSet(&rleBandWidth, 0);
+    SDL_AtomicSet(&historyNotCopied, 0);
+    historySaved = 0;
+    SDL_AtomicSet(&renderLatency, 0);
+    SDL_AtomicSet(&handoffLatency, 0);
+    SDL_AtomicSet(&generateIdle, 0);
+    statsTime = 0.f;
     signalMode = SIGNAL_MODE_PAUSE;
     windowSlot = 0;
 }
@@ -983,6 +1071,7 @@ int SDLCALL ControlHardwareThreadFunction(void* data);
 
 int OsciloscopeManager::start()
 {
+    ularge startupTicks = SDL_GetPerformanceCounter();
     ////////////////////////////////////////////////
     // load settings
     ////////////////////////////////////////////////
@@ -995,6 +1084,14 @@ int OsciloscopeManager::start()
     signalZoom     = 1.f;
     sliderPosition = 0.5f;
     ////////////////////////////////////////////////
+    // display decode kernel must match scalar output
+    ////////////////////////////////////////////////
+    if(decodeVerify() != 0)
+    {
+        CORE_ERROR("display decode kernel %s is not bit exact, using scalar", decodeKernelName(decodeKernel()));
+        decodeSetKernel(DECODE_KERNEL_SCALAR);
+    }
+    ////////////////////////////////////////////////
     // api
     ////////////////////////////////////////////////
     pOsciloscope->thread.setInit(settings.getSettings()->memoryFrame * MEGABYTE,1,1,0);
@@ -1035,7 +1132,9 @@ int OsciloscopeManager::start()
     //////////////////////////////////////////////////////////
     // allocate memory for signal
     //////////////////////////////////////////////////////////
+    ularge allocateTicks = SDL_GetPerformanceCounter();
     allocate();
+    allocateTicks = SDL_GetPerformanceCounter() - allocateTicks;
     //////////////////////////////////////////////////////////
     // setup thread data
     //////////////////////////////////////////////////////////
@@ -1044,8 +1143,7 @@ int OsciloscopeManager::start()
     generateFrameThreadActive = true;
     controlHardwareThreadActive = true;
     updateThreadActive = true;
-    threadLoop.capture.setCount(min(settings.getSettings()->renderThreadCount, MAX_THREAD));
-    threadLoop.update.setCount(min(settings.getSettings()->renderThreadCount, MAX_THREAD));
+    threadLoop.init(min(settings.getSettings()->renderThreadCount, MAX_THREAD));
     //////////////////////////////////////////////////////////
     // camera setup
     //////////////////////////////////////////////////////////
@@ -1168,6 +1266,17 @@ int OsciloscopeManager::start()
     pRender->registerCallback(this, 10);
     pCamera->registerCamera(&cameraOsc.ortho);
     pCamera->registerCamera(&cameraFFT.ortho);
+    ////////////////////////////////////////////////
+    // startup time and memory
+    ////////////////////////////////////////////////
+    ularge frequency = SDL_GetPerformanceFrequency();
+    startupTicks = SDL_GetPerformanceCounter() - startupTicks;
+    SDL_Log("startup: %u ms, allocate: %u ms, history: %u MB %s, peak rss: %u MB",
+            uint(startupTicks * 1000 / frequency),
+            uint(allocateTicks * 1000 / frequency),
+            uint(captureBuffer->historyMemory.memoryMax / MEGABYTE),
+            captureBuffer->historyMemory.reserved ? "reserved" : "allocated",
+            uint(mapPeakResident() / MEGABYTE));
     return 0;
 }
 
@@ -1201,6 +1310,7 @@ void OsciloscopeManager::startThreads()
 
     pCaptureData = SDL_CreateThread(CaptureDataThreadFunction, "CaptureData", this);
     pGenerateFrame = SDL_CreateThread(GenerateFrameThreadFunction, "GenerateFrame", this);
+    historyCache.start();
 }
 
 void OsciloscopeManager::exitThreads()
@@ -1217,12 +1327,16 @@ void OsciloscopeManager::exitThreads()
     SDL_WaitThread(pGenerateFrame, &status);
     pGenerateFrame = 0;
 
+    historyCache.stop();
+
     controlHardwareThreadActive = false;
     SDL_WaitThread(pControlHardware, &status);
     pControlHardware = 0;
 
     renderThreadActive = false;
     pRenderThread  = 0;
+
+    threadLoop.destroy();
 }
 
 
@@ -1307,6 +1421,17 @@ int OsciloscopeManager::update(float dt)
         return 0;
     }
     ////////////////////////////////////////////////////////////////////////////////
+    // pipeline stats
+    ////////////////////////////////////////////////////////////////////////////////
+    statsTime += dt;
+    if(settings.getSettings()->statsDump > 0 && statsTime >= float(settings.getSettings()->statsDump))
+    {
+        FORMAT_BUFFER();
+        FORMAT_PATH("data/stats.json");
+        stats.dump(formatBuffer, getCtx());
+        statsTime = 0.f;
+    }
+    ////////////////////////////////////////////////////////////////////////////////
     // setup
     ////////////////////////////////////////////////////////////////////////////////
     // clearRenderTarget = !window.horizontal.ETS;
@@ -1776,6 +1901,15 @@ void OsciloscopeManager::renderThread(uint threadId, OsciloscopeThreadData& thre
     pCanvas2d->threadBegin(threadId);
     pFont->threadStart(threadId);
     ////////////////////////////////////////////////////////////////////////////////
+    // latency from frame capture to render
+    ////////////////////////////////////////////////////////////////////////////////
+    if(threadData.frame.thisFrame)
+    {
+        ularge delta = SDL_GetPerformanceCounter() - threadData.frame.thisFrame;
+        SDL_AtomicSet(&renderLatency, int(delta * 1000000 / SDL_GetPerformanceFrequency()));
+        stats.record(psLatency, uint(min<ularge>(delta * 1000000 / SDL_GetPerformanceFrequency(), 0xFFFFFFFF)));
+    }
+    ////////////////////////////////////////////////////////////////////////////////
     // measure signal
     ////////////////////////////////////////////////////////////////////////////////
     renderer.measureSignal(threadId, threadData, measure, fft);
@@ -1866,16 +2000,17 @@ void OsciloscopeManager::renderThread(uint threadId, OsciloscopeThreadData& thre
         {
             if(wndMain.channel01.OscOnOff || wndMain.channel02.OscOnOff || wndMain.function.OscOnOff)
             {
-                Ring<OsciloscopeFrame> currentFrames = threadData.history;
+                Ring<FrameSnapshot*> currentFrames = threadData.history;
                 if(currentFrames.getCount())
                 {
                     float    zDelta = 1.f / (currentFrames.getCount() - 1);
                     float         z = 1.f;
-                    OsciloscopeFrame newFrame;
+                    FrameSnapshot* snapshot = 0;
                     uint count = currentFrames.getCount();
                     for(uint i = 0; i < count; i++)
                     {
-                        currentFrames.read(newFrame);
+                        currentFrames.read(snapshot);
+                        OsciloscopeFrame& newFrame = snapshot->frame;
                         if(wndMain.channel01.OscOnOff)
                         {
                             uint r = COLOR_R(render.colorChannel0);
@@ -2033,14 +2168,15 @@ void OsciloscopeManager::renderThread(uint threadId, OsciloscopeThreadData& thre
         {
             if(!threadData.history.isEmpty())
             {
-                Ring<OsciloscopeFrame> currentFrames = threadData.history;
+                Ring<FrameSnapshot*> currentFrames = threadData.history;
                 int framesCount = currentFrames.getCount();
                 float    zDelta = 1.f / framesCount;
                 float         z = 1.f;
-                OsciloscopeFrame out;
+                FrameSnapshot* snapshot = 0;
                 for(uint i = 0; i < (uint)framesCount; i++)
                 {
-                    currentFrames.read(out);
+                    currentFrames.read(snapshot);
+                    OsciloscopeFrame& out = snapshot->frame;
                     if(wndMain.channel01.FFTOnOff)
                     {
                         uint r = COLOR_R(render.colorChannel0);
@@ -2303,6 +2439,15 @@ void OsciloscopeManager::renderMain(uint threadId)
 
 int OsciloscopeManager::stop()
 {
+    //////////////////////////////////////////////////
+    // stats
+    //////////////////////////////////////////////////
+    if(settings.getSettings()->statsDump > 0)
+    {
+        FORMAT_BUFFER();
+        FORMAT_PATH("data/stats.json");
+        stats.dump(formatBuffer, getCtx());
+    }
     //////////////////////////////////////////////////
     // cleanup
     //////////////////////////////////////////////////
@@ -2468,17 +2613,24 @@ bool OsciloscopeManager::onApplicationIdle()
         renderData.etsAttr           = 0;
         renderData.flags.bit(rfClearRenderTarget,clearRenderTarget);
         SDL_AtomicUnlock(&renderLock);
-        // lock
+        // wait for a slot filled by the generate thread
+        OscThreadLoop& loop = pOsciloscope->threadLoop;
         uint renderId = 0;
         bool ret = false;
+        stats.depth(pqReady, loop.ready.getCount());
         while(!ret)
         {
-            ret = pOsciloscope->threadLoop.update.consumerLock(renderId, false);
+            ret = loop.ready.pop(renderId);
             if(ret)
             {
+                ularge handoff = SDL_GetPerformanceCounter() - loop.readyTime[renderId];
+                SDL_AtomicSet(&handoffLatency, int(handoff * 1000000 / SDL_GetPerformanceFrequency()));
+                stats.end(psHandoff, loop.readyTime[renderId]);
                 pTimer->deltaTime(TIMER_RENDER);
                 // render
+                ularge drawStart = stats.begin();
                 renderMain(renderId);
+                stats.end(psDraw, drawStart);
                 if( SDL_AtomicGet(&pOsciloscope->captureBuffer->drawState) == DRAWSTATE_FILL)
                   SDL_AtomicSet(&pOsciloscope->captureBuffer->drawState, DRAWSTATE_DRAW);
 
@@ -2488,16 +2640,13 @@ bool OsciloscopeManager::onApplicationIdle()
                 window.measure.data.history[MEASURE_HISTORY_MINIMUM].Minimum(measureData[renderId].history[MEASURE_HISTORY_CURRENT]);
                 window.measure.data.history[MEASURE_HISTORY_MAXIMUM].Maximum(measureData[renderId].history[MEASURE_HISTORY_CURRENT]);
                 window.measure.data.history[MEASURE_HISTORY_AVERAGE].Average(measureData[renderId].history[MEASURE_HISTORY_CURRENT]);
-                // unlock
-                pOsciloscope->threadLoop.update.consumerUnlock(renderId);
+                // give the slot back
+                loop.free.push(renderId);
                 return true;
             }
             else
             {
-                if(settings.getSettings()->delayRender > 0)
-                {
-                    SDL_Delay(settings.getSettings()->delayRender);
-                }
+                loop.ready.wait(HANDOFF_WAIT_MS);
             }
         }
     }
@@ -3328,8 +3477,22 @@ void OsciloscopeManager::allocate()
     pOsciloscope->sizeHardwareCapture = settings.getSettings()->memoryFrame * MEGABYTE;
     pOsciloscope->ptrHardwareCapture  = (byte*)pMemory->allocate(pOsciloscope->sizeHardwareCapture);
     SDL_memset(pOsciloscope->ptrHardwareCapture, 0, pOsciloscope->sizeHardwareCapture);
-    // allocate capture buffer
-    byte* display = (byte*)pMemory->allocate(SCOPEFUN_FRAME_MEMORY);
+    // allocate capture buffer, lazy mode only reserves address space and lets the os back pages on first touch
+    uint  lazy    = settings.getSettings()->memoryLazy;
+    byte* display = 0;
+    if(lazy)
+    {
+        display = (byte*)mapReserve(SCOPEFUN_FRAME_MEMORY);
+        if(display && mapCommit(display, 0, SCOPEFUN_FRAME_MEMORY) != PUREMAP_SUCCESS)
+        {
+            mapUnreserve(display, SCOPEFUN_FRAME_MEMORY);
+            display = 0;
+        }
+    }
+    if(!display)
+    {
+        display = (byte*)pMemory->allocate(SCOPEFUN_FRAME_MEMORY);
+    }
     byte* rld = 0;
     if(settings.getSettings()->memoryRld)
     {
@@ -3337,19 +3500,27 @@ void OsciloscopeManager::allocate()
     }
     captureBuffer = new CaptureBuffer(display, SCOPEFUN_FRAME_MEMORY, rld, settings.getSettings()->memoryRld * MEGABYTE);
     // display
-    uint toAllocateDisplay = settings.getSettings()->historyFrameDisplay * sizeof(OsciloscopeFrame);
-    pTmpData = (OsciloscopeFrame*)pMemory->allocate(toAllocateDisplay);
-    tmpHistory.init((OsciloscopeFrame*)pTmpData, settings.getSettings()->historyFrameDisplay);
-    // threads
-    for(uint i = 0; i < MAX_THREAD; i++)
-    {
-        uint toAllocate = settings.getSettings()->historyFrameDisplay * sizeof(OsciloscopeFrame);
-        OsciloscopeFrame* pThreadHistory = (OsciloscopeFrame*)pMemory->allocate(toAllocate);
-        captureData[i].history.init(pThreadHistory, settings.getSettings()->historyFrameDisplay);
-    }
+    uint toAllocateDisplay = settings.getSettings()->historyFrameDisplay * sizeof(FrameSnapshot*);
+    pTmpData = (FrameSnapshot**)pMemory->allocate(toAllocateDisplay);
+    tmpHistory.init(pTmpData, settings.getSettings()->historyFrameDisplay);
+    // snapshots, history plus frame being published plus frame held by renderer
+    uint snapshotCount = settings.getSettings()->historyFrameDisplay + 2;
+    pSnapshotData = (FrameSnapshot*)pMemory->allocate(snapshotCount * sizeof(FrameSnapshot));
+    snapshotPool.init(pSnapshotData, snapshotCount);
+    // decoded history frames for play and pause
+    historyCache.init(HISTORY_CACHE_SIZE);
     // how much memory is still available
     ularge        min = MINIMUM_HISTORY_COUNT * sizeof(CapturePacket);
-    ularge       free = pMemory->maximum(min, MAXIMUM_HISTORY_SIZE);
+    ularge       free = 0;
+    if(lazy)
+    {
+        // ask the os instead of probing with malloc, keep half for everything else
+        free = clamp<ularge>(mapMemoryAvailable() / 2, min, MAXIMUM_HISTORY_SIZE);
+    }
+    else
+    {
+        free = pMemory->maximum(min, MAXIMUM_HISTORY_SIZE);
+    }
     ularge        max = settings.getSettings()->memoryHistory * MEGABYTE;
     if(max == 0)
     {
@@ -3357,8 +3528,29 @@ void OsciloscopeManager::allocate()
     }
     ularge toAllocate = clamp(free, min, max);
     // history
-    byte* pPacketData = (byte*)pMemory->allocate(toAllocate);
-    captureBuffer->historyMemory.init(pPacketData, toAllocate, window.storage.getPacketSize());
+    byte* pPacketData = 0;
+    if(lazy)
+    {
+        // reserve only, pages are committed as history fills, halve when address space is short
+        while(!pPacketData && toAllocate >= min)
+        {
+            pPacketData = (byte*)mapReserve(toAllocate);
+            if(!pPacketData)
+            {
+                toAllocate = toAllocate >> 1;
+            }
+        }
+    }
+    if(pPacketData)
+    {
+        captureBuffer->historyMemory.init(pPacketData, toAllocate, window.storage.getPacketSize(), 1);
+    }
+    else
+    {
+        toAllocate  = clamp(free, min, max);
+        pPacketData = (byte*)pMemory->allocate(toAllocate);
+        captureBuffer->historyMemory.init(pPacketData, toAllocate, window.storage.getPacketSize());
+    }
     // memory
     captureBuffer->setMemory();
     // settings
@@ -3369,13 +3561,14 @@ void OsciloscopeManager::allocate()
 void OsciloscopeManager::deallocate()
 {
     captureBuffer->historySSD.freeInterfaceMemory();
+    captureBuffer->historyMapped.release();
+    captureBuffer->historyMapped.freeInterfaceMemory();
     captureBuffer->historyMemory.freeInterfaceMemory();
     captureBuffer->historyMemory.freePacketMemory();
     pMemory->free(pTmpData);
-    for(uint i = 0; i < MAX_THREAD; i++)
-    {
-        pMemory->free(captureData[i].history.getData());
-    }
+    pMemory->free(pSnapshotData);
+    historyCache.release();
+    ets.release();
 }
 
 void OsciloscopeManager::setThreadPriority(ThreadID id)
@@ -3536,12 +3729,67 @@ void OsciloscopeManager::setupControl(WndMain window)
 // ETS
 //
 ////////////////////////////////////////////////////////////////////////////////
+OsciloscopeETS::OsciloscopeETS()
+{
+    for(int i = 0; i < ETS_SLOTS; i++)
+    {
+        slot[i].used  = 0;
+        slot[i].ets   = 0;
+        slot[i].index   = ETS_UNKNOWN;
+        slot[i].raw     = 0;
+        slot[i].rawSize = 0;
+        slot[i].rawRead = 0;
+        order[i]        = 0;
+    }
+    for(int i = 0; i < ETS_TAGS; i++)
+    {
+        tag[i].index    = ETS_UNKNOWN;
+        tag[i].etsIndex = 0;
+        tag[i].ets      = 0;
+    }
+    count    = 0;
+    etsIndex = 0;
+    etsAttr  = 0;
+    SDL_AtomicSet(&reused, 0);
+    SDL_AtomicSet(&redecoded, 0);
+    SDL_AtomicSet(&reread, 0);
+}
+
+void OsciloscopeETS::release()
+{
+    for(int i = 0; i < ETS_SLOTS; i++)
+    {
+        pMemory->free(slot[i].raw);
+        slot[i].raw     = 0;
+        slot[i].rawSize = 0;
+        slot[i].rawRead = 0;
+    }
+    reset();
+}
+
 void OsciloscopeETS::clear()
 {
-    etsHistory.clear();
+    for(int i = 0; i < ETS_SLOTS; i++)
+    {
+        slot[i].used = 0;
+    }
+    count    = 0;
     etsIndex = 0;
 }
 
+void OsciloscopeETS::reset()
+{
+    clear();
+    for(int i = 0; i < ETS_SLOTS; i++)
+    {
+        slot[i].index = ETS_UNKNOWN;
+    }
+    for(int i = 0; i < ETS_TAGS; i++)
+    {
+        tag[i].index = ETS_UNKNOWN;
+    }
+}
+
 void OsciloscopeETS::redraw(OsciloscopeRenderData& render,SDL_atomic_t* redrawEts)
 {
    if (SDL_AtomicGet(redrawEts) == 12)
@@ -3556,28 +3804,213 @@ void OsciloscopeETS::redraw(OsciloscopeRenderData& render,SDL_atomic_t* redrawEt
    }
    if (SDL_AtomicGet(redrawEts) == 1)
    {
-      etsIndex = etsHistory.getCount() - 1;
+      etsIndex = count - 1;
       etsIndex = max(0U, etsIndex);
       SDL_AtomicSet(redrawEts, 2);
       render.flags.bit(rfClearRenderTarget, 1);
    }
 }
 
-void OsciloscopeETS::onFrameChange(int framechange, Ring<CapturePacket> threadHistory, OsciloscopeRenderData& render)
+int OsciloscopeETS::findSlot(uint ets)
+{
+    for(int i = 0; i < ETS_SLOTS; i++)
+    {
+        if(slot[i].used && slot[i].ets == ets)
+        {
+            return i;
+        }
+    }
+    return -1;
+}
+
+int OsciloscopeETS::freeSlot(uint* claimed)
+{
+    // an empty slot first, else one the rebuild has not claimed
+    for(int i = 0; i < ETS_SLOTS; i++)
+    {
+        if(!slot[i].used)
+        {
+            return i;
+        }
+    }
+    for(int i = 0; i < ETS_SLOTS; i++)
+    {
+        if(claimed && !claimed[i])
+        {
+            return i;
+        }
+    }
+    return -1;
+}
+
+void OsciloscopeETS::keepRaw(OsciloscopeETSSlot& s, byte* data, ularge size)
+{
+    // very large frames are read from history again instead
+    s.rawRead = 0;
+    if(size > ETS_RAW_MAX)
+    {
+        return;
+    }
+    if(size > s.rawSize)
+    {
+        pMemory->free(s.raw);
+        s.raw     = (byte*)pMemory->allocate(size);
+        s.rawSize = s.raw ? size : 0;
+    }
+    if(s.raw)
+    {
+        SDL_memcpy(s.raw, data, size);
+        s.rawRead = size;
+    }
+}
+
+int OsciloscopeETS::findTag(ularge index, CaptureFrame& capture, uint etsIndex)
+{
+    OsciloscopeETSTag& t = tag[index % ETS_TAGS];
+    if(t.index == index && t.etsIndex == etsIndex && t.capture.equal(capture))
+    {
+        return int(t.ets);
+    }
+    return -1;
+}
+
+void OsciloscopeETS::setTag(ularge index, CaptureFrame& capture, uint etsIndex, uint ets)
+{
+    OsciloscopeETSTag& t = tag[index % ETS_TAGS];
+    t.index    = index;
+    t.capture  = capture;
+    t.etsIndex = etsIndex;
+    t.ets      = ets;
+}
+
+void OsciloscopeETS::toBack(uint id)
+{
+    for(uint i = 0; i < count; i++)
+    {
+        if(order[i] == id)
+        {
+            for(uint j = i + 1; j < count; j++)
+            {
+                order[j - 1] = order[j];
+            }
+            order[count - 1] = id;
+            break;
+        }
+    }
+}
+
+void OsciloscopeETS::onFrameChange(ularge framechange, OsciloscopeRenderData& render)
 {
-    // return;
     render.flags.raise(rfClearRenderTarget);
-    // ets, display
-    clear();
-    // frame
+    etsAttr  = 0;
+    etsIndex = 0;
+    CaptureBuffer* buffer = pOsciloscope->captureBuffer;
+    uint generation = key.generation;
+    buffer->displayKey(key);
+    // history was cleared or loaded, frames of the old one can look exactly like the new ones
+    if(key.generation != generation)
+    {
+        reset();
+    }
+    // newest frame of each ets offset in the window wins, older ones are only read when their offset is not known yet
+    uint   limit  = min<uint>(ETS_SLOTS, pOsciloscope->settings.getSettings()->historyFrameCount);
+    uint   claimed[ETS_SLOTS] = { 0 };
+    uint   claimedCount = 0;
+    int    reuse  = 0;
+    int    decode = 0;
+    int    read   = 0;
+    ularge first  = framechange > ETS_SLOTS ? framechange - ETS_SLOTS : 0;
     CaptureFrame frame;
-    for(int i = max<int>(0, framechange - 32); i < framechange; i++)
+    for(ularge i = framechange; i > first && claimedCount < limit; i--)
+    {
+        ularge index = i - 1;
+        buffer->captureFrame(frame, index);
+        int ets = findTag(index, frame, key.etsIndex);
+        int id  = ets >= 0 ? findSlot(uint(ets)) : -1;
+        if(id >= 0)
+        {
+            if(claimed[id])
+            {
+                continue;
+            }
+            OsciloscopeETSSlot& s = slot[id];
+            if(s.index == index && s.capture.equal(frame))
+            {
+                // same history frame, a display change only decodes the raw frame again
+                uint valid = 1;
+                if(s.key.equal(key))
+                {
+                    reuse++;
+                }
+                else if(s.rawRead && buffer->display(s.frame, s.raw, s.rawRead, key, frame.version, frame.header, frame.data, frame.packet))
+                {
+                    s.key = key;
+                    decode++;
+                }
+                else
+                {
+                    valid = 0;
+                }
+                if(valid)
+                {
+                    claimed[id] = 1;
+                    claimedCount++;
+                    continue;
+                }
+            }
+        }
+        buffer->historyRead(frame, frame.version, frame.header, frame.data, frame.packet);
+        if(!buffer->display(oscFrame, frame.version, frame.header, frame.data, frame.packet))
+        {
+            continue;
+        }
+        read++;
+        setTag(index, frame, key.etsIndex, oscFrame.ets);
+        id = findSlot(oscFrame.ets);
+        if(id >= 0 && claimed[id])
+        {
+            continue;
+        }
+        if(id < 0)
+        {
+            id = freeSlot(claimed);
+        }
+        if(id < 0)
+        {
+            continue;
+        }
+        OsciloscopeETSSlot& s = slot[id];
+        s.used    = 1;
+        s.ets     = oscFrame.ets;
+        s.index   = index;
+        s.capture = frame;
+        s.key     = key;
+        s.frame   = oscFrame;
+        keepRaw(s, buffer->displayPtr, buffer->displayRead);
+        claimed[id] = 1;
+        claimedCount++;
+    }
+    // replay order is the order the frames were captured in
+    count = 0;
+    for(uint id = 0; id < ETS_SLOTS; id++)
     {
-        pOsciloscope->captureBuffer->captureFrame(frame, i);
-        pOsciloscope->captureBuffer->historyRead(frame, frame.version, frame.header, frame.data, frame.packet);
-        pOsciloscope->captureBuffer->display(oscFrame, frame.version, frame.header, frame.data, frame.packet);
-        onCapture(oscFrame, render);
+        slot[id].used = claimed[id];
+        if(!claimed[id])
+        {
+            continue;
+        }
+        uint pos = count++;
+        while(pos > 0 && slot[order[pos - 1]].index > slot[id].index)
+        {
+            order[pos] = order[pos - 1];
+            pos--;
+        }
+        order[pos] = id;
     }
+    SDL_AtomicAdd(&reused, reuse);
+    SDL_AtomicAdd(&redecoded, decode);
+    SDL_AtomicAdd(&reread, read);
+    render.etsAttr = etsAttr;
     redraw(render,&pOsciloscope->etsClear);
 }
 
@@ -3587,21 +4020,32 @@ void OsciloscopeETS::onCapture(OsciloscopeFrame& frame, OsciloscopeRenderData& r
     etsAttr  = 0;
     etsIndex = 0;
     // frame to clear
-    for(int i = 0; i < etsHistory.getCount(); i++)
+    int id = findSlot(frame.ets);
+    if(id >= 0)
     {
-        if(frame.ets == etsHistory[i].ets)
+        OsciloscopeETSSlot& s = slot[id];
+        // a replayed slot frame keeps the history frame it came from
+        etsClear = s.frame;
+        etsAttr  = ETS_CLEAR;
+        if(s.frame.thisFrame != frame.thisFrame)
         {
-            etsClear = etsHistory[i];
-            etsHistory.remove(i);
-            etsAttr = ETS_CLEAR;
-            break;
+            s.index   = ETS_UNKNOWN;
+            s.rawRead = 0;
+            s.frame   = frame;
         }
+        toBack(id);
     }
-    // add frames
-    if(etsHistory.getCount() < etsHistory.getSize() &&
-       etsHistory.getCount() < (int)pOsciloscope->settings.getSettings()->historyFrameCount)
+    else if(count < ETS_SLOTS && count < pOsciloscope->settings.getSettings()->historyFrameCount)
     {
-        etsHistory.pushBack(frame);
+        // every used slot is in the order list, so an empty one is left
+        id = freeSlot(0);
+        OsciloscopeETSSlot& s = slot[id];
+        s.used    = 1;
+        s.ets     = frame.ets;
+        s.index   = ETS_UNKNOWN;
+        s.rawRead = 0;
+        s.frame   = frame;
+        order[count++] = id;
     }
     render.etsAttr = etsAttr;
 }
@@ -3611,17 +4055,216 @@ void OsciloscopeETS::onPause(OsciloscopeFrame& frame, WndMain& window)
     if(window.horizontal.ETS)
     {
         etsAttr = 0;
-        if(etsHistory.getCount())
+        if(count)
         {
-            if(etsIndex >= 0 && etsIndex < (uint)etsHistory.getCount())
+            if(etsIndex >= 0 && etsIndex < count)
             {
-                frame = etsHistory[etsIndex];
+                frame = slot[order[etsIndex]].frame;
                 etsIndex--;
             }
         }
     }
 }
 
+////////////////////////////////////////////////////////////////////////////////
+//
+// FrameSnapshotPool
+//
+////////////////////////////////////////////////////////////////////////////////
+FrameSnapshotPool::FrameSnapshotPool()
+{
+    snapshot = 0;
+    count    = 0;
+    next     = 0;
+}
+
+void FrameSnapshotPool::init(FrameSnapshot* memory, uint icount)
+{
+    snapshot = memory;
+    count    = icount;
+    next     = 0;
+    for(uint i = 0; i < count; i++)
+    {
+        SDL_AtomicSet(&snapshot[i].refCount, 0);
+    }
+}
+
+FrameSnapshot* FrameSnapshotPool::acquire()
+{
+    for(uint i = 0; i < count; i++)
+    {
+        uint idx = (next + i) % count;
+        if(SDL_AtomicCAS(&snapshot[idx].refCount, 0, 1))
+        {
+            next = (idx + 1) % count;
+            return &snapshot[idx];
+        }
+    }
+    return 0;
+}
+
+void FrameSnapshotPool::retain(FrameSnapshot* frame)
+{
+    SDL_AtomicIncRef(&frame->refCount);
+}
+
+void FrameSnapshotPool::release(FrameSnapshot* frame)
+{
+    SDL_AtomicAdd(&frame->refCount, -1);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//
+// PipelineStats
+//
+////////////////////////////////////////////////////////////////////////////////
+PipelineStats::PipelineStats()
+{
+    SDL_memset(this, 0, sizeof(PipelineStats));
+}
+
+void PipelineStats::end(EPipelineStage s, ularge start, ularge bytes)
+{
+    ularge us = (SDL_GetPerformanceCounter() - start) * 1000000 / SDL_GetPerformanceFrequency();
+    record(s, uint(min<ularge>(us, 0xFFFFFFFF)), bytes);
+}
+
+void PipelineStats::record(EPipelineStage s, uint us, ularge bytes)
+{
+    PipelineStageStats& st = stage[s];
+    if(SDL_AtomicGet(&st.clear))
+    {
+        sfLatencyClear(&st.latency);
+        st.bytes   = 0;
+        st.dropped = 0;
+        SDL_AtomicSet(&st.clear, 0);
+    }
+    sfLatencyRecord(&st.latency, us);
+    st.bytes += bytes;
+}
+
+void PipelineStats::drop(EPipelineStage s, uint count)
+{
+    stage[s].dropped += count;
+}
+
+void PipelineStats::depth(EPipelineQueue q, uint idepth)
+{
+    PipelineQueueStats& qs = queue[q];
+    if(SDL_AtomicGet(&qs.clear))
+    {
+        qs.max     = 0;
+        qs.samples = 0;
+        qs.sum     = 0;
+        SDL_AtomicSet(&qs.clear, 0);
+    }
+    qs.depth = idepth;
+    qs.max   = max(qs.max, idepth);
+    qs.samples++;
+    qs.sum += idepth;
+}
+
+void PipelineStats::clear()
+{
+    for(int i = 0; i < psLast; i++)
+    {
+        SDL_AtomicSet(&stage[i].clear, 1);
+    }
+    for(int i = 0; i < pqLast; i++)
+    {
+        SDL_AtomicSet(&queue[i].clear, 1);
+    }
+}
+
+const char* PipelineStats::stageName(EPipelineStage s)
+{
+    static const char* name[psLast] = { "capture", "uncompress", "historyWrite", "historyRead", "display", "generate", "render", "latency", "handoff", "draw" };
+    return name[s];
+}
+
+const char* PipelineStats::queueName(EPipelineQueue q)
+{
+    static const char* name[pqLast] = { "captured", "ready", "free" };
+    return name[q];
+}
+
+cJSON* latencyToJson(SLatency& latency)
+{
+    cJSON* json = cJSON_CreateObject();
+    double percentile[] = { 50.0, 90.0, 99.0, 99.9 };
+    const char* name[]  = { "p50", "p90", "p99", "p999" };
+    cJSON_AddItemToObject(json, "count", cJSON_CreateNumber(double(latency.count)));
+    cJSON_AddItemToObject(json, "mean", cJSON_CreateNumber(latency.count ? double(latency.sum) / double(latency.count) : 0.0));
+    for(int i = 0; i < 4; i++)
+    {
+        int us = 0;
+        sfLatencyPercentile(&latency, percentile[i], &us);
+        cJSON_AddItemToObject(json, name[i], cJSON_CreateNumber(us));
+    }
+    cJSON_AddItemToObject(json, "max", cJSON_CreateNumber(latency.max));
+    return json;
+}
+
+int PipelineStats::dump(const char* path, SFContext* ctx)
+{
+    // copy, writers keep running
+    PipelineStats* copy = (PipelineStats*)pMemory->allocate(sizeof(PipelineStats));
+    SDL_memcpy(copy, this, sizeof(PipelineStats));
+    cJSON* jsonRoot   = cJSON_CreateObject();
+    cJSON* jsonStages = cJSON_CreateObject();
+    cJSON* jsonQueues = cJSON_CreateObject();
+    cJSON_AddItemToObject(jsonRoot, "stages", jsonStages);
+    cJSON_AddItemToObject(jsonRoot, "queues", jsonQueues);
+    for(int i = 0; i < psLast; i++)
+    {
+        PipelineStageStats& st = copy->stage[i];
+        cJSON* json = latencyToJson(st.latency);
+        cJSON_AddItemToObject(json, "bytes", cJSON_CreateNumber(double(st.bytes)));
+        cJSON_AddItemToObject(json, "dropped", cJSON_CreateNumber(double(st.dropped)));
+        cJSON_AddItemToObject(jsonStages, stageName(EPipelineStage(i)), json);
+    }
+    for(int i = 0; i < pqLast; i++)
+    {
+        PipelineQueueStats& qs = copy->queue[i];
+        cJSON* json = cJSON_CreateObject();
+        cJSON_AddItemToObject(json, "depth", cJSON_CreateNumber(qs.depth));
+        cJSON_AddItemToObject(json, "max", cJSON_CreateNumber(qs.max));
+        cJSON_AddItemToObject(json, "mean", cJSON_CreateNumber(qs.samples ? double(qs.sum) / double(qs.samples) : 0.0));
+        cJSON_AddItemToObject(jsonQueues, queueName(EPipelineQueue(i)), json);
+    }
+    HistoryCache& cache = pOsciloscope->historyCache;
+    cJSON* jsonCache = cJSON_CreateObject();
+    cJSON_AddItemToObject(jsonCache, "hits", cJSON_CreateNumber(SDL_AtomicGet(&cache.hits)));
+    cJSON_AddItemToObject(jsonCache, "misses", cJSON_CreateNumber(SDL_AtomicGet(&cache.misses)));
+    cJSON_AddItemToObject(jsonCache, "prefetched", cJSON_CreateNumber(SDL_AtomicGet(&cache.prefetched)));
+    cJSON_AddItemToObject(jsonRoot, "historyCache", jsonCache);
+    cJSON* jsonEts = cJSON_CreateObject();
+    cJSON_AddItemToObject(jsonEts, "reused", cJSON_CreateNumber(SDL_AtomicGet(&pOsciloscope->ets.reused)));
+    cJSON_AddItemToObject(jsonEts, "redecoded", cJSON_CreateNumber(SDL_AtomicGet(&pOsciloscope->ets.redecoded)));
+    cJSON_AddItemToObject(jsonEts, "reread", cJSON_CreateNumber(SDL_AtomicGet(&pOsciloscope->ets.reread)));
+    cJSON_AddItemToObject(jsonRoot, "ets", jsonEts);
+    if(ctx)
+    {
+        SCaptureStats api;
+        sfGetCaptureStats(ctx, &api);
+        cJSON* json = latencyToJson(api.latency);
+        cJSON_AddItemToObject(json, "calls", cJSON_CreateNumber(double(api.calls)));
+        cJSON_AddItemToObject(json, "empty", cJSON_CreateNumber(double(api.empty)));
+        cJSON_AddItemToObject(json, "bytes", cJSON_CreateNumber(double(api.bytes)));
+        cJSON_AddItemToObject(jsonRoot, "api", json);
+    }
+    pMemory->free(copy);
+    int   ret = 1;
+    char* jsonString = cJSON_Print(jsonRoot);
+    if(jsonString)
+    {
+        ret = fileSaveString(path, jsonString);
+        pMemory->free(jsonString);
+    }
+    cJSON_Delete(jsonRoot);
+    return ret;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 //
 // CaptureThread
@@ -3636,46 +4279,72 @@ void SendToRenderer(OsciloscopeFrame& captureFrame,
                     OsciloscopeThreadData& captureData, uint delay)
 {
     pTimer->deltaTime(TIMER_CAPTURE);
+    PipelineStats& stats = pOsciloscope->stats;
     SDL_AtomicLock(&pOsciloscope->displayLock);
     pOsciloscope->display = captureFrame;
     SDL_AtomicUnlock(&pOsciloscope->displayLock);
-    // history
-    pOsciloscope->tmpHistory.write(captureFrame);
+    // history, the frame is copied once into an immutable snapshot
+    FrameSnapshotPool&    pool = pOsciloscope->snapshotPool;
+    Ring<FrameSnapshot*>& tmp  = pOsciloscope->tmpHistory;
+    FrameSnapshot*  snapshot   = pool.acquire();
+    if(snapshot)
+    {
+        stats.stage[psGenerate].bytes += sizeof(OsciloscopeFrame);
+        snapshot->frame = captureFrame;
+        if(tmp.isFull())
+        {
+            pool.release(*tmp.peek(tmp.getRead()));
+        }
+        tmp.write(snapshot);
+    }
     // ets
     ets.onCapture(captureFrame, render);
     // send to renderer
+    OscThreadLoop& loop = pOsciloscope->threadLoop;
     uint captureId = 0;
     bool ret = false;
+    stats.depth(pqFree, loop.free.getCount());
     while(!ret && pOsciloscope->captureDataThreadActive)
     {
-        ret = pOsciloscope->threadLoop.update.producerLock(captureId, false);
+        ret = loop.free.pop(captureId);
         if(ret)
         {
-            Ring<OsciloscopeFrame> history = pOsciloscope->tmpHistory;
-            OsciloscopeFrame       frame;
-            uint count = history.getCount();
+            // drop references from previous render
+            FrameSnapshot* held = 0;
+            while(!captureData.history.isEmpty())
+            {
+                captureData.history.read(held);
+                pool.release(held);
+            }
             captureData.history.clear();
+            // hand over references
+            Ring<FrameSnapshot*> history = tmp;
+            uint count = history.getCount();
             for(uint i = 0; i < count; i++)
             {
-                history.read(frame);
-                captureData.history.write(frame);
+                history.read(held);
+                pool.retain(held);
+                captureData.history.write(held);
             }
+            pOsciloscope->historySaved += ularge(count) * (sizeof(OsciloscopeFrame) - sizeof(FrameSnapshot*));
+            SDL_AtomicSet(&pOsciloscope->historyNotCopied, int(pOsciloscope->historySaved / MEGABYTE));
             captureData.etsClear = ets.etsClear;
-            captureData.frame    = frame;
+            captureData.frame    = captureFrame;
             captureData.render   = render;
             captureData.window   = window;
+            stats.stage[psGenerate].bytes += 2 * sizeof(OsciloscopeFrame);
             // render
             renderer.clearFast();
             fft.clear();
+            ularge renderStart = stats.begin();
             pOsciloscope->renderThread(captureId, captureData, renderer, fft);
-            pOsciloscope->threadLoop.update.producerUnlock(captureId);
+            stats.end(psRender, renderStart);
+            loop.readyTime[captureId] = SDL_GetPerformanceCounter();
+            loop.ready.push(captureId);
         }
         else
         {
-            if(delay > 0)
-            {
-                SDL_Delay(delay);
-            }
+            loop.free.wait(HANDOFF_WAIT_MS);
         }
     }
 }
@@ -3691,6 +4360,7 @@ int SDLCALL CaptureDataThreadFunction(void* data)
     uint frameDataSize = 0;
     float mbTimer   = 0;
     uint  bandWidth = 0;
+    PipelineStats& stats = pOsciloscope->stats;
     SDL_MemoryBarrierAcquire();
     while(pOsciloscope->captureDataThreadActive)
     {
@@ -3723,6 +4393,12 @@ int SDLCALL CaptureDataThreadFunction(void* data)
         {
             if(received == frameSize)
             {
+                // wake generate thread
+                if(frameSize > 0)
+                {
+                    uint frameIndex = pOsciloscope->captureBuffer->captureFrameLast();
+                    pOsciloscope->threadLoop.captured.push(frameIndex);
+                }
                 // local simulation ?
                 if(isSimulation && !isConnected)
                 {
@@ -3740,6 +4416,16 @@ int SDLCALL CaptureDataThreadFunction(void* data)
                     uint mb = double(bandWidth) / mbTimer;
                     mb = mb / (1024 * 1024);
                     SDL_AtomicSet(&pOsciloscope->bandWidth, mb);
+                    // rle decoder throughput, decoded bytes per second spent decoding
+                    CaptureBuffer* pCapture = pOsciloscope->captureBuffer;
+                    uint rle = 0;
+                    if(pCapture->rldTime > 0.0)
+                    {
+                        rle = uint((double(pCapture->rldDecoded) / pCapture->rldTime) / (1024 * 1024));
+                    }
+                    SDL_AtomicSet(&pOsciloscope->rleBandWidth, rle);
+                    pCapture->rldDecoded = 0;
+                    pCapture->rldTime    = 0;
                     mbTimer   = 0.f;
                     bandWidth = 0;
                 }
@@ -3748,6 +4434,7 @@ int SDLCALL CaptureDataThreadFunction(void* data)
             }
             if(received > frameSize && frameSize > 0)
             {
+                stats.drop(psCapture, 1);
                 received = 0;
                 frameSize = 0;
             }
@@ -3755,9 +4442,11 @@ int SDLCALL CaptureDataThreadFunction(void* data)
             {
                 // capture
                 int transfered = 0;
+                ularge start = stats.begin();
                 int  ret = pOsciloscope->thread.captureFrameData( (SFrameData*)(buffer), headerSize, &transfered, SCOPEFUN_CAPTURE_TYPE_HEADER);
                 if(transfered > 0)
                 {
+                    stats.end(psCapture, start, transfered);
                     // just for testing saving control bits in the header till this is done properly in firmware
                     if(pOsciloscope->settings.getSettings()->windowDebug == 2 && int(received) + transfered >= headerSize)
                     {
@@ -3787,8 +4476,12 @@ int SDLCALL CaptureDataThreadFunction(void* data)
                         pOsciloscope->captureBuffer->uncompressNew();
                     }
                     // samples uncompress
+                    start = stats.begin();
                     pOsciloscope->captureBuffer->uncompress(buffer, received, transfered, version, headerSize, maxData, packetSize, received == 0);
+                    stats.end(psUncompress, start, transfered);
+                    start = stats.begin();
                     pOsciloscope->captureBuffer->historyWrite(0, version, headerSize, maxData, packetSize, received == 0);
+                    stats.end(psHistoryWrite, start, transfered);
                     received += transfered;
                     // frame size
                     frameDataSize = pOsciloscope->captureBuffer->getFrameDataSize(buffer, version, headerSize, maxData, packetSize);
@@ -3815,12 +4508,18 @@ int SDLCALL CaptureDataThreadFunction(void* data)
 
                 // capture
                 int transfered = 0;
+                ularge start = stats.begin();
                 int  ret = pOsciloscope->thread.captureFrameData( (SFrameData*)(buffer), toReceive, &transfered, SCOPEFUN_CAPTURE_TYPE_DATA);
                 if(transfered > 0)
                 {
+                    stats.end(psCapture, start, transfered);
                     // samples uncompress
+                    start = stats.begin();
                     pOsciloscope->captureBuffer->uncompress(buffer, received, transfered, version, frameDataSize, frameSize, packetSize, false);
+                    stats.end(psUncompress, start, transfered);
+                    start = stats.begin();
                     pOsciloscope->captureBuffer->historyWrite(frameSize, version, headerSize, frameDataSize, packetSize, false);
+                    stats.end(psHistoryWrite, start, transfered);
                     received += transfered;
                 }
                 else
@@ -3836,6 +4535,7 @@ int SDLCALL CaptureDataThreadFunction(void* data)
     }
     SDL_MemoryBarrierRelease();
     pMemory->free(buffer);
+    pMemory->threadFlush();
     return 0;
 }
 
@@ -3858,8 +4558,8 @@ int SDLCALL GenerateFrameThreadFunction(void* data)
     OsciloscopeThreadRenderer renderer;
     OsciloscopeFFT            fft;
     OsciloscopeThreadData* pCaptureData = (OsciloscopeThreadData*)new OsciloscopeThreadData();
-    uint              toAllocate = pOsciloscope->settings.getSettings()->historyFrameDisplay * sizeof(OsciloscopeFrame);
-    OsciloscopeFrame* memory     = (OsciloscopeFrame*)pMemory->allocate(toAllocate);
+    uint              toAllocate = pOsciloscope->settings.getSettings()->historyFrameDisplay * sizeof(FrameSnapshot*);
+    FrameSnapshot**   memory     = (FrameSnapshot**)pMemory->allocate(toAllocate);
     pCaptureData->history.init(memory, pOsciloscope->settings.getSettings()->historyFrameDisplay);
     fft.init();
     renderer.init(pOsciloscope->settings.getSettings()->historyFrameDisplay);
@@ -3868,8 +4568,28 @@ int SDLCALL GenerateFrameThreadFunction(void* data)
     ularge              playFrameIdx = 0;
     uint delayCapture = pOsciloscope->settings.getSettings()->delayCapture;
     int received = 0;
+    HistoryCache&  cache  = pOsciloscope->historyCache;
+    DisplayKey     displayKey;
+    OscThreadLoop& loop   = pOsciloscope->threadLoop;
+    PipelineStats& stats  = pOsciloscope->stats;
+    ularge idleStart      = SDL_GetPerformanceCounter();
+    ularge idleWaitTicks  = 0;
     while(pOsciloscope->generateFrameThreadActive)
     {
+        ularge loopStart = stats.begin();
+        ularge loopWait  = loop.captured.getWaitTicks() + loop.free.getWaitTicks();
+
+        // idle, share of time spent blocked on the capture and render handoff
+        ularge idleNow   = SDL_GetPerformanceCounter();
+        ularge idleDelta = idleNow - idleStart;
+        if(idleDelta > SDL_GetPerformanceFrequency())
+        {
+            ularge waitTicks = loop.captured.getWaitTicks() + loop.free.getWaitTicks();
+            SDL_AtomicSet(&pOsciloscope->generateIdle, int((waitTicks - idleWaitTicks) * 100 / idleDelta));
+            idleWaitTicks = waitTicks;
+            idleStart     = idleNow;
+        }
+
         // sync multiple capture threads
         SDL_AtomicLock(&pOsciloscope->captureLock);
 
@@ -3936,9 +4656,12 @@ int SDLCALL GenerateFrameThreadFunction(void* data)
                 case SIGNAL_MODE_CLEAR:
                     pOsciloscope->captureBuffer->clear();
                     captureFrame.clear();
+                    cache.clear();
                     break;
                 case SIGNAL_MODE_CAPTURE:
+                    cache.clear();
                     ets.clear();
+                    pOsciloscope->stats.clear();
                     captureFreq  = SDL_GetPerformanceFrequency();
                     captureStart = SDL_GetPerformanceCounter();
                     pTimer->init(TIMER_CAPTURE);
@@ -3946,6 +4669,7 @@ int SDLCALL GenerateFrameThreadFunction(void* data)
                     break;
                 case SIGNAL_MODE_SIMULATE:
                     ets.clear();
+                    pOsciloscope->stats.clear();
                     captureFreq  = SDL_GetPerformanceFrequency();
                     captureStart = SDL_GetPerformanceCounter();
                     pTimer->init(TIMER_CAPTURE);
@@ -3963,26 +4687,55 @@ int SDLCALL GenerateFrameThreadFunction(void* data)
         // mode
         ////////////////////////////////////////////////////////////////////
         SDL_MemoryBarrierAcquire();
+        pOsciloscope->captureBuffer->displayKey(displayKey);
+        cache.setKey(displayKey);
         switch(mode)
         {
             case SIGNAL_MODE_PLAY:
                 {
                     CaptureFrame cf;
-                    pOsciloscope->captureBuffer->captureFrame(cf, playFrameIdx);
-                    pOsciloscope->captureBuffer->historyRead(cf, cf.version, cf.header, cf.data, cf.packet);
+                    ularge frameIdx = playFrameIdx;
+                    pOsciloscope->captureBuffer->captureFrame(cf, frameIdx);
+                    if(!cache.lookup(frameIdx, cf, captureFrame))
+                    {
+                        ularge start = stats.begin();
+                        pOsciloscope->captureBuffer->historyRead(cf, cf.version, cf.header, cf.data, cf.packet);
+                        stats.end(psHistoryRead, start, cf.frameSize);
+                        start = stats.begin();
+                        uint displayed = pOsciloscope->captureBuffer->display(captureFrame, cf.version, cf.header, cf.data, cf.packet);
+                        stats.end(psDisplay, start);
+                        if(displayed)
+                        {
+                            cache.insert(frameIdx, cf, captureFrame, pOsciloscope->captureBuffer->displayPtr);
+                        }
+                    }
                     playFrameIdx++;
                     if(playFrameIdx >= pOsciloscope->captureBuffer->captureFrameCount())
                     {
                         playFrameIdx = 0;
                     }
+                    cache.predict(frameIdx, pOsciloscope->captureBuffer->captureFrameCount(), 1);
                     SDL_AtomicSet(&pOsciloscope->syncUI, 1);
-                    pOsciloscope->captureBuffer->display(captureFrame, cf.version, cf.header, cf.data, cf.packet);
                     SendToRenderer(captureFrame, captureWindow, captureRender, ets, renderer, fft, *pCaptureData, delayCapture);
                     break;
                 }
             case SIGNAL_MODE_SIMULATE:
             case SIGNAL_MODE_CAPTURE:
                 {
+                    // sleep until the capture thread completes a frame, the timeout keeps the user interface in sync
+                    uint captured = 0;
+                    uint popped   = 0;
+                    loop.captured.wait(CAPTURE_WAIT_MS);
+                    stats.depth(pqCaptured, loop.captured.getCount());
+                    while(loop.captured.pop(captured))
+                    {
+                        popped++;
+                    };
+                    // only the last completed frame is displayed
+                    if(popped > 1)
+                    {
+                        stats.drop(psGenerate, popped - 1);
+                    }
                     // frame
                     CaptureFrame cf;
                     int frameLast = pOsciloscope->captureBuffer->captureFrameLast();
@@ -3997,8 +4750,13 @@ int SDLCALL GenerateFrameThreadFunction(void* data)
                     // render
                     if(cf.frameSize > 0 && cf.packetCount > 1)
                     {
+                        ularge start = stats.begin();
                         pOsciloscope->captureBuffer->historyRead(cf, cf.version, cf.header, cf.data, cf.packet);
-                        if(pOsciloscope->captureBuffer->display(captureFrame, cf.version, cf.header, cf.data, cf.packet))
+                        stats.end(psHistoryRead, start, cf.frameSize);
+                        start = stats.begin();
+                        uint displayed = pOsciloscope->captureBuffer->display(captureFrame, cf.version, cf.header, cf.data, cf.packet);
+                        stats.end(psDisplay, start);
+                        if(displayed)
                         {
                             pOsciloscope->onCallibrateFrameCaptured(captureFrame, cf.version);
                         }
@@ -4012,11 +4770,24 @@ int SDLCALL GenerateFrameThreadFunction(void* data)
                     captureWindow.horizontal.Frame = min<uint>(captureWindow.horizontal.Frame, pOsciloscope->captureBuffer->captureFrameCount() - 1);
                     CaptureFrame cf;
                     pOsciloscope->captureBuffer->captureFrame(cf, captureWindow.horizontal.Frame);
-                    pOsciloscope->captureBuffer->historyRead(cf, cf.version, cf.header, cf.data, cf.packet);
-                    pOsciloscope->captureBuffer->display(captureFrame, cf.version, cf.header, cf.data, cf.packet);
-                    if(frame != captureWindow.horizontal.Frame)
+                    if(!cache.lookup(captureWindow.horizontal.Frame, cf, captureFrame))
+                    {
+                        ularge start = stats.begin();
+                        pOsciloscope->captureBuffer->historyRead(cf, cf.version, cf.header, cf.data, cf.packet);
+                        stats.end(psHistoryRead, start, cf.frameSize);
+                        start = stats.begin();
+                        uint displayed = pOsciloscope->captureBuffer->display(captureFrame, cf.version, cf.header, cf.data, cf.packet);
+                        stats.end(psDisplay, start);
+                        if(displayed)
+                        {
+                            cache.insert(captureWindow.horizontal.Frame, cf, captureFrame, pOsciloscope->captureBuffer->displayPtr);
+                        }
+                    }
+                    cache.predict(captureWindow.horizontal.Frame, pOsciloscope->captureBuffer->captureFrameCount(), 0);
+                    // timebase and position changes rebuild the ets view as well, unchanged slots are reused
+                    if(frame != captureWindow.horizontal.Frame || (captureWindow.horizontal.ETS && !ets.key.equal(displayKey)))
                     {
-                        ets.onFrameChange(captureWindow.horizontal.Frame, pOsciloscope->threadHistory, captureRender);
+                        ets.onFrameChange(captureWindow.horizontal.Frame, captureRender);
                         frame = captureWindow.horizontal.Frame;
                     }
                     ets.onPause(captureFrame, captureWindow);
@@ -4028,11 +4799,17 @@ int SDLCALL GenerateFrameThreadFunction(void* data)
         };
         SDL_MemoryBarrierRelease();
         SDL_AtomicUnlock(&pOsciloscope->captureLock);
+        // busy time of this loop, time blocked on the queues is left out
+        ularge loopTicks = stats.begin() - loopStart;
+        ularge waitTicks = loop.captured.getWaitTicks() + loop.free.getWaitTicks() - loopWait;
+        ularge loopUs    = (loopTicks - min(loopTicks, waitTicks)) * 1000000 / SDL_GetPerformanceFrequency();
+        stats.record(psGenerate, uint(min<ularge>(loopUs, 0xFFFFFFFF)));
         if(delayCapture > 0)
         {
             SDL_Delay(delayCapture);
         }
     }
+    pMemory->threadFlush();
     return 0;
 }
 
@@ -4043,9 +4820,10 @@ int SDLCALL ControlHardwareThreadFunction(void* data)
    while (pOsciloscope->controlHardwareThreadActive)
    {
       pOsciloscope->thread.update();
-      SDL_Delay(1);
+      pOsciloscope->thread.idle(THREAD_API_IDLE_MS);
    }
    SDL_MemoryBarrierRelease();
+   pMemory->threadFlush();
    return 0;
 }
 
@@ -93,6 +93,7 @@ public:
     ularge frameSize;
     ularge packetStart;
     ularge packetCount;
+    ularge time;
 public:
     CaptureFrame()
     {
@@ -103,9 +104,17 @@ public:
         frameSize = 0;
         packetStart = 0;
         packetCount = 0;
+        time = 0;
+    }
+    int equal(const CaptureFrame& frame)
+    {
+        return packetStart == frame.packetStart && packetCount == frame.packetCount && frameSize == frame.frameSize && time == frame.time;
     }
 };
 
+// frame as stored in the old .osc layout, everything up to time
+#define CAPTURE_FRAME_LEGACY (7 * sizeof(ularge))
+
 class PacketData
 {
 public:
@@ -206,6 +215,9 @@ public:
     virtual uint resize(ularge frame, ularge data) = 0;
     virtual uint save(const char* path, uint& progress, uint& active) = 0;
     virtual uint load(const char* path, uint& progress, uint& active) = 0;
+public:
+    uint saveFile(const char* path, uint chunkSize, uint compression, uint& progress, uint& active);
+    uint loadFile(const char* path, uint& progress, uint& active);
 public:
     void freeInterfaceMemory();
 };
@@ -234,14 +246,56 @@ public:
     uint load(const char* path, uint& progress, uint& active);
 };
 
+////////////////////////////////////////////////////////////////////////////////
+//
+// CaptureMapped, same file layout as CaptureSSD but data is reached through
+// mapped windows instead of seek and read / write calls
+//
+////////////////////////////////////////////////////////////////////////////////
+//   64 bit builds map the whole file, 32 bit builds move a 64MB window
+#define CAPTURE_MAP_WINDOW (sizeof(void*) == 8 ? 16384 * MEGABYTE : 64 * MEGABYTE)
+
+class CaptureMapped : public CaptureSSD
+{
+public:
+    MapContext map;
+    MapView    viewRead;
+    MapView    viewWrite;
+    uint       mapped;
+public:
+    CaptureMapped();
+public:
+    uint init(const char* fileName, ularge size, uint packetSize);
+    void release();
+    void fallback();
+    ularge dataOffset();
+public:
+    uint openRead();
+    uint openWrite();
+    uint write(ularge pos, byte* buffer, ularge size);
+    uint read(ularge pos, byte* buffer, ularge size);
+    uint closeRead();
+    uint closeWrite();
+public:
+    uint resize(ularge frame, ularge data);
+    uint save(const char* path, uint& progress, uint& active);
+    uint load(const char* path, uint& progress, uint& active);
+};
+
+//   reserved history is committed in steps as it fills
+#define CAPTURE_COMMIT_STEP (64 * MEGABYTE)
+
 class CaptureMemory : public CaptureInterface
 {
 public:
     char*        data;
+    ularge       committed;
+    uint         reserved;
 public:
-    CaptureMemory() : CaptureInterface() {};
+    CaptureMemory() : CaptureInterface(), data(0), committed(0), reserved(0) {};
 public:
-    uint init(byte* mem, ularge size, uint packetSize);
+    uint init(byte* mem, ularge size, uint packetSize, uint reserve = 0);
+    void commit(ularge end);
 public:
     virtual uint openRead()
     {
@@ -253,11 +307,17 @@ public:
     };
     virtual uint write(ularge pos, byte* buffer, ularge size)
     {
+        commit(pos + size);
         SDL_memcpy(data + pos, buffer, size);
         return 0;
     };
     virtual uint read(ularge pos, byte* buffer, ularge size)
     {
+        if(pos + size > committed)
+        {
+            SDL_memset(buffer, 0, size);
+            return 1;
+        }
         SDL_memcpy(buffer, data + pos, size);
         return 0;
     };
@@ -281,6 +341,34 @@ public:
 #define DRAWSTATE_FILL 1
 #define DRAWSTATE_DRAW 2
 
+////////////////////////////////////////////////////////////////////////////////
+//
+// DisplayKey, everything besides the frame itself that display depends on
+//
+////////////////////////////////////////////////////////////////////////////////
+class DisplayKey
+{
+public:
+    double zoom;
+    double position;
+    uint   view3d;
+    uint   etsIndex;
+    uint   generation;
+public:
+    DisplayKey()
+    {
+        zoom       = 1.0;
+        position   = 0.0;
+        view3d     = 0;
+        etsIndex   = 0;
+        generation = 0;
+    }
+    int equal(const DisplayKey& key)
+    {
+        return zoom == key.zoom && position == key.position && view3d == key.view3d && etsIndex == key.etsIndex && generation == key.generation;
+    }
+};
+
 
 class CaptureBuffer
 {
@@ -288,11 +376,13 @@ public:
     SDL_atomic_t        lastFrame;
     SDL_atomic_t        drawState;
     SDL_atomic_t        drawFrame;
+    SDL_atomic_t        generation;
     SFrameHeader1       syncHeader1;
     SFrameHeader2       syncHeader2;
     CapturePacket       transferPacket;
     CaptureMemory       historyMemory;
     CaptureSSD          historySSD;
+    CaptureMapped       historyMapped;
     CaptureInterface*   history;
 public:
     void setMemory()
@@ -303,6 +393,10 @@ public:
     {
         history = &historySSD;
     };
+    void setMapped()
+    {
+        history = &historyMapped;
+    };
 public:
     byte*    displayPtr;
     ularge   displaySize;
@@ -313,6 +407,8 @@ public:
     ularge   rldSize;
     ularge   rldWritten;
     ularge   rldStart;
+    ularge   rldDecoded;
+    double   rldTime;
 public:
     CaptureBuffer(byte* display, uint displaySize, byte* rld, uint rldSize);
 public:
@@ -329,15 +425,99 @@ public:
 public:
     uint historyWrite(uint frameSize, uint version, uint headerSize, uint data, uint packetSize, bool isHeader);
     uint historyRead(CaptureFrame captureframe, uint version, uint headerSize, uint data, uint packetSize);
+    uint historyLoad(CaptureFrame& captureFrame, byte* buffer, ularge size, CapturePacket& bounce, ularge slice = 0);
 public:
     uint captureFrameLast();
     uint captureFrameCount();
     uint captureFrameSize();
     uint captureFrame(CaptureFrame& frame, uint index);
 public:
+    void displayKey(DisplayKey& key);
     uint display(OsciloscopeFrame& displayFrame, int version, int header, int data, int packet);
+    uint display(OsciloscopeFrame& displayFrame, byte* buffer, ularge read, DisplayKey& key, int version, int header, int data, int packet);
+public:
+    void clear();
+    void newGeneration();
+};
+
+////////////////////////////////////////////////////////////////////////////////
+//
+// HistoryCache
+//
+//   decoded history frames for play and pause, keyed by frame index, the
+//   capture frame it was read from and the display key. The generate thread
+//   looks frames up and predicts where browsing goes next, the prefetch
+//   thread reads and decodes the predicted frames ahead of it and releases
+//   the history lock between slices so the generate thread is not held up.
+//
+////////////////////////////////////////////////////////////////////////////////
+#define HISTORY_CACHE_SIZE      32
+#define HISTORY_CACHE_PREFETCH  8
+#define HISTORY_CACHE_REQUEST   64
+#define HISTORY_CACHE_HEADER    SCOPEFUN_FRAME_1_HEADER
+#define HISTORY_CACHE_SLICE     (4 * MEGABYTE)
+
+enum EHistoryCacheState
+{
+    hcsFree,
+    hcsLoading,
+    hcsReady,
+};
+
+class HistoryCacheEntry
+{
+public:
+    uint             state;
+    ularge           index;
+    ularge           used;
+    CaptureFrame     capture;
+    DisplayKey       key;
+    OsciloscopeFrame frame;
+    byte             header[HISTORY_CACHE_HEADER];
+};
+
+class HistoryCache
+{
 public:
+    SDL_SpinLock       spinLock;
+    HistoryCacheEntry* entry;
+    uint               count;
+    ularge             clock;
+    DisplayKey         key;
+public:
+    SpscRing<ularge>   request;
+    ularge             requestData[HISTORY_CACHE_REQUEST];
+    ularge             lastIndex;
+    int                direction;
+    uint               stride;
+public:
+    SDL_Thread*        thread;
+    SDL_atomic_t       active;
+    byte*              buffer;
+    ularge             bufferSize;
+    CapturePacket*     bounce;
+public:
+    SDL_atomic_t       hits;
+    SDL_atomic_t       misses;
+    SDL_atomic_t       prefetched;
+public:
+    HistoryCache();
+public:
+    void init(uint count);
+    void release();
+    void start();
+    void stop();
     void clear();
+public:
+    void setKey(DisplayKey& key);
+    uint lookup(ularge index, CaptureFrame& capture, OsciloscopeFrame& frame);
+    void insert(ularge index, CaptureFrame& capture, OsciloscopeFrame& frame, byte* header);
+    void predict(ularge index, ularge frameCount, int wrap);
+    uint prefetch(ularge index);
+private:
+    HistoryCacheEntry* find(ularge index, CaptureFrame& capture);
+    HistoryCacheEntry* findIndex(ularge index);
+    HistoryCacheEntry* evict();
 };
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -368,6 +548,7 @@ class OscFileThread
 {
 public:
     String       file;
+    uint         format;
     SDL_Thread*  thread;
     SDL_atomic_t atomic;
 public:
@@ -531,11 +712,48 @@ public:
     }
 };
 
+#define CAPTURE_NOTIFY_SIZE 64
+#define HANDOFF_WAIT_MS     50
+#define CAPTURE_WAIT_MS     20
+
+////////////////////////////////////////////////////////////////////////////////
+//
+// OscThreadLoop
+//
+//   capture -> generate : captured, one entry per completed frame
+//   generate -> render  : ready, render slots filled by the generate thread
+//   render -> generate  : free, render slots given back after rendering
+//
+////////////////////////////////////////////////////////////////////////////////
 class OscThreadLoop
 {
 public:
-    ThreadProduceConsume capture;
-    ThreadProduceConsume update;
+    SpscRing<uint> captured;
+    SpscRing<uint> ready;
+    SpscRing<uint> free;
+public:
+    uint   capturedData[CAPTURE_NOTIFY_SIZE];
+    uint   readyData[MAX_THREAD + 1];
+    uint   freeData[MAX_THREAD + 1];
+    ularge readyTime[MAX_THREAD];
+public:
+    void init(uint slots)
+    {
+        captured.init(capturedData, CAPTURE_NOTIFY_SIZE, 1);
+        ready.init(readyData, slots + 1, 1);
+        free.init(freeData, slots + 1, 1);
+        for(uint i = 0; i < slots; i++)
+        {
+            readyTime[i] = 0;
+            free.push(i);
+        }
+    }
+    void destroy()
+    {
+        captured.destroy();
+        ready.destroy();
+        free.destroy();
+    }
 };
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -601,6 +819,116 @@ public:
     uint etsAttr;
 };
 
+////////////////////////////////////////////////////////////////////////////////
+//
+// FrameSnapshot
+//
+////////////////////////////////////////////////////////////////////////////////
+class FrameSnapshot
+{
+public:
+    SDL_atomic_t     refCount;
+    OsciloscopeFrame frame;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+//
+// FrameSnapshotPool
+//
+//   frames are copied once when published and are immutable afterwards,
+//   history rings only hold references
+//
+////////////////////////////////////////////////////////////////////////////////
+class FrameSnapshotPool
+{
+public:
+    FrameSnapshot* snapshot;
+    uint           count;
+    uint           next;
+public:
+    FrameSnapshotPool();
+public:
+    void           init(FrameSnapshot* memory, uint count);
+    FrameSnapshot* acquire();
+    void           retain(FrameSnapshot* frame);
+    void           release(FrameSnapshot* frame);
+};
+
+////////////////////////////////////////////////////////////////////////////////
+//
+// PipelineStats
+//
+//   each stage and queue is written by a single thread, readers copy without
+//   locking and may be one sample behind, clear is only a request the writer
+//   honours on its next sample
+//
+////////////////////////////////////////////////////////////////////////////////
+enum EPipelineStage
+{
+    psCapture,      // capture thread, usb / network transfer
+    psUncompress,   // capture thread, CaptureBuffer::uncompress
+    psHistoryWrite, // capture thread, CaptureBuffer::historyWrite
+    psHistoryRead,  // generate thread, CaptureBuffer::historyRead
+    psDisplay,      // generate thread, CaptureBuffer::display
+    psGenerate,     // generate thread, one loop without time blocked on queues
+    psRender,       // generate thread, OsciloscopeManager::renderThread
+    psLatency,      // generate thread, frame captured to renderThread
+    psHandoff,      // render thread, slot ready to slot picked up
+    psDraw,         // render thread, renderMain
+    psLast,
+};
+
+enum EPipelineQueue
+{
+    pqCaptured,     // sampled by the generate thread
+    pqReady,        // sampled by the render thread
+    pqFree,         // sampled by the generate thread
+    pqLast,
+};
+
+class PipelineStageStats
+{
+public:
+    SLatency     latency;
+    ularge       bytes;
+    ularge       dropped;
+    SDL_atomic_t clear;
+};
+
+class PipelineQueueStats
+{
+public:
+    uint         depth;
+    uint         max;
+    ularge       samples;
+    ularge       sum;
+    SDL_atomic_t clear;
+};
+
+class PipelineStats
+{
+public:
+    PipelineStageStats stage[psLast];
+    PipelineQueueStats queue[pqLast];
+public:
+    PipelineStats();
+public:
+    ularge begin()
+    {
+        return SDL_GetPerformanceCounter();
+    }
+    void end(EPipelineStage s, ularge start, ularge bytes = 0);
+    void record(EPipelineStage s, uint us, ularge bytes = 0);
+    void drop(EPipelineStage s, uint count);
+    void depth(EPipelineQueue q, uint depth);
+    void clear();
+public:
+    static const char* stageName(EPipelineStage s);
+    static const char* queueName(EPipelineQueue q);
+public:
+    int  dump(const char* path, SFContext* ctx);
+};
+
 ////////////////////////////////////////////////////////////////////////////////
 //
 // OsciloscopeThreadData
@@ -611,7 +939,7 @@ class OsciloscopeThreadData
 public:
     OsciloscopeFrame          etsClear;
     OsciloscopeFrame          frame;
-    Ring<OsciloscopeFrame>    history;
+    Ring<FrameSnapshot*>      history;
     WndMain                   window;
     OsciloscopeRenderData     render;
     byte                      customCh0;
@@ -635,21 +963,77 @@ enum RenderFlag
 //
 // ETS
 //
+//   decoded frames accumulate in slots, one per ets offset, matched by the
+//   full offset so any fpgaEtsCount works. A window holds at most ETS_SLOTS
+//   frames and so at most that many offsets, the order list keeps them in
+//   arrival order for replay. Slots remember the history
+//   frame and display key they were decoded from and keep the raw frame, the
+//   tag table remembers the ets offset of recently read history frames. A
+//   frame change only reads the slots that actually changed, a timebase,
+//   zoom or position change only decodes the kept raw frames again.
+//
 ////////////////////////////////////////////////////////////////////////////////
+#define ETS_SLOTS    32
+#define ETS_TAGS     256
+#define ETS_RAW_MAX  (4 * MEGABYTE)
+#define ETS_UNKNOWN  ((ularge)-1)
+
+class OsciloscopeETSSlot
+{
+public:
+    uint             used;
+    uint             ets;
+    ularge           index;
+    CaptureFrame     capture;
+    DisplayKey       key;
+    byte*            raw;
+    ularge           rawSize;
+    ularge           rawRead;
+    OsciloscopeFrame frame;
+};
+
+class OsciloscopeETSTag
+{
+public:
+    ularge       index;
+    CaptureFrame capture;
+    uint         etsIndex;
+    uint         ets;
+};
+
 class OsciloscopeETS
 {
 public:
     OsciloscopeFrame             oscFrame;
-    Array<OsciloscopeFrame, 32>  etsHistory;
+    OsciloscopeETSSlot           slot[ETS_SLOTS];
+    uint                         order[ETS_SLOTS];
+    uint                         count;
+    OsciloscopeETSTag            tag[ETS_TAGS];
+    DisplayKey                   key;
     OsciloscopeFrame             etsClear;
     uint                         etsIndex;
     uint                         etsAttr;
 public:
+    SDL_atomic_t                 reused;
+    SDL_atomic_t                 redecoded;
+    SDL_atomic_t                 reread;
+public:
+    OsciloscopeETS();
+public:
+    void release();
     void clear();
     void redraw(OsciloscopeRenderData& render,SDL_atomic_t* redraw);
-    void onFrameChange(int framechange, Ring<CapturePacket> threadHistory, OsciloscopeRenderData& render);
+    void onFrameChange(ularge framechange, OsciloscopeRenderData& render);
     void onCapture(OsciloscopeFrame& frame, OsciloscopeRenderData& render);
     void onPause(OsciloscopeFrame& frame, WndMain& window);
+private:
+    void reset();
+    int  findSlot(uint ets);
+    int  freeSlot(uint* claimed);
+    void keepRaw(OsciloscopeETSSlot& s, byte* data, ularge size);
+    int  findTag(ularge index, CaptureFrame& capture, uint etsIndex);
+    void setTag(ularge index, CaptureFrame& capture, uint etsIndex, uint ets);
+    void toBack(uint id);
 };
 
 
@@ -670,10 +1054,15 @@ public:
     SurfaceFrame* surfaceFrame1;
     SurfaceFrame* surfaceFrameF;
 public:
-    ularge        cfgSize;
-    byte*         cfgMem;
-    kiss_fft_cpx* in;
-    kiss_fft_cpx* out;
+    Array<FFTPlan, FFT_PLAN_CACHE> fftPlans;
+    ularge           fftPlanUse;
+    kiss_fft_scalar* scalar;
+    kiss_fft_cpx*    in;
+    kiss_fft_cpx*    out;
+public:
+    FunctionProgram functionProgram;
+    double*         functionValue;
+    double*         functionZero;
 public:
     uint historyCount;
 public:
@@ -683,11 +1072,12 @@ public:
         surfaceFrame1 = (SurfaceFrame*)pMemory->allocate(sizeof(SurfaceFrame) * max3dhistory);
         surfaceFrameF = (SurfaceFrame*)pMemory->allocate(sizeof(SurfaceFrame) * max3dhistory);
         historyCount  = max3dhistory;
-        cfgSize = 0;
-        kiss_fft_alloc(NUM_FFT, 0, 0, (size_t*)&cfgSize);
-        cfgMem = (byte*)pMemory->allocate(cfgSize);
+        fftPlanUse = 0;
+        scalar = (kiss_fft_scalar*)pMemory->allocate(NUM_FFT * sizeof(kiss_fft_scalar));
         in  = (kiss_fft_cpx*)pMemory->allocate(NUM_FFT * sizeof(kiss_fft_cpx));
         out = (kiss_fft_cpx*)pMemory->allocate(NUM_FFT * sizeof(kiss_fft_cpx));
+        functionValue = (double*)pMemory->allocate((NUM_SAMPLES + 1) * sizeof(double));
+        functionZero  = (double*)pMemory->allocate((NUM_SAMPLES + 1) * sizeof(double));
     }
     void clear()
     {
@@ -705,6 +1095,7 @@ public:
         }
     }
 public:
+    void functionSamples(WndMain& window, int function, OsciloscopeFrame& frame, uint start, uint count, double factor0, double offset0, double factor1, double offset1, double* out);
     void measureSignal(uint threadId, OsciloscopeThreadData& threadData, MeasureData& measure, OsciloscopeFFT& fft);
 public:
     void preOscRender(uint threadId, OsciloscopeThreadData& threadData);
@@ -732,7 +1123,9 @@ public:
     void renderSlider(uint threadid, OsciloscopeThreadData& threadData);
 public:
     void dftCalculate(iint n, double* inRe, double* inIm, double* outRe, double* outIm);
+    FFTPlan* fftPlan(uint n, bool real);
     void fftCalculate(uint threadId, uint backward, uint n, double* real, double* imag);
+    double* fftSpectrum(uint threadId, OsciloscopeThreadData& threadData, OsciloscopeFFT& fft, OsciloscopeFrame& frame, uint source, iint p);
     void fftAmplitude(iint points, iint n, double* outAmpl, double* inRe, double* inIm);
 };
 
@@ -830,12 +1223,40 @@ enum EThreadApiFunction {
    afLast,
 };
 
+#define THREAD_API_QUEUE    32
+#define THREAD_API_RESULTS  64
+#define THREAD_API_IDLE_MS  10
+
+////////////////////////////////////////////////////////////////////////////////
+//
+// ThreadApiCall
+//
+//   queued call, handle works like a future, the call is complete once the
+//   control thread has completed all handles up to and including this one
+//
+////////////////////////////////////////////////////////////////////////////////
+class ThreadApiCall {
+public:
+   ularge             handle;
+   EThreadApiFunction function;
+   ularge             queued;
+};
+
 class ThreadApi {
 private:
-   SDL_SpinLock                  lock;
-   SDL_atomic_t                  sync;
-   Array<EThreadApiFunction,16>  func;
-   SDL_atomic_t                  ret[afLast];
+   SDL_SpinLock                               lock;
+   SDL_mutex*                                 mutex;
+   SDL_cond*                                  queued;
+   SDL_cond*                                  completed;
+   ularge                                     submitHandle;
+   ularge                                     completeHandle;
+   Array<ThreadApiCall, THREAD_API_QUEUE>     func;
+   int                                        callResult[THREAD_API_RESULTS];
+   SDL_atomic_t                               ret[afLast];
+private:
+   SDL_atomic_t latencyDispatch[afLast];
+   SDL_atomic_t latencyComplete[afLast];
+   SDL_atomic_t lastFunction;
 private:
    SDL_atomic_t open;
    SDL_atomic_t connected;
@@ -874,12 +1295,21 @@ public:
    SHardware2   config2;
 public:
    ThreadApi();
+   ~ThreadApi();
 public:
    // thread
-   void function(EThreadApiFunction func);
-   void wait();
-   void update();
-public:
+   ularge function(EThreadApiFunction func);
+   void   wait();
+   void   wait(ularge handle);
+   void   idle(uint timeoutMs);
+   void   update();
+public:
+   // latency in microseconds, queued to started and queued to completed
+   int  dispatchLatency(EThreadApiFunction func);
+   int  completeLatency(EThreadApiFunction func);
+   int  lastDispatched();
+public:
+   int  result(ularge handle);
    int  result(EThreadApiFunction func);
    void resultClear(EThreadApiFunction func);
    void resultClearAll();
@@ -954,6 +1384,13 @@ public:
     uint    sizeRunLengthDecode;
 public:
     SDL_atomic_t  bandWidth;
+    SDL_atomic_t  rleBandWidth;
+    SDL_atomic_t  historyNotCopied;
+    ularge        historySaved;
+    SDL_atomic_t  renderLatency;
+    SDL_atomic_t  handoffLatency;
+    SDL_atomic_t  generateIdle;
+    float         statsTime;
 public:
     SSimulate      sim;
 public:
@@ -1062,13 +1499,16 @@ public:
     WndMain                renderWindow;
     OsciloscopeRenderData  renderData;
     OscThreadLoop          threadLoop;
-    OsciloscopeThreadData  captureData[MAX_THREAD];
     MeasureData            measureData[MAX_THREAD];
     OsciloscopeThreadData  captureTemp;
 public:
-    OsciloscopeFrame*      pTmpData;
+    FrameSnapshot**        pTmpData;
+    FrameSnapshot*         pSnapshotData;
+    FrameSnapshotPool      snapshotPool;
+    PipelineStats          stats;
+    HistoryCache           historyCache;
     OsciloscopeFrame       tmpDisplay;
-    Ring<OsciloscopeFrame> tmpHistory;
+    Ring<FrameSnapshot*>   tmpHistory;
 public:
     bool                   renderThreadActive;
     bool                   captureDataThreadActive;
@@ -1100,6 +1540,7 @@ public:
     int  saveToFile(const char* file);
     int  loadFromFile(const char* file);
     int  convertToText(const char* file);
+    int  exportFile(const char* file, uint format);
 public:
     int  start();
     int  update(float dt);
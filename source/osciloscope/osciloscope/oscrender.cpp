@@ -120,6 +120,50 @@ float channelFunction(float ch0value, float ch1value, int function, WndMain& win
     return 0.f;
 }
 
+void channelFunctionBlock(const double* ch0value, const double* ch1value, double* out, uint count, int function, WndMain& window, FunctionProgram& program)
+{
+    if(function == ANALOG_FUNCTION_CUSTOM)
+    {
+        program.evaluate(window.function.custom, ch0value, ch1value, out, count);
+        for(uint i = 0; i < count; i++)
+        {
+            out[i] = float(out[i]);
+        }
+        return;
+    }
+    for(uint i = 0; i < count; i++)
+    {
+        out[i] = channelFunction(float(ch0value[i]), float(ch1value[i]), function, window);
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//
+// functionSamples
+//
+////////////////////////////////////////////////////////////////////////////////
+void OsciloscopeThreadRenderer::functionSamples(WndMain& window, int function, OsciloscopeFrame& frame, uint start, uint count, double factor0, double offset0, double factor1, double offset1, double* out)
+{
+    // slot files and the gui only carry the expression, compile it here when it changes
+    if(function == ANALOG_FUNCTION_CUSTOM && functionProgram.changed(window.function.custom))
+    {
+        functionProgram.compile(window.function.custom);
+    }
+    double ch0[4 * FUNCTION_BLOCK];
+    double ch1[4 * FUNCTION_BLOCK];
+    for(uint i = 0; i < count; i += 4 * FUNCTION_BLOCK)
+    {
+        uint n = min<uint>(4 * FUNCTION_BLOCK, count - i);
+        for(uint j = 0; j < n; j++)
+        {
+            // channelFunction takes floats, round the same way
+            ch0[j] = float(frame.getAnalogDouble(0, start + i + j) * factor0 + offset0);
+            ch1[j] = float(frame.getAnalogDouble(1, start + i + j) * factor1 + offset1);
+        }
+        channelFunctionBlock(ch0, ch1, out + i, n, function, window, functionProgram);
+    }
+}
+
 /////////////////////////////////////////////////////////////////////////////
 //
 // osc:           x[ -0.5, 0.5 ], y[  -0.5, 0.5 ]
@@ -192,6 +236,54 @@ void OsciloscopeThreadRenderer::renderFps(uint threadId, OsciloscopeThreadData&
         pFont->setSize(threadId, 0.75f);
         pFont->writeText(threadId, 200, y, formatBuffer);
         y += 25;
+        FORMAT("rle decode: %d MB", SDL_AtomicGet(&pOsciloscope->rleBandWidth));
+        pFont->setSize(threadId, 0.75f);
+        pFont->writeText(threadId, 200, y, formatBuffer);
+        y += 25;
+        FORMAT("render latency: %d us", SDL_AtomicGet(&pOsciloscope->renderLatency));
+        pFont->setSize(threadId, 0.75f);
+        pFont->writeText(threadId, 200, y, formatBuffer);
+        y += 25;
+        FORMAT("history not copied: %d MB", SDL_AtomicGet(&pOsciloscope->historyNotCopied));
+        pFont->setSize(threadId, 0.75f);
+        pFont->writeText(threadId, 200, y, formatBuffer);
+        y += 25;
+        FORMAT("handoff latency: %d us", SDL_AtomicGet(&pOsciloscope->handoffLatency));
+        pFont->setSize(threadId, 0.75f);
+        pFont->writeText(threadId, 200, y, formatBuffer);
+        y += 25;
+        FORMAT("generate idle: %d %%", SDL_AtomicGet(&pOsciloscope->generateIdle));
+        pFont->setSize(threadId, 0.75f);
+        pFont->writeText(threadId, 200, y, formatBuffer);
+        y += 25;
+        PipelineStats& stats = pOsciloscope->stats;
+        for(int i = 0; i < psLast; i++)
+        {
+            SLatency& latency = stats.stage[i].latency;
+            int p50 = 0;
+            int p99 = 0;
+            sfLatencyPercentile(&latency, 50.0, &p50);
+            sfLatencyPercentile(&latency, 99.0, &p99);
+            FORMAT("%s: p50 %d p99 %d max %d us dropped %d", PipelineStats::stageName(EPipelineStage(i)), p50, p99, latency.max, int(stats.stage[i].dropped));
+            pFont->setSize(threadId, 0.75f);
+            pFont->writeText(threadId, 200, y, formatBuffer);
+            y += 25;
+        }
+        for(int i = 0; i < pqLast; i++)
+        {
+            FORMAT("queue %s: %d max %d", PipelineStats::queueName(EPipelineQueue(i)), stats.queue[i].depth, stats.queue[i].max);
+            pFont->setSize(threadId, 0.75f);
+            pFont->writeText(threadId, 200, y, formatBuffer);
+            y += 25;
+        }
+        EThreadApiFunction apiLast = (EThreadApiFunction)pOsciloscope->thread.lastDispatched();
+        if(apiLast < afLast)
+        {
+            FORMAT("api %d dispatch: %d us complete: %d us", apiLast, pOsciloscope->thread.dispatchLatency(apiLast), pOsciloscope->thread.completeLatency(apiLast));
+            pFont->setSize(threadId, 0.75f);
+            pFont->writeText(threadId, 200, y, formatBuffer);
+            y += 25;
+        }
         for(uint i = 0; i < pRender->getThreadCount(); i++)
         {
             FORMAT("update_%d: %d", i, pTimer->getFps(i + TIMER_UPDATE0));
@@ -800,6 +892,8 @@ void OsciloscopeThreadRenderer::measureSignal(uint threadId, OsciloscopeThreadDa
     double y0Middle = 0;
     double y1Middle = 0;
     double yFMiddle = 0;
+    functionSamples(wndMain, wndMain.function.Type, frame, 0, icount, yfactor0, -ch0ZeroVolt, yfactor1, -ch1ZeroVolt, functionZero);
+    functionSamples(wndMain, wndMain.function.Type, frame, 0, icount, yfactor0, 0, yfactor1, 0, functionValue);
     for(uint pt = 0; pt < icount; pt++)
     {
         uint idx = clamp<int>(pt, 0, icount - 1);
@@ -809,10 +903,9 @@ void OsciloscopeThreadRenderer::measureSignal(uint threadId, OsciloscopeThreadDa
         }
         double   yPosCh0 = frame.getAnalogDouble(0, idx);
         double   yPosCh1 = frame.getAnalogDouble(1, idx);
-        double   yPosChF = channelFunction(yPosCh0, yPosCh1, wndMain.function.Type, wndMain);
         double   y0 = yPosCh0 * yfactor0 - ch0ZeroVolt;
         double   y1 = yPosCh1 * yfactor1 - ch1ZeroVolt;
-        double   yF = channelFunction(y0, y1, wndMain.function.Type, wndMain);
+        double   yF = functionZero[idx];
         double xPos = ( double(pt) / double(icount) );
         double    x = xPos + xposition;
         double time = x * capture * frameSize;
@@ -825,7 +918,7 @@ void OsciloscopeThreadRenderer::measureSignal(uint threadId, OsciloscopeThreadDa
         // recalc
         y0 = yPosCh0 * yfactor0;
         y1 = yPosCh1 * yfactor1;
-        yF = channelFunction(y0, y1, wndMain.function.Type, wndMain);
+        yF = functionValue[idx];
         // min
         if(y0 < y0Min)
         {
@@ -889,7 +982,7 @@ void OsciloscopeThreadRenderer::measureSignal(uint threadId, OsciloscopeThreadDa
         double   yPosCh1 = frame.getAnalogDouble(1, idx);
         double   y0 = yPosCh0 * yfactor0 /*- ch0ZeroVolt*/;
         double   y1 = yPosCh1 * yfactor1 /*- ch1ZeroVolt*/;
-        double   yF = channelFunction(y0, y1, wndMain.function.Type, wndMain);
+        double   yF = functionValue[idx];
         double xPos = (double(pt) / double(icount) );
         double    x = xPos + xposition;
         double time = x * capture * frameSize;
@@ -1075,7 +1168,7 @@ void OsciloscopeThreadRenderer::measureSignal(uint threadId, OsciloscopeThreadDa
         double   yPosCh1 = frame.getAnalogDouble(1, idx);
         double   y0 = yPosCh0 * yfactor0 - ch0ZeroVolt;
         double   y1 = yPosCh1 * yfactor1 - ch1ZeroVolt;
-        double   yF = channelFunction(y0, y1, wndMain.function.Type, wndMain);
+        double   yF = functionZero[idx];
         double    x = (double(pt) / icount);
         x = x + xposition;
         double time = x * capture * frameSize;
@@ -1249,9 +1342,8 @@ void OsciloscopeThreadRenderer::measureSignal(uint threadId, OsciloscopeThreadDa
     ////////////////////////////////////////////////////////////////////////////////
     // FFT
     ////////////////////////////////////////////////////////////////////////////////
-    for(int ch = 0; ch < 3; ch++)
+    for(int ch = 0; ch < FFT_SOURCES; ch++)
     {
-        bool isFunction = (ch == 3) ? true : false;
         iint p = wndMain.horizontal.FFTSize;
         if(!p)
         {
@@ -1270,33 +1362,13 @@ void OsciloscopeThreadRenderer::measureSignal(uint threadId, OsciloscopeThreadDa
             continue;
         }
         ////////////////////////////////////////////////////////////////////////////////
-        // FFT input
+        // FFT spectrum
         ////////////////////////////////////////////////////////////////////////////////
-        iint n = 0;
-        for(int j = 0; j < p; j++)
+        double* spectrum = fftSpectrum(threadId, threadData, fft, frame, ch, p);
+        if(!spectrum)
         {
-            if(isFunction)
-            {
-                float ch0 = frame.getAnalog(0, j);
-                float ch1 = frame.getAnalog(1, j);
-                fft.aRe[j]   = channelFunction(ch0, ch1, wndMain.function.Type, wndMain);
-                fft.aIm[j]   = 0.0;
-                fft.aAmpl[j] = 0.0;
-                n = min(frame.analog[0].getCount(), frame.analog[1].getCount());
-            }
-            else
-            {
-                n = frame.analog[ch].getCount();
-                fft.aRe[j]   = frame.getAnalog(ch, j);
-                fft.aIm[j]   = 0.0;
-                fft.aAmpl[j] = 0.0;
-            }
+            continue;
         }
-        ////////////////////////////////////////////////////////////////////////////////
-        // FFT calculate
-        ////////////////////////////////////////////////////////////////////////////////
-        fftCalculate(threadId, 0, p, &fft.aRe[0], &fft.aIm[0]);
-        fftAmplitude(n, p, &fft.aAmpl[0], &fft.aRe[0], &fft.aIm[0]);
         int count = p / 2 + 1;
         ////////////////////////////////////////////////////////////////////////////////
         // increment
@@ -1325,7 +1397,7 @@ void OsciloscopeThreadRenderer::measureSignal(uint threadId, OsciloscopeThreadDa
             float       time = wndMain.horizontal.Capture;
             for(int i = 0; i < count; i++)
             {
-                float amplitude    = fft.aAmpl[i] * yfactor;
+                float amplitude    = spectrum[i] * yfactor;
                 float logAmplitude = amplitude;
                 if(wndMain.display.fftDecibel >= 1)
                 {
@@ -1921,6 +1993,7 @@ void OsciloscopeThreadRenderer::renderAnalogFunction(uint threadid, OsciloscopeT
     //
     if(isamples0 && isamples1)
     {
+        functionSamples(wndMain, function, frame, 0, isamples0 + 1, yfactor0, yOffset0, yfactor1, yOffset1, functionValue);
         for(uint point = start; point <= end; point += increment)
         {
             uint idx0 = clamp<uint>(point, 0, isamples0);
@@ -1934,14 +2007,8 @@ void OsciloscopeThreadRenderer::renderAnalogFunction(uint threadid, OsciloscopeT
             {
                 continue;
             }
-            float ystart  = 0;
-            float yend    = 0;
-            float ystart0 = frame.getAnalog(0, idx0) * yfactor0 + float(yOffset0);
-            float yend0   = frame.getAnalog(0, idx1) * yfactor0 + float(yOffset0);
-            float ystart1 = frame.getAnalog(1, idx0) * yfactor1 + float(yOffset1);
-            float yend1   = frame.getAnalog(1, idx1) * yfactor1 + float(yOffset1);
-            ystart = channelFunction(ystart0, ystart1, function, wndMain);
-            yend   = channelFunction(yend0, yend1, function, wndMain);
+            float ystart = float(functionValue[idx0]);
+            float yend   = float(functionValue[idx1]);
             if(threadData.customFun)
             {
                 ystart = threadData.customData.analogF.bytes[idx0];
@@ -2167,6 +2234,7 @@ void OsciloscopeThreadRenderer::renderAnalogFunction3d(uint threadid, Osciloscop
     double yOffset1 = 0;
     if(isamples0 && isamples1)
     {
+        functionSamples(wndMain, wndMain.function.Type, frame, 0, isamples0 + 1, yfactor0, yOffset0, yfactor1, yOffset1, functionValue);
         int i = 0;
         for(uint point = start; point <= end; point += increment)
         {
@@ -2181,9 +2249,7 @@ void OsciloscopeThreadRenderer::renderAnalogFunction3d(uint threadid, Osciloscop
                 continue;
             }
             // y
-            float y0 = frame.getAnalog(0, idx0) * yfactor0 + float(yOffset0);
-            float y1 = frame.getAnalog(1, idx0) * yfactor1 + float(yOffset1);
-            float y      = channelFunction(y0, y1, wndMain.function.Type, wndMain);
+            float y      = float(functionValue[idx0]);
             // x
             float fpoint = (float(point) / NUM_SAMPLES) - 0.5f;
             float x      = fpoint * xfactor + xposition;
@@ -2649,37 +2715,19 @@ void OsciloscopeThreadRenderer::renderFFT(uint threadId, OsciloscopeThreadData&
     {
         return;
     }
-    iint n = frame.analog[channelId].getCount();
     iint p = wndMain.horizontal.FFTSize;
     if(!p)
     {
         return;
     }
     ////////////////////////////////////////////////////////////////////////////////
-    // FFT input
+    // FFT spectrum, shared with measureSignal when the input is unchanged
     ////////////////////////////////////////////////////////////////////////////////
-    for(int i = 0; i < p; i++)
+    double* spectrum = fftSpectrum(threadId, threadData, fft, frame, funtion ? 2 : channelId, p);
+    if(!spectrum)
     {
-        if(funtion)
-        {
-            float ch0  = frame.getAnalog(0, i);
-            float ch1  = frame.getAnalog(1, i);
-            fft.aRe[i]   = channelFunction(ch0, ch1, wndMain.function.Type, wndMain);
-            fft.aIm[i]   = 0.0;
-            fft.aAmpl[i] = 0.0;
-        }
-        else
-        {
-            fft.aRe[i] = frame.getAnalog(channelId, i);
-            fft.aIm[i] = 0.0;
-            fft.aAmpl[i] = 0.0;
-        }
+        return;
     }
-    ////////////////////////////////////////////////////////////////////////////////
-    // FFT calculate
-    ////////////////////////////////////////////////////////////////////////////////
-    fftCalculate(threadId, 0, p, &fft.aRe[0],   &fft.aIm[0]);
-    fftAmplitude(n, p, &fft.aAmpl[0], &fft.aRe[0], &fft.aIm[0]);
     int count = p / 2 + 1;
     ////////////////////////////////////////////////////////////////////////////////
     // increment
@@ -2714,7 +2762,7 @@ void OsciloscopeThreadRenderer::renderFFT(uint threadId, OsciloscopeThreadData&
         float       time = wndMain.horizontal.Capture;
         for(int i = 0; i < count; i++)
         {
-            float amplitude = fft.aAmpl[i] * yfactor;
+            float amplitude = spectrum[i] * yfactor;
             if(wndMain.display.fftDecibel >= 1)
             {
                 // db60
@@ -788,6 +788,7 @@ void OscSettings::load()
         cJSON* jHistory = cJSON_GetObjectItem(jmemory, "history");
         cJSON* jFrame   = cJSON_GetObjectItem(jmemory, "frame");
         cJSON* jRld     = cJSON_GetObjectItem(jmemory, "rld");
+        cJSON* jLazy    = cJSON_GetObjectItem(jmemory, "lazy");
         if(jHistory)
         {
             memoryHistory = jsonToInt(jHistory);
@@ -800,6 +801,10 @@ void OscSettings::load()
         {
             memoryRld     = jsonToInt(jRld);
         }
+        if(jLazy)
+        {
+            memoryLazy    = jsonToInt(jLazy);
+        }
     }
     cJSON* history = cJSON_GetObjectItem(json, "history");
     if(history)
@@ -854,6 +859,34 @@ void OscSettings::load()
             windowControlHeight = jsonToInt(ch);
         }
     }
+    cJSON* stats = cJSON_GetObjectItem(json, "stats");
+    if(stats)
+    {
+        cJSON* dump = cJSON_GetObjectItem(stats, "dump");
+        if(dump)
+        {
+            statsDump = jsonToInt(dump);
+        }
+    }
+    cJSON* file = cJSON_GetObjectItem(json, "file");
+    if(file)
+    {
+        cJSON* chunk       = cJSON_GetObjectItem(file, "chunk");
+        cJSON* compression = cJSON_GetObjectItem(file, "compression");
+        cJSON* exportFormat = cJSON_GetObjectItem(file, "export");
+        if(chunk)
+        {
+            fileChunk = jsonToInt(chunk);
+        }
+        if(compression)
+        {
+            fileCompression = jsonToInt(compression);
+        }
+        if(exportFormat)
+        {
+            fileExport = jsonToInt(exportFormat);
+        }
+    }
     // delete
     cJSON_Delete(json);
 }
@@ -890,9 +923,10 @@ void OscSettings::save()
     cJSON_AddItemToObject(jsonSpeed, "high",   cJSON_CreateNumber(this->speedHigh));
     cJSON* jmemory = cJSON_CreateObject();
     cJSON_AddItemToObject(jsonRoot, "memory", jmemory);
-    cJSON_AddItemToObject(jsonSpeed, "history", cJSON_CreateNumber(this->memoryHistory));
-    cJSON_AddItemToObject(jsonSpeed, "frame", cJSON_CreateNumber(this->memoryFrame));
-    cJSON_AddItemToObject(jsonSpeed, "rld", cJSON_CreateNumber(this->memoryRld));
+    cJSON_AddItemToObject(jmemory, "history", cJSON_CreateNumber(this->memoryHistory));
+    cJSON_AddItemToObject(jmemory, "frame", cJSON_CreateNumber(this->memoryFrame));
+    cJSON_AddItemToObject(jmemory, "rld", cJSON_CreateNumber(this->memoryRld));
+    cJSON_AddItemToObject(jmemory, "lazy", cJSON_CreateNumber(this->memoryLazy));
     cJSON* jsonHistory = cJSON_CreateObject();
     cJSON_AddItemToObject(jsonRoot, "history", jsonHistory);
     cJSON_AddItemToObject(jsonHistory, "frameCount",     cJSON_CreateNumber(this->historyFrameCount));
@@ -906,6 +940,14 @@ void OscSettings::save()
     cJSON_AddItemToObject(jsonWindow, "displayHeight", cJSON_CreateNumber(this->windowDisplayHeight));
     cJSON_AddItemToObject(jsonWindow, "controlWidth", cJSON_CreateNumber(this->windowControlWidth));
     cJSON_AddItemToObject(jsonWindow, "controlHeight", cJSON_CreateNumber(this->windowControlHeight));
+    cJSON* jsonStats = cJSON_CreateObject();
+    cJSON_AddItemToObject(jsonRoot, "stats", jsonStats);
+    cJSON_AddItemToObject(jsonStats, "dump", cJSON_CreateNumber(this->statsDump));
+    cJSON* jsonFile = cJSON_CreateObject();
+    cJSON_AddItemToObject(jsonRoot, "file", jsonFile);
+    cJSON_AddItemToObject(jsonFile, "chunk", cJSON_CreateNumber(this->fileChunk));
+    cJSON_AddItemToObject(jsonFile, "compression", cJSON_CreateNumber(this->fileCompression));
+    cJSON_AddItemToObject(jsonFile, "export", cJSON_CreateNumber(this->fileExport));
     // save
     char* jsonString = cJSON_Print(jsonRoot);
     if(!jsonString)
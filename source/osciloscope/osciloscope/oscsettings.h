@@ -117,6 +117,7 @@ public:
     uint  memoryRld;
     uint  memoryHistory;
     uint  memoryFrame;
+    uint  memoryLazy;
     uint  historyFrameCount;
     uint  historyFrameDisplay;
     uint  historyFrameLoadSave;
@@ -126,6 +127,10 @@ public:
     int   windowDisplayHeight;
     int   windowControlWidth;
     int   windowControlHeight;
+    uint  statsDump;
+    uint  fileChunk;
+    uint  fileCompression;
+    uint  fileExport;
 public:
     cJSON* json;
 public:
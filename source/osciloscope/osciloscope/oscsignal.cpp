@@ -30,6 +30,72 @@ ishort leadBitShift(ushort value)
     return value;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+//
+// rle, decoding lives in core/purec/purerle.c
+//
+////////////////////////////////////////////////////////////////////////////////
+static bool rleLiteral(byte* dest, ularge destSize, ularge& written, byte* src, ularge count)
+{
+    if(count == 0)
+    {
+        return true;
+    }
+    if(written + count + 1 > destSize)
+    {
+        return false;
+    }
+    dest[written++] = byte(128 + count);
+    SDL_memcpy(dest + written, src, count);
+    written += count;
+    return true;
+}
+
+// runs of 3 or more bytes are stored as runs, the rest as literals,
+// returns 0 when the output does not fit in destSize
+ularge rleEncode(byte* dest, ularge destSize, byte* src, ularge srcSize)
+{
+    ularge written = 0;
+    ularge literal = 0;
+    ularge i = 0;
+    while(i < srcSize)
+    {
+        ularge run = 1;
+        while(i + run < srcSize && run < 128 && src[i + run] == src[i])
+        {
+            run++;
+        }
+        if(run >= 3)
+        {
+            if(!rleLiteral(dest, destSize, written, src + literal, i - literal) || written + 2 > destSize)
+            {
+                return 0;
+            }
+            dest[written++] = byte(run);
+            dest[written++] = src[i];
+            i += run;
+            literal = i;
+        }
+        else
+        {
+            i++;
+            if(i - literal == 127)
+            {
+                if(!rleLiteral(dest, destSize, written, src + literal, i - literal))
+                {
+                    return 0;
+                }
+                literal = i;
+            }
+        }
+    }
+    if(!rleLiteral(dest, destSize, written, src + literal, i - literal))
+    {
+        return 0;
+    }
+    return written;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 //
 // CaptureInterface
@@ -136,8 +202,7 @@ uint CaptureInterface::writePacket(CapturePacket& packet, uint isHeader)
     data.flag.raise(PACKET_USED);
     data.flag.raise(isHeader ? PACKET_HEADER : 0);
     ringPacket.write(data);
-    write(offsetWrite, (byte*)packet.data, packet.size);
-    return 0;
+    return write(offsetWrite, (byte*)packet.data, packet.size);
 }
 
 uint CaptureInterface::readPacket(CapturePacket& elem)
@@ -147,7 +212,7 @@ uint CaptureInterface::readPacket(CapturePacket& elem)
         PacketData data;
         ringPacket.read(data);
         elem.size = data.size;
-        read(data.offset, (byte*)elem.data, data.size);
+        return read(data.offset, (byte*)elem.data, data.size);
     }
     return 0;
 }
@@ -157,18 +222,43 @@ uint CaptureInterface::readPacket(CapturePacket& elem)
 // CaptureMemory
 //
 ////////////////////////////////////////////////////////////////////////////////
-uint CaptureMemory::init(byte* mem, ularge size, uint packetSize)
+uint CaptureMemory::init(byte* mem, ularge size, uint packetSize, uint reserve)
 {
     data = (char*)mem;
     memoryMax = memoryCurrent = size;
+    reserved  = reserve;
+    committed = reserve ? 0 : size;
     allocateFrame(size, packetSize);
     allocatePacket(size, packetSize);
     return 0;
 }
 
+void CaptureMemory::commit(ularge end)
+{
+    if(end <= committed)
+    {
+        return;
+    }
+    ularge to = min(memoryMax, ((end + CAPTURE_COMMIT_STEP - 1) / CAPTURE_COMMIT_STEP) * CAPTURE_COMMIT_STEP);
+    if(mapCommit(data, committed, to - committed) != PUREMAP_SUCCESS)
+    {
+        CORE_ABORT("history memory commit failed", 0);
+    }
+    committed = to;
+}
+
 void CaptureMemory::freePacketMemory()
 {
-    pMemory->free(data);
+    if(reserved)
+    {
+        mapUnreserve(data, memoryMax);
+    }
+    else
+    {
+        pMemory->free(data);
+    }
+    data      = 0;
+    committed = 0;
 }
 
 uint CaptureMemory::resize(ularge iframe, ularge isize)
@@ -205,7 +295,7 @@ uint CaptureMemory::save(const char* path, uint& progress, uint& active)
     {
         progress = (i * 100) / header.frameSize;
         active = 1;
-        SDL_RWwrite(ctxWrite, ringFrame.getData() + i, sizeof(CaptureFrame), 1);
+        SDL_RWwrite(ctxWrite, ringFrame.getData() + i, CAPTURE_FRAME_LEGACY, 1);
     }
     // packet
     for(int i = 0; i < header.packetSize; i++)
@@ -268,7 +358,8 @@ uint CaptureMemory::load(const char* path, uint& progress, uint& active)
     {
         progress = (i * 100) / header.frameSize;
         active = 1;
-        SDL_RWread(ctxRead, (void*)(framePtr + i), sizeof(CaptureFrame), 1);
+        SDL_RWread(ctxRead, (void*)(framePtr + i), CAPTURE_FRAME_LEGACY, 1);
+        framePtr[i].time = 0;
     }
     // reallocate packet memory
     PacketData* packetPtr = (PacketData*)pMemory->reallocate((void*)ringPacket.getData(), header.packetSize * sizeof(PacketData));
@@ -296,6 +387,7 @@ uint CaptureMemory::load(const char* path, uint& progress, uint& active)
         active   = 1;
         PacketData packet;
         readRing.read(packet);
+        commit(packet.offset + packet.size);
         ularge ret = SDL_RWread(ctxRead, (void*)(data + packet.offset), packet.size, 1);
         if(ret != 1)
         {
@@ -376,7 +468,7 @@ uint CaptureSSD::save(const char* path, uint& progress, uint& active)
     {
         progress = (i * 100) / header.frameSize;
         active   = 1;
-        SDL_RWwrite(ctxWrite, ringFrame.getData() + i, sizeof(CaptureFrame), 1);
+        SDL_RWwrite(ctxWrite, ringFrame.getData() + i, CAPTURE_FRAME_LEGACY, 1);
     }
     // packet
     for(int i = 0; i < header.packetSize; i++)
@@ -445,7 +537,8 @@ uint CaptureSSD::load(const char* path, uint& progress, uint& active)
     {
         progress = (i * 100) / header.frameSize;
         active   = 1;
-        SDL_RWread(ctxRead, (void*)(framePtr + i), sizeof(CaptureFrame), 1);
+        SDL_RWread(ctxRead, (void*)(framePtr + i), CAPTURE_FRAME_LEGACY, 1);
+        framePtr[i].time = 0;
     }
     // packet
     for(int i = 0; i < header.packetSize; i++)
@@ -511,15 +604,13 @@ uint CaptureSSD::openRead()
 uint CaptureSSD::write(ularge pos, byte* buffer, ularge size)
 {
     SDL_RWseek(ctxWrite, sizeof(CaptureHeader) + ringFrame.getSize()*sizeof(CaptureFrame) + ringPacket.getSize()*sizeof(PacketData) + pos, RW_SEEK_SET);
-    SDL_RWwrite(ctxWrite, buffer, size, 1);
-    return 0;
+    return SDL_RWwrite(ctxWrite, buffer, size, 1) == 1 ? 0 : 1;
 }
 
 uint CaptureSSD::read(ularge pos, byte* buffer, ularge size)
 {
     SDL_RWseek(ctxRead, sizeof(CaptureHeader) + ringFrame.getSize()*sizeof(CaptureFrame) + ringPacket.getSize()*sizeof(PacketData) + pos, RW_SEEK_SET);
-    SDL_RWread(ctxRead, buffer, size, 1);
-    return 0;
+    return SDL_RWread(ctxRead, buffer, size, 1) == 1 ? 0 : 1;
 }
 
 uint CaptureSSD::closeWrite()
@@ -536,6 +627,168 @@ uint CaptureSSD::closeRead()
     return 0;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+//
+// CaptureMapped
+//
+////////////////////////////////////////////////////////////////////////////////
+CaptureMapped::CaptureMapped() : CaptureSSD()
+{
+    mapped = 0;
+    SDL_zero(map);
+    SDL_zero(viewRead);
+    SDL_zero(viewWrite);
+    viewRead.advice  = PUREMAP_RANDOM;
+    viewWrite.advice = PUREMAP_SEQUENTIAL;
+}
+
+ularge CaptureMapped::dataOffset()
+{
+    return sizeof(CaptureHeader) + ringFrame.getSize() * sizeof(CaptureFrame) + ringPacket.getSize() * sizeof(PacketData);
+}
+
+uint CaptureMapped::init(const char* file, ularge size, uint packetSize)
+{
+    release();
+    CaptureSSD::init(file, size, packetSize);
+    if(mapOpen(&map, file, dataOffset() + size, CAPTURE_MAP_WINDOW) == PUREMAP_SUCCESS)
+    {
+        mapped = 1;
+    }
+    else
+    {
+        CORE_MESSAGE("mapping %s failed, falling back to buffered file access\n", file);
+    }
+    return 0;
+}
+
+void CaptureMapped::fallback()
+{
+    CORE_MESSAGE("reserving %s failed, falling back to buffered file access\n", fileName.asChar());
+    release();
+}
+
+void CaptureMapped::release()
+{
+    if(mapped)
+    {
+        mapRelease(&map, &viewRead);
+        mapRelease(&map, &viewWrite);
+        mapClose(&map);
+        mapped = 0;
+    }
+}
+
+uint CaptureMapped::openRead()
+{
+    if(!mapped)
+    {
+        return CaptureSSD::openRead();
+    }
+    return 0;
+}
+
+uint CaptureMapped::openWrite()
+{
+    if(!mapped)
+    {
+        return CaptureSSD::openWrite();
+    }
+    return 0;
+}
+
+uint CaptureMapped::write(ularge pos, byte* buffer, ularge size)
+{
+    if(!mapped)
+    {
+        return CaptureSSD::write(pos, buffer, size);
+    }
+    return mapWrite(&map, &viewWrite, dataOffset() + pos, buffer, size) == PUREMAP_SUCCESS ? 0 : 1;
+}
+
+uint CaptureMapped::read(ularge pos, byte* buffer, ularge size)
+{
+    if(!mapped)
+    {
+        return CaptureSSD::read(pos, buffer, size);
+    }
+    return mapRead(&map, &viewRead, dataOffset() + pos, buffer, size) == PUREMAP_SUCCESS ? 0 : 1;
+}
+
+uint CaptureMapped::closeRead()
+{
+    if(!mapped)
+    {
+        return CaptureSSD::closeRead();
+    }
+    return 0;
+}
+
+uint CaptureMapped::closeWrite()
+{
+    if(!mapped)
+    {
+        return CaptureSSD::closeWrite();
+    }
+    return 0;
+}
+
+uint CaptureMapped::resize(ularge memory, ularge reserved)
+{
+    if(mapped)
+    {
+        lock();
+        mapRelease(&map, &viewRead);
+        mapRelease(&map, &viewWrite);
+        unlock();
+    }
+    CaptureSSD::resize(memory, reserved);
+    if(mapped)
+    {
+        lock();
+        if(mapResize(&map, dataOffset() + memoryMax) != PUREMAP_SUCCESS)
+        {
+            fallback();
+        }
+        unlock();
+    }
+    return 0;
+}
+
+uint CaptureMapped::save(const char* path, uint& progress, uint& active)
+{
+    if(mapped)
+    {
+        lock();
+        mapRelease(&map, &viewRead);
+        mapRelease(&map, &viewWrite);
+        unlock();
+    }
+    return CaptureSSD::save(path, progress, active);
+}
+
+uint CaptureMapped::load(const char* path, uint& progress, uint& active)
+{
+    if(mapped)
+    {
+        lock();
+        mapRelease(&map, &viewRead);
+        mapRelease(&map, &viewWrite);
+        unlock();
+    }
+    uint ret = CaptureSSD::load(path, progress, active);
+    if(mapped)
+    {
+        lock();
+        if(mapResize(&map, dataOffset() + memoryMax) != PUREMAP_SUCCESS)
+        {
+            fallback();
+        }
+        unlock();
+    }
+    return ret;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 //
 // CaptureBuffer
@@ -551,11 +804,14 @@ CaptureBuffer::CaptureBuffer(byte* buff1, uint size1, byte* buff2, uint size2)
     rldSize          = size2;
     rldWritten       = 0;
     rldStart         = 0;
+    rldDecoded       = 0;
+    rldTime          = 0;
     SDL_memset(&syncHeader1, 0, sizeof(SFrameHeader1));
     SDL_memset(&syncHeader2, 0, sizeof(SFrameHeader2));
     SDL_AtomicSet(&lastFrame, 0);
     SDL_AtomicSet(&drawState, DRAWSTATE_DRAW);
     SDL_AtomicSet(&drawFrame, 0);
+    SDL_AtomicSet(&generation, 0);
 }
 
 void CaptureBuffer::clear()
@@ -566,6 +822,13 @@ void CaptureBuffer::clear()
     history->ringFrame.clear();
     history->ringPacket.clear();
     history->unlock();
+    newGeneration();
+}
+
+void CaptureBuffer::newGeneration()
+{
+    // frames of a cleared or loaded history can look exactly like the old ones, legacy files have no time
+    SDL_AtomicAdd(&generation, 1);
 }
 
 uint CaptureBuffer::getFrameSize(byte* buffer, uint version, uint headerSize, uint data, uint packet)
@@ -719,6 +982,7 @@ uint CaptureBuffer::uncompressNew()
    history->lock();
       CaptureFrame captureFrame;
       captureFrame.packetStart = history->ringPacket.getWrite();
+      captureFrame.time        = ularge(double(SDL_GetPerformanceCounter()) * 1000000.0 / double(SDL_GetPerformanceFrequency()));
       int nextWrite = history->ringFrame.getWrite();
       SDL_AtomicSet(&lastFrame, nextWrite);
       SDL_AtomicSet(&drawFrame, nextWrite);
@@ -740,45 +1004,10 @@ uint CaptureBuffer::uncompress(byte* buffer, uint received, uint transfered, uin
     if(compressionType > 0 && received >= uint(headerSize) && version == 2)
     {
         // rle uncompress
-        byte* compressedStart = buffer;
-        uint  compressedSize  = transfered;
-        for(uint i = 0; i < compressedSize; i++)
-        {
-            byte repeat = compressedStart[i];
-            if(repeat > 128)
-            {
-                uint count = 128 - repeat;
-                for(uint j = 0; j < count; j++)
-                {
-                    uint index = i + j + 1;
-                    if(index < compressedSize)
-                    {
-                        if(rldWritten < rldSize)
-                        {
-                            rldPtr[rldWritten] = compressedStart[index];
-                            rldWritten++;
-                        }
-                    }
-                }
-            }
-            else
-            {
-                uint count = repeat;
-                uint  index = i + 1;
-                if(index < compressedSize)
-                {
-                    byte value = compressedStart[index];
-                    for(uint j = 0; j < count; j++)
-                    {
-                        if(rldWritten < rldSize)
-                        {
-                            rldPtr[rldWritten] = value;
-                            rldWritten++;
-                        }
-                    }
-                }
-            }
-        }
+        ularge start = SDL_GetPerformanceCounter();
+        rldWritten = rleDecode(rldPtr, rldSize, buffer, transfered);
+        rldDecoded += rldWritten;
+        rldTime    += double(SDL_GetPerformanceCounter() - start) / double(SDL_GetPerformanceFrequency());
     }
     else
     {
@@ -841,37 +1070,7 @@ uint CaptureBuffer::historyRead(CaptureFrame captureFrame, uint version, uint he
 {
     if(captureFrame.packetCount > 0)
     {
-        // lock
-        history->lock();
-        uint    size = history->ringPacket.getSize();
-        displayRead = 0;
-        SDL_memset(displayPtr, 0, min<ularge>(captureFrame.frameSize, displaySize));
-        history->openRead();
-        for(uint i = 0; i < captureFrame.packetCount; i++)
-        {
-            // safety
-            if(history->ringPacket.isEmpty())
-            {
-                break;
-            }
-            // read
-            PacketData* packetData = history->ringPacket.peek((captureFrame.packetStart + i) % size);
-            history->read(packetData->offset, (byte*)transferPacket.data, packetData->size);
-            // safety
-            uint copySize = packetData->size;
-            if(displayRead + copySize > displaySize)
-            {
-                copySize = displaySize - displayRead;
-            }
-            // copy
-            SDL_memcpy(&displayPtr[displayRead], &transferPacket.data[0], copySize);
-            // read
-            displayRead += copySize;
-            displayRead  = min(displayRead, displaySize);
-        }
-        history->closeRead();
-        // unlock
-        history->unlock();
+        displayRead = historyLoad(captureFrame, displayPtr, displaySize, transferPacket);
         // syncHeader
         if(version == HARDWARE_VERSION_1)
         {
@@ -889,11 +1088,77 @@ uint CaptureBuffer::historyRead(CaptureFrame captureFrame, uint version, uint he
     return displayRead;
 }
 
+uint CaptureBuffer::historyLoad(CaptureFrame& captureFrame, byte* buffer, ularge bufferSize, CapturePacket& bounce, ularge slice)
+{
+    ularge bufferRead = 0;
+    ularge sliceRead  = 0;
+    // lock
+    history->lock();
+    uint    size = history->ringPacket.getSize();
+    SDL_memset(buffer, 0, min<ularge>(captureFrame.frameSize, bufferSize));
+    history->openRead();
+    for(uint i = 0; i < captureFrame.packetCount; i++)
+    {
+        // let other readers in between slices
+        if(slice && sliceRead >= slice)
+        {
+            history->closeRead();
+            history->unlock();
+            history->lock();
+            history->openRead();
+            size      = history->ringPacket.getSize();
+            sliceRead = 0;
+        }
+        // safety
+        if(history->ringPacket.isEmpty())
+        {
+            break;
+        }
+        // read
+        PacketData* packetData = history->ringPacket.peek((captureFrame.packetStart + i) % size);
+        if(history->read(packetData->offset, (byte*)bounce.data, packetData->size) != 0)
+        {
+            break;
+        }
+        // safety
+        uint copySize = packetData->size;
+        if(bufferRead + copySize > bufferSize)
+        {
+            copySize = bufferSize - bufferRead;
+        }
+        // copy
+        SDL_memcpy(&buffer[bufferRead], &bounce.data[0], copySize);
+        // read
+        bufferRead += copySize;
+        bufferRead  = min(bufferRead, bufferSize);
+        sliceRead  += packetData->size;
+    }
+    history->closeRead();
+    // unlock
+    history->unlock();
+    return uint(bufferRead);
+}
+
+void CaptureBuffer::displayKey(DisplayKey& key)
+{
+    key.zoom     = pOsciloscope->signalZoom;
+    key.position = pOsciloscope->signalPosition;
+    key.view3d   = pOsciloscope->window.fftDigital.is(VIEW_SELECT_OSC_3D) ? 1 : 0;
+    key.etsIndex = pOsciloscope->settings.getHardware()->fpgaEtsIndex;
+    key.generation = uint(SDL_AtomicGet(&generation));
+}
+
 uint CaptureBuffer::display(OsciloscopeFrame& frame, int version, int headerSize, int dataSize, int packetSize)
 {
-    OsciloscopeCamera camera   = pOsciloscope->cameraOsc;
-    double signalZoom          = pOsciloscope->signalZoom;
-    double signalPosition      = pOsciloscope->signalPosition;
+    DisplayKey key;
+    displayKey(key);
+    return display(frame, displayPtr, displayRead, key, version, headerSize, dataSize, packetSize);
+}
+
+uint CaptureBuffer::display(OsciloscopeFrame& frame, byte* buffer, ularge bufferRead, DisplayKey& key, int version, int headerSize, int dataSize, int packetSize)
+{
+    double signalZoom          = key.zoom;
+    double signalPosition      = key.position;
     double signalMin           = -0.5 / signalZoom;
     double signalMax           =  0.5 / signalZoom;
     double signalDelta         = signalMax - signalMin;
@@ -902,14 +1167,14 @@ uint CaptureBuffer::display(OsciloscopeFrame& frame, int version, int headerSize
     ularge      captureStart = 0;
     ularge       captureFreq = 0;
     // samples
-    uint frameSamples = getFrameSamples(displayPtr, version, headerSize, dataSize, packetSize);
+    uint frameSamples = getFrameSamples(buffer, version, headerSize, dataSize, packetSize);
     uint oneSampleBytes = getOneSampleBytes(version);
     // samples
-    if(frameSamples > 0 && displayRead > uint(headerSize))
+    if(frameSamples > 0 && bufferRead > uint(headerSize))
     {
         // data
-        byte* dataStart = displayPtr + uint(headerSize);
-        uint  dataBytes = displayRead - uint(headerSize);
+        byte* dataStart = buffer + uint(headerSize);
+        uint  dataBytes = bufferRead - uint(headerSize);
         frameSamples += extraEdgeSamples;
         // increment
         double   dSamples = double(frameSamples) * signalZoom;
@@ -922,7 +1187,7 @@ uint CaptureBuffer::display(OsciloscopeFrame& frame, int version, int headerSize
         uint signalHide = 0;
         if(visibility)
         {
-            if(pOsciloscope->window.fftDigital.is(VIEW_SELECT_OSC_3D))
+            if(key.view3d)
             {
                 signalPosNormalized = 0.5;
                 signalZoom = 1.0;
@@ -950,150 +1215,18 @@ uint CaptureBuffer::display(OsciloscopeFrame& frame, int version, int headerSize
         sampleCount = clamp<uint>(sampleCount, 0, frameSamples);
         // safety, this must be last becouse of zoom
         sampleStart = clamp<int>(sampleStart, 0, frameSamples);
-        // clear frame
-        frame.clear();
         // must always start rendering at the sample, so extra edge samples are needed
-        float sampleDelta = 1.0f / max<float>(1.0, (sampleCount));
         frame.edgeOffset = signalOffset;
         frame.edgeSample = extraEdgeSamples;
-        // samples loop
-        ishort minCh0 = 512; // todo: change with new firmware
-        ishort minCh1 = 512;
-        ishort maxCh0 = -512;
-        ishort maxCh1 = -512;
-        ishort digital = 0;
-        byte attribute = 0;
-        double inc = 0.f;
-        for(uint i = sampleStart; i < (sampleStart + sampleCount);)
-        {
-            uint offset = 0;
-            ushort ch0 = 0;
-            ushort ch1 = 0;
-            ushort dig = 0;
-            if(version == 1)
-            {
-                offset = i * 6;
-                ch0 = *(ushort*)(dataStart + offset + 0);
-                ch1 = *(ushort*)(dataStart + offset + 2);
-                dig = *(ushort*)(dataStart + offset + 4);
-            }
-            if(version == 2)
-            {
-                offset = i * 4;
-                byte byte0 = *(dataStart + offset + 0);
-                byte byte1 = *(dataStart + offset + 1);
-                byte byte2 = *(dataStart + offset + 2);
-                byte byte3 = *(dataStart + offset + 3);
-                ch0 |= byte0;
-                ch0 = ch0 << 2;
-                ch0 |= ((byte1 >> 6) & 0x3F);
-                ch1 |= (byte1 & 0x3F);
-                ch1 = ch1 << 4;
-                ch1 |= ((byte2 >> 4) & 0xF);
-                dig |= (byte2 & 0xF);
-                dig = dig << 8;
-                dig |= byte3;
-            }
-            // attribute
-            if(version == 1)
-            {
-                if(ch0 & 0x8000)
-                {
-                    attribute |= FRAME_ATTRIBUTE_HIDE_SIGNAL;
-                }
-                if(ch0 & 0x4000)
-                {
-                    attribute |= FRAME_ATTRIBUTE_TRIGGERED_LED;
-                }
-                if(ch0 & 0x2000)
-                {
-                    attribute |= FRAME_ATTRIBUTE_ROLL_DISPLAY;
-                }
-            }
-            // channels
-            ishort singedShort0 = leadBitShift(ch0 & 0x000003FF);
-            ishort singedShort1 = leadBitShift(ch1 & 0x000003FF);
-            // analog
-            minCh0 = min(minCh0, singedShort0);
-            maxCh0 = max(maxCh0, singedShort0);
-            minCh1 = min(minCh1, singedShort1);
-            maxCh1 = max(maxCh1, singedShort1);
-            // digital
-            digital = digital | dig; // todo: user interface function choice
-            // display sample ?
-            bool display = false;
-            if(cameraIncrement < 1.0)
-            {
-                display = true;
-                i++;
-            }
-            if(cameraIncrement >= 1.0)
-            {
-                uint iInc = uint(cameraIncrement);
-                if(i % iInc == 0)
-                {
-                    display = true;
-                    i += iInc;
-                }
-                else
-                {
-                    i++;
-                }
-            }
-            if(display)
-            {
-                // mix / max -> value
-                ishort value0 = 0;
-                ishort value1 = 0;
-                if(-minCh0 > maxCh0)
-                {
-                    value0 = minCh0;
-                }
-                else
-                {
-                    value0 = maxCh0;
-                }
-                if(-minCh1 > maxCh1)
-                {
-                    value1 = minCh1;
-                }
-                else
-                {
-                    value1 = maxCh1;
-                }
-                // analog
-                if(frame.analog[0].getCount() < NUM_SAMPLES)
-                {
-                    frame.analog[0].pushBack(value0);
-                }
-                if(frame.analog[1].getCount() < NUM_SAMPLES)
-                {
-                    frame.analog[1].pushBack(value1);
-                }
-                // attribute
-                if(frame.attr.getCount() < NUM_SAMPLES)
-                {
-                    frame.attr.pushBack(attribute);
-                }
-                // digital
-                if(frame.digital.getCount() < NUM_SAMPLES)
-                {
-                    frame.digital.pushBack(digital);
-                }
-                minCh0 = 512; // todo: change with new firmware
-                minCh1 = 512;
-                maxCh0 = -512;
-                maxCh1 = -512;
-                digital = 0;
-                attribute = 0;
-            }
-        }
+        // unpack and decimate
+        uint step = cameraIncrement < 1.0 ? 1 : uint(cameraIncrement);
+        decodeDisplayFrame(frame, dataStart, version, sampleStart, sampleStart + sampleCount, step);
         // ets & trigger
-        int index = clamp<int>(pOsciloscope->settings.getHardware()->fpgaEtsIndex, 0, headerSize);
-        frame.ets = (displayPtr)[index];
+        int index = clamp<int>(key.etsIndex, 0, headerSize);
+        frame.ets = (buffer)[index];
         // temperature
-        unsigned short adc0 = (displayPtr)[6] << 8;
-        unsigned short adc1 = (displayPtr)[7];
+        unsigned short adc0 = (buffer)[6] << 8;
+        unsigned short adc1 = (buffer)[7];
         unsigned short adc = adc1 | adc0;
         float temperature = ((float(adc) * 503.975) / 4096) - 273.15;
         frame.debug.setCount(2464);
@@ -1101,10 +1234,10 @@ uint CaptureBuffer::display(OsciloscopeFrame& frame, int version, int headerSize
         frame.debug[1] = temperature;
         for(int i = 0; i < 62; i++)
         {
-            frame.debug[i + 2] = displayPtr[i + 8];
+            frame.debug[i + 2] = buffer[i + 8];
         }
         // trigger
-        frame.triggerTime = *(ularge*)(displayPtr + 2);
+        frame.triggerTime = *(ularge*)(buffer + 2);
         if(frame.triggerTime == 0)
         {
             frame.firstFrame = SDL_GetPerformanceCounter();
@@ -1148,6 +1281,325 @@ uint CaptureBuffer::captureFrame(CaptureFrame& frame, uint index)
     return 0;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+//
+// HistoryCache
+//
+////////////////////////////////////////////////////////////////////////////////
+HistoryCache::HistoryCache()
+{
+    spinLock   = 0;
+    entry      = 0;
+    count      = 0;
+    clock      = 0;
+    lastIndex  = ~ularge(0);
+    direction  = 1;
+    stride     = 1;
+    thread     = 0;
+    buffer     = 0;
+    bufferSize = 0;
+    bounce     = 0;
+    SDL_AtomicSet(&active, 0);
+    SDL_AtomicSet(&hits, 0);
+    SDL_AtomicSet(&misses, 0);
+    SDL_AtomicSet(&prefetched, 0);
+}
+
+void HistoryCache::init(uint entryCount)
+{
+    release();
+    count  = entryCount;
+    entry  = (HistoryCacheEntry*)pMemory->allocate(count * sizeof(HistoryCacheEntry));
+    bounce = (CapturePacket*)pMemory->allocate(sizeof(CapturePacket));
+    SDL_memset(entry, 0, count * sizeof(HistoryCacheEntry));
+    request.init(requestData, HISTORY_CACHE_REQUEST, 1);
+}
+
+void HistoryCache::release()
+{
+    request.destroy();
+    pMemory->free(entry);
+    pMemory->free(bounce);
+    pMemory->free(buffer);
+    entry      = 0;
+    bounce     = 0;
+    buffer     = 0;
+    bufferSize = 0;
+    count      = 0;
+}
+
+int SDLCALL HistoryPrefetchThreadFunction(void* data)
+{
+    HistoryCache* cache = (HistoryCache*)data;
+    pOsciloscope->setThreadPriority(THREAD_ID_CAPTURE);
+    while(SDL_AtomicGet(&cache->active))
+    {
+        ularge index = 0;
+        cache->request.wait(CAPTURE_WAIT_MS);
+        while(SDL_AtomicGet(&cache->active) && cache->request.pop(index))
+        {
+            cache->prefetch(index);
+        }
+    }
+    pMemory->threadFlush();
+    return 0;
+}
+
+void HistoryCache::start()
+{
+    SDL_AtomicSet(&active, 1);
+    thread = SDL_CreateThread(HistoryPrefetchThreadFunction, "HistoryPrefetch", this);
+}
+
+void HistoryCache::stop()
+{
+    int status = 0;
+    SDL_AtomicSet(&active, 0);
+    SDL_WaitThread(thread, &status);
+    thread = 0;
+}
+
+void HistoryCache::clear()
+{
+    SDL_AtomicLock(&spinLock);
+    for(uint i = 0; i < count; i++)
+    {
+        if(entry[i].state == hcsReady)
+        {
+            entry[i].state = hcsFree;
+        }
+    }
+    lastIndex = ~ularge(0);
+    SDL_AtomicUnlock(&spinLock);
+}
+
+void HistoryCache::setKey(DisplayKey& displayKey)
+{
+    SDL_AtomicLock(&spinLock);
+    if(!key.equal(displayKey))
+    {
+        // frames decoded with other settings will not be asked for again
+        key = displayKey;
+        for(uint i = 0; i < count; i++)
+        {
+            if(entry[i].state == hcsReady)
+            {
+                entry[i].state = hcsFree;
+            }
+        }
+    }
+    SDL_AtomicUnlock(&spinLock);
+}
+
+HistoryCacheEntry* HistoryCache::find(ularge index, CaptureFrame& capture)
+{
+    for(uint i = 0; i < count; i++)
+    {
+        HistoryCacheEntry& e = entry[i];
+        if(e.state == hcsReady && e.index == index && e.capture.equal(capture) && e.key.equal(key))
+        {
+            return &e;
+        }
+    }
+    return 0;
+}
+
+HistoryCacheEntry* HistoryCache::findIndex(ularge index)
+{
+    for(uint i = 0; i < count; i++)
+    {
+        HistoryCacheEntry& e = entry[i];
+        if(e.state != hcsFree && e.index == index && e.key.equal(key))
+        {
+            return &e;
+        }
+    }
+    return 0;
+}
+
+HistoryCacheEntry* HistoryCache::evict()
+{
+    HistoryCacheEntry* oldest = 0;
+    for(uint i = 0; i < count; i++)
+    {
+        HistoryCacheEntry& e = entry[i];
+        if(e.state == hcsFree)
+        {
+            return &e;
+        }
+        if(e.state == hcsReady && (!oldest || e.used < oldest->used))
+        {
+            oldest = &e;
+        }
+    }
+    return oldest;
+}
+
+uint HistoryCache::lookup(ularge index, CaptureFrame& capture, OsciloscopeFrame& frame)
+{
+    uint found = 0;
+    SDL_AtomicLock(&spinLock);
+    HistoryCacheEntry* e = find(index, capture);
+    if(e)
+    {
+        e->used = ++clock;
+        frame   = e->frame;
+        // the user interface follows the hardware state of the displayed frame
+        if(capture.version == HARDWARE_VERSION_1)
+        {
+            pOsciloscope->captureBuffer->syncHeader1 = pOsciloscope->captureBuffer->getHeader1(e->header, uint(capture.header));
+        }
+        if(capture.version == HARDWARE_VERSION_2)
+        {
+            pOsciloscope->captureBuffer->syncHeader2 = pOsciloscope->captureBuffer->getHeader2(e->header, uint(capture.header));
+        }
+        found = 1;
+    }
+    SDL_AtomicUnlock(&spinLock);
+    SDL_AtomicAdd(found ? &hits : &misses, 1);
+    if(found)
+    {
+        frame.thisFrame = SDL_GetPerformanceCounter();
+    }
+    return found;
+}
+
+void HistoryCache::insert(ularge index, CaptureFrame& capture, OsciloscopeFrame& frame, byte* header)
+{
+    SDL_AtomicLock(&spinLock);
+    HistoryCacheEntry* e = find(index, capture);
+    if(!e)
+    {
+        e = evict();
+    }
+    if(e)
+    {
+        e->state   = hcsReady;
+        e->index   = index;
+        e->used    = ++clock;
+        e->capture = capture;
+        e->key     = key;
+        e->frame   = frame;
+        SDL_memcpy(e->header, header, min<ularge>(capture.header, HISTORY_CACHE_HEADER));
+    }
+    SDL_AtomicUnlock(&spinLock);
+}
+
+void HistoryCache::predict(ularge index, ularge frameCount, int wrap)
+{
+    if(!frameCount || index == lastIndex)
+    {
+        return;
+    }
+    // direction and frames per step, playback wraps at the end of history
+    if(lastIndex < frameCount)
+    {
+        ilarge delta = ilarge(index) - ilarge(lastIndex);
+        if(wrap && delta < -ilarge(frameCount / 2))
+        {
+            delta += frameCount;
+        }
+        if(wrap && delta > ilarge(frameCount / 2))
+        {
+            delta -= frameCount;
+        }
+        if(delta != 0)
+        {
+            ularge step = ularge(delta > 0 ? delta : -delta);
+            direction = delta > 0 ? 1 : -1;
+            stride    = uint((ularge(stride) * 3 + step + 3) / 4);
+        }
+    }
+    lastIndex = index;
+    // ask only for frames that are not decoded or being decoded, the prefetch
+    // thread checks again against the capture frame so this can be cheap
+    for(uint k = 1; k <= HISTORY_CACHE_PREFETCH; k++)
+    {
+        ilarge next = ilarge(index) + ilarge(direction) * ilarge(stride) * ilarge(k);
+        if(wrap)
+        {
+            next = ((next % ilarge(frameCount)) + ilarge(frameCount)) % ilarge(frameCount);
+        }
+        else if(next < 0 || next >= ilarge(frameCount))
+        {
+            break;
+        }
+        SDL_AtomicLock(&spinLock);
+        uint cached = findIndex(ularge(next)) != 0;
+        SDL_AtomicUnlock(&spinLock);
+        if(!cached && !request.push(ularge(next)))
+        {
+            break;
+        }
+    }
+}
+
+uint HistoryCache::prefetch(ularge index)
+{
+    CaptureBuffer* captureBuffer = pOsciloscope->captureBuffer;
+    if(index >= captureBuffer->captureFrameCount())
+    {
+        return 0;
+    }
+    CaptureFrame capture;
+    captureBuffer->captureFrame(capture, uint(index));
+    if(capture.packetCount == 0)
+    {
+        return 0;
+    }
+    // claim a slot, it stays invisible to lookup while loading
+    DisplayKey         loadKey;
+    HistoryCacheEntry* e = 0;
+    SDL_AtomicLock(&spinLock);
+    loadKey = key;
+    if(!find(index, capture))
+    {
+        e = evict();
+        if(e)
+        {
+            e->state = hcsLoading;
+            e->index = index;
+            e->key   = loadKey;
+        }
+    }
+    SDL_AtomicUnlock(&spinLock);
+    if(!e)
+    {
+        return 0;
+    }
+    // read buffer grows to the largest frame seen
+    ularge size = min<ularge>(max<ularge>(capture.frameSize, capture.packetCount * capture.packet), SCOPEFUN_FRAME_MEMORY);
+    if(size > bufferSize)
+    {
+        buffer     = (byte*)pMemory->reallocate(buffer, size);
+        bufferSize = size;
+    }
+    ularge read      = captureBuffer->historyLoad(capture, buffer, bufferSize, *bounce, HISTORY_CACHE_SLICE);
+    uint   displayed = captureBuffer->display(e->frame, buffer, read, loadKey, int(capture.version), int(capture.header), int(capture.data), int(capture.packet));
+    SDL_memcpy(e->header, buffer, min<ularge>(read, min<ularge>(capture.header, HISTORY_CACHE_HEADER)));
+    // history may have moved on while the lock was released between slices
+    CaptureFrame check;
+    captureBuffer->captureFrame(check, uint(index));
+    if(!check.equal(capture))
+    {
+        displayed = 0;
+    }
+    // publish, unless the display settings changed meanwhile
+    SDL_AtomicLock(&spinLock);
+    e->state = hcsFree;
+    if(displayed && loadKey.equal(key))
+    {
+        e->state   = hcsReady;
+        e->index   = index;
+        e->used    = ++clock;
+        e->capture = capture;
+        e->key     = loadKey;
+    }
+    SDL_AtomicUnlock(&spinLock);
+    SDL_AtomicAdd(&prefetched, 1);
+    return displayed;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 //
 // OsciloscopeFrame
@@ -1701,6 +2153,117 @@ void OsciloscopeFunction::parse()
     }
 }
 
+////////////////////////////////////////////////////////////////////////////////
+//
+// FunctionProgram
+//
+////////////////////////////////////////////////////////////////////////////////
+FunctionProgram::FunctionProgram()
+{
+    compiled = 0;
+    result.source = fsConst;
+    result.slot   = 0;
+    result.value  = 0;
+}
+
+bool FunctionProgram::changed(OsciloscopeFunction& function)
+{
+    // the interpreter stores ch0 / ch1 samples in the postfix values, only constants count
+    Array<OscToken, 128>& postfix = function.postfix;
+    if(postfix.getCount() != key.getCount())
+    {
+        return true;
+    }
+    for(int i = 0; i < postfix.getCount(); i++)
+    {
+        if(postfix[i].type != key[i].type)
+        {
+            return true;
+        }
+        if((postfix[i].type == tNumber || postfix[i].type == tDouble) && postfix[i].value != key[i].value)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+void FunctionProgram::compile(OsciloscopeFunction& function)
+{
+    // run the postfix expression on operands instead of values, the interpreter
+    // pushes 0 without popping when an operator is short of parameters
+    Array<OscToken, 128>& postfix = function.postfix;
+    key = postfix;
+    Array<FunctionOperand, 128> operands;
+    FunctionOperand zero;
+    zero.source = fsConst;
+    zero.slot   = 0;
+    zero.value  = 0;
+    code.setCount(0);
+    compiled = 1;
+    for(int i = 0; i < postfix.getCount(); i++)
+    {
+        OscToken        token = postfix[i];
+        FunctionOperand operand = zero;
+        switch(token.type)
+        {
+            case tCh0:
+                operand.source = fsCh0;
+                break;
+            case tCh1:
+                operand.source = fsCh1;
+                break;
+            case tNumber:
+            case tDouble:
+                operand.value = token.value;
+                break;
+            default:
+                {
+                    int unary = token.type == tSin || token.type == tCos;
+                    if(operands.getCount() < (unary ? 1 : 2))
+                    {
+                        break;
+                    }
+                    if(uint(token.type) >= uint(tCh0))
+                    {
+                        // unmatched parenthesis evaluates as 0
+                        operands.popBack();
+                        operands.popBack();
+                        break;
+                    }
+                    FunctionCode fc;
+                    fc.op = token.type;
+                    fc.a  = operands.last();
+                    operands.popBack();
+                    fc.b  = fc.a;
+                    if(!unary)
+                    {
+                        fc.b = operands.last();
+                        operands.popBack();
+                    }
+                    if(fc.a.source == fsConst && fc.b.source == fsConst)
+                    {
+                        operand.value = unary ? token.evaluate(fc.a.value) : token.evaluate(fc.a.value, fc.b.value);
+                        break;
+                    }
+                    // result goes to the slot of its stack position
+                    fc.dst = operands.getCount();
+                    if(fc.dst >= FUNCTION_SLOTS || code.getCount() >= FUNCTION_CODE)
+                    {
+                        compiled = 0;
+                        return;
+                    }
+                    code.pushBack(fc);
+                    operand.source = fsSlot;
+                    operand.slot   = fc.dst;
+                }
+                break;
+        };
+        operands.pushBack(operand);
+    }
+    result = operands.getCount() ? operands.last() : zero;
+}
+
 void OsciloscopeFunction::tokenize(String in)
 {
     String input;
@@ -1916,6 +2479,113 @@ void OsciloscopeFunction::tokenize(String in)
     }
 }
 
+template<int OP> inline double functionOp(double a, double b)
+{
+    switch(OP)
+    {
+        case tAdd:
+            return a + b;
+        case tSub:
+            return a - b;
+        case tMul:
+            return a * b;
+        case tDiv:
+            return a / b;
+        case tMod:
+            return (double)((int)a % max<int>(1, (int)b));
+        case tMin:
+            return a < b ? a : b;
+        case tMax:
+            return a > b ? a : b;
+        case tSin:
+            return sin(a);
+        case tCos:
+            return cos(a);
+    };
+    return 0;
+}
+
+template<int OP, int AK, int BK> void functionKernel(double* out, const double* a, const double* b, uint n)
+{
+    const double ka = a[0];
+    const double kb = b[0];
+    for(uint i = 0; i < n; i++)
+    {
+        out[i] = functionOp<OP>(AK ? ka : a[i], BK ? kb : b[i]);
+    }
+}
+
+typedef void (*FunctionKernel)(double* out, const double* a, const double* b, uint n);
+
+#define FUNCTION_KERNEL(op) { { functionKernel<op, 0, 0>, functionKernel<op, 0, 1> }, { functionKernel<op, 1, 0>, functionKernel<op, 1, 1> } }
+
+// [op][a is constant][b is constant]
+static FunctionKernel functionKernels[tCh0][2][2] =
+{
+    FUNCTION_KERNEL(tAdd),
+    FUNCTION_KERNEL(tSub),
+    FUNCTION_KERNEL(tMul),
+    FUNCTION_KERNEL(tDiv),
+    FUNCTION_KERNEL(tMod),
+    FUNCTION_KERNEL(tMin),
+    FUNCTION_KERNEL(tMax),
+    FUNCTION_KERNEL(tSin),
+    FUNCTION_KERNEL(tCos),
+};
+
+inline const double* functionInput(FunctionOperand& operand, double* slot, const double* ch0, const double* ch1)
+{
+    switch(operand.source)
+    {
+        case fsCh0:
+            return ch0;
+        case fsCh1:
+            return ch1;
+        case fsConst:
+            return &operand.value;
+        default:
+            return slot + operand.slot * FUNCTION_BLOCK;
+    };
+}
+
+void FunctionProgram::evaluate(OsciloscopeFunction& function, const double* ch0, const double* ch1, double* out, uint count)
+{
+    if(!compiled)
+    {
+        for(uint i = 0; i < count; i++)
+        {
+            out[i] = function.evaluate(ch0[i], ch1[i]);
+        }
+        return;
+    }
+    double slot[FUNCTION_SLOTS * FUNCTION_BLOCK];
+    for(uint start = 0; start < count; start += FUNCTION_BLOCK)
+    {
+        uint n = min<uint>(FUNCTION_BLOCK, count - start);
+        const double* in0 = ch0 + start;
+        const double* in1 = ch1 + start;
+        for(int i = 0; i < code.getCount(); i++)
+        {
+            FunctionCode& fc = code[i];
+            const double* a = functionInput(fc.a, slot, in0, in1);
+            const double* b = functionInput(fc.b, slot, in0, in1);
+            functionKernels[fc.op][fc.a.source == fsConst][fc.b.source == fsConst](slot + fc.dst * FUNCTION_BLOCK, a, b, n);
+        }
+        const double* r = functionInput(result, slot, in0, in1);
+        if(result.source == fsConst)
+        {
+            for(uint i = 0; i < n; i++)
+            {
+                out[start + i] = result.value;
+            }
+        }
+        else
+        {
+            SDL_memcpy(out + start, r, n * sizeof(double));
+        }
+    }
+}
+
 double OsciloscopeFunction::evaluate(double ch0, double ch1)
 {
     for(int i = 0; i < postfix.getCount(); i++)
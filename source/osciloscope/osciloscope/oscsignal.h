@@ -24,6 +24,7 @@
 #define MAXOSCVALUE    511.f
 #define NUM_SAMPLES    10000
 #define NUM_FFT        1048576
+#define FFT_SOURCES    3
 #define CAPTURE_BUFFER                62464
 #define CAPTURE_BUFFER_HEADER          2048
 #define CAPTURE_BUFFER_PADDING          416
@@ -122,16 +123,31 @@ public:
     double* aRe;
     double* aIm;
     double* aAmpl;
+public:
+    // amplitude spectrum per source ( channel0, channel1, function ) shared by measure and render
+    double* aSpectrum[FFT_SOURCES];
+    ularge  spectrumHash[FFT_SOURCES];
+    iint    spectrumSize[FFT_SOURCES];
 public:
     void init()
     {
         aRe   = (double*)pMemory->allocate(NUM_FFT * sizeof(double));
         aIm   = (double*)pMemory->allocate(NUM_FFT * sizeof(double));
         aAmpl = (double*)pMemory->allocate(NUM_FFT * sizeof(double));
+        for(int i = 0; i < FFT_SOURCES; i++)
+        {
+            aSpectrum[i] = (double*)pMemory->allocate((NUM_FFT / 2 + 1) * sizeof(double));
+        }
+        clear();
     }
 
     void clear()
     {
+        for(int i = 0; i < FFT_SOURCES; i++)
+        {
+            spectrumHash[i] = 0;
+            spectrumSize[i] = 0;
+        }
     }
 };
 
@@ -185,6 +201,62 @@ public:
     double         evaluate(double ch0, double ch1);
 };
 
+////////////////////////////////////////////////////////////////////////////////
+//
+// FunctionProgram
+//
+// The postfix expression of an OsciloscopeFunction compiled to instructions
+// that each run one kernel over a block of samples. Operands are read straight
+// from ch0 / ch1 or taken as constants, so only intermediate results need a
+// slot. Constant sub expressions are folded at compile time. Each renderer
+// keeps its own program and rebuilds it when the expression changes, WndMain
+// and slot files only carry the expression.
+//
+////////////////////////////////////////////////////////////////////////////////
+#define FUNCTION_BLOCK  64
+#define FUNCTION_SLOTS  16
+#define FUNCTION_CODE   64
+
+enum FunctionSource
+{
+    fsSlot,
+    fsCh0,
+    fsCh1,
+    fsConst,
+};
+
+class FunctionOperand
+{
+public:
+    FunctionSource source;
+    uint           slot;
+    double         value;
+};
+
+class FunctionCode
+{
+public:
+    Token           op;
+    uint            dst;
+    FunctionOperand a; // top of the stack, first parameter of OscToken::evaluate
+    FunctionOperand b;
+};
+
+class FunctionProgram
+{
+public:
+    Array<OscToken, 128>               key;
+    Array<FunctionCode, FUNCTION_CODE> code;
+    FunctionOperand                    result;
+    int                                compiled;
+public:
+    FunctionProgram();
+public:
+    bool           changed(OsciloscopeFunction& function);
+    void           compile(OsciloscopeFunction& function);
+    void           evaluate(OsciloscopeFunction& function, const double* ch0, const double* ch1, double* out, uint count);
+};
+
 #endif
 ////////////////////////////////////////////////////////////////////////////////
 //
@@ -634,6 +634,7 @@ enum MemoryType
 {
     mtRAM,
     mtSSD,
+    mtMapped,
 };
 
 enum PacketType
@@ -51,6 +51,14 @@ static const wxCmdLineEntryDesc g_cmdLineDesc[] =
     { wxCMD_LINE_USAGE_TEXT, "ip", "ip number", "ip as string, default is 127.0.0.1", wxCMD_LINE_VAL_NUMBER, wxCMD_LINE_PARAM_OPTIONAL },
     { wxCMD_LINE_OPTION,     "port", 0, 0, wxCMD_LINE_VAL_NUMBER, wxCMD_LINE_PARAM_OPTIONAL },
     { wxCMD_LINE_USAGE_TEXT, "port", "port number", "port number, default is 42250", wxCMD_LINE_VAL_NUMBER, wxCMD_LINE_PARAM_OPTIONAL },
+    { wxCMD_LINE_OPTION,     "fp", 0, 0, wxCMD_LINE_VAL_NUMBER, wxCMD_LINE_PARAM_OPTIONAL },
+    { wxCMD_LINE_USAGE_TEXT, "fp", "frame pool", "number of shared capture frames, default is 3", wxCMD_LINE_VAL_NUMBER, wxCMD_LINE_PARAM_OPTIONAL },
+    { wxCMD_LINE_SWITCH,     "ev", 0, 0, wxCMD_LINE_VAL_NONE, wxCMD_LINE_PARAM_OPTIONAL },
+    { wxCMD_LINE_USAGE_TEXT, "ev", "event loop", "serve all clients from one epoll thread instead of a thread per client", wxCMD_LINE_VAL_NONE, wxCMD_LINE_PARAM_OPTIONAL },
+    { wxCMD_LINE_OPTION,     "replay", 0, 0, wxCMD_LINE_VAL_STRING, wxCMD_LINE_PARAM_OPTIONAL },
+    { wxCMD_LINE_USAGE_TEXT, "replay", "replay file", "stream a recorded .osc, raw or .rle frame file instead of usb", wxCMD_LINE_VAL_STRING, wxCMD_LINE_PARAM_OPTIONAL },
+    { wxCMD_LINE_OPTION,     "rate", 0, 0, wxCMD_LINE_VAL_NUMBER, wxCMD_LINE_PARAM_OPTIONAL },
+    { wxCMD_LINE_USAGE_TEXT, "rate", "replay rate", "replay rate in megabytes per second, default is unthrottled", wxCMD_LINE_VAL_NUMBER, wxCMD_LINE_PARAM_OPTIONAL },
     { wxCMD_LINE_NONE }
 };
 
@@ -93,6 +101,26 @@ public:
         {
             pServer->port = 42250;
         }
+        long pool = 0;
+        if(parser.Found(wxT("fp"), &pool))
+        {
+            pServer->framePoolSize = clamp<uint>(pool, 2, SERVER_FRAME_POOL_MAX);
+        }
+        else
+        {
+            pServer->framePoolSize = SERVER_FRAME_POOL;
+        }
+        pServer->eventLoop = parser.Found(wxT("ev"));
+        wxString replay;
+        if(parser.Found(wxT("replay"), &replay))
+        {
+            pServer->replay = replay.data().AsChar();
+        }
+        long rate = 0;
+        if(parser.Found(wxT("rate"), &rate))
+        {
+            pServer->replayRate = uint(clamp<uint>(rate, 0, 2047) * MEGABYTE);
+        }
         return true;
     }
 
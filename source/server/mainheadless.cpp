@@ -0,0 +1,159 @@
+////////////////////////////////////////////////////////////////////////////////
+//    ScopeFun Oscilloscope ( http://www.scopefun.com )
+//    Copyright (C) 2016 - 2019 David Košenina
+//
+//    This file is part of ScopeFun Oscilloscope.
+//
+//    ScopeFun Oscilloscope is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    ScopeFun Oscilloscope is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with this ScopeFun Oscilloscope.  If not, see <http://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////
+#include<core/core.h>
+#include<server/servermanager.h>
+#include<server/serverlog.h>
+
+#include<signal.h>
+
+#define LOG_FLUSH_MS 100
+
+extern void create();
+extern void setup();
+
+////////////////////////////////////////////////////////////////////////////////
+//
+// sfServerHeadless, same server without wxWidgets, log goes to stderr or file
+//
+////////////////////////////////////////////////////////////////////////////////
+SDL_atomic_t running;
+
+void onSignal(int signal)
+{
+    SDL_AtomicSet(&running, 0);
+}
+
+void usage()
+{
+    fprintf(stderr, "usage: sfServerHeadless [options]\n");
+    fprintf(stderr, "  -cc   <count>  max number of client\n");
+    fprintf(stderr, "  -mm   <mb>     max server memory in megabytes\n");
+    fprintf(stderr, "  -ip   <ip>     ip as string, default is 127.0.0.1\n");
+    fprintf(stderr, "  -port <port>   port number, default is 42250\n");
+    fprintf(stderr, "  -fp   <count>  number of shared capture frames, default is 3\n");
+    fprintf(stderr, "  -ev            serve all clients from one epoll thread\n");
+    fprintf(stderr, "  -log  <file>   write log to file instead of stderr\n");
+    fprintf(stderr, "  -replay <file> stream a recorded .osc, raw or .rle frame file instead of usb\n");
+    fprintf(stderr, "  -rate <mb>     replay rate in megabytes per second, default is unthrottled\n");
+}
+
+int main(int argc, char** argv)
+{
+    // create
+    create();
+    // defaults
+    pServer->maxClient     = SCOPEFUN_MAX_CLIENT;
+    pServer->maxMemory     = 16 * MEGABYTE;
+    pServer->ip            = "127.0.0.1";
+    pServer->port          = 42250;
+    pServer->framePoolSize = SERVER_FRAME_POOL;
+    pServer->eventLoop     = false;
+    const char* logFile    = 0;
+    // command line
+    for(int i = 1; i < argc; i++)
+    {
+        bool value = i + 1 < argc;
+        if(SDL_strcmp(argv[i], "-cc") == 0 && value)
+        {
+            pServer->maxClient = clamp<int>(SDL_atoi(argv[++i]), 1, SCOPEFUN_MAX_CLIENT);
+        }
+        else if(SDL_strcmp(argv[i], "-mm") == 0 && value)
+        {
+            pServer->maxMemory = ularge(SDL_atoi(argv[++i])) * MEGABYTE;
+        }
+        else if(SDL_strcmp(argv[i], "-ip") == 0 && value)
+        {
+            pServer->ip = argv[++i];
+        }
+        else if(SDL_strcmp(argv[i], "-port") == 0 && value)
+        {
+            pServer->port = SDL_atoi(argv[++i]);
+        }
+        else if(SDL_strcmp(argv[i], "-fp") == 0 && value)
+        {
+            pServer->framePoolSize = clamp<uint>(SDL_atoi(argv[++i]), 2, SERVER_FRAME_POOL_MAX);
+        }
+        else if(SDL_strcmp(argv[i], "-ev") == 0)
+        {
+            pServer->eventLoop = true;
+        }
+        else if(SDL_strcmp(argv[i], "-log") == 0 && value)
+        {
+            logFile = argv[++i];
+        }
+        else if(SDL_strcmp(argv[i], "-replay") == 0 && value)
+        {
+            pServer->replay = argv[++i];
+        }
+        else if(SDL_strcmp(argv[i], "-rate") == 0 && value)
+        {
+            pServer->replayRate = uint(clamp<uint>(SDL_atoi(argv[++i]), 0, 2047) * MEGABYTE);
+        }
+        else
+        {
+            usage();
+            return 1;
+        }
+    }
+    // log
+    FILE* log = stderr;
+    if(logFile)
+    {
+        log = fopen(logFile, "a");
+        if(!log)
+        {
+            fprintf(stderr, "can't open log file %s\n", logFile);
+            return 1;
+        }
+    }
+    // working dir
+    char* base = SDL_GetBasePath();
+    if(base)
+    {
+        pFormat->setCurrentWorkingPath(base);
+        SDL_free(base);
+    }
+    pFormat->setCurrentWorkingExe(argv[0]);
+    // signals
+    SDL_AtomicSet(&running, 1);
+    signal(SIGINT,  onSignal);
+    signal(SIGTERM, onSignal);
+    // setup
+    setup();
+    // start
+    pManager->start();
+    fprintf(log, "server %s:%d clients %d memory %d MB\n", pServer->ip.asChar(), pServer->port, (int)pServer->maxClient, (int)(pServer->maxMemory / MEGABYTE));
+    fflush(log);
+    // flush log until stopped
+    while(SDL_AtomicGet(&running))
+    {
+        serverLog.flush(log);
+        SDL_Delay(LOG_FLUSH_MS);
+    }
+    // stop
+    pManager->stop();
+    serverLog.flush(log);
+    if(log != stderr)
+    {
+        fclose(log);
+    }
+    return 0;
+}
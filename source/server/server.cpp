@@ -19,18 +19,13 @@
 //
 ////////////////////////////////////////////////////////////////////////////////
 #include <server/servermanager.h>
+#include <server/serverlog.h>
 
 extern "C" {
 #include <api/scopefunapi.h>
 #include <core/purec/puresocket.h>
 }
 
-void* getListBox1();
-void* getListBox2();
-void  msgListBoxAdd(void* list, const char* msg);
-void  msgListBoxRemove(void* list, const char* msg);
-void  msgListBoxClear(void* list);
-
 SDL_SpinLock lock = 0;
 
 void* createRunner();
@@ -124,9 +119,341 @@ void errorMessage(const char* msg)
 {
     FORMAT_BUFFER();
     FORMAT(msg,0);
-    msgListBoxAdd(getListBox1(), formatBuffer);
+    serverLogAdd(slMessage, formatBuffer);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+// message
+////////////////////////////////////////////////////////////////////////////////
+#define SERVER_MSG(structure) \
+    structure* recvMessage = (structure*)pClient->recv; \
+    (void)recvMessage; \
+    StaticCheck< sizeof(structure) < CLIENT_RECV_BUFFER > ::check();
+
+#define SERVER_REPLY(structure,messageType) \
+    structure* sendMessage = (structure*)pClient->send; \
+    StaticCheck< sizeof(structure) < CLIENT_SEND_BUFFER > ::check(); \
+    *sendSize = sizeof(structure); \
+    if (serverMessageHeader((messageHeader*)sendMessage, messageType) != SCOPEFUN_SUCCESS) return SCOPEFUN_FAILURE;
+
+int serverMessageSize(messageHeader* header)
+{
+    messageHeader expected;
+    if(clientMessageHeader(&expected, (EMessage)header->message) != SCOPEFUN_SUCCESS)
+    {
+        return 0;
+    }
+    if(expected.size != header->size || expected.size >= CLIENT_RECV_BUFFER)
+    {
+        return 0;
+    }
+    return expected.size;
 }
 
+int serverMessage(ScopeFunClient* pClient, int* sendSize)
+{
+    messageHeader* recvHeader = (messageHeader*)pClient->recv;
+    *sendSize = 0;
+    /*------------------------------------------------------------------
+        client
+
+           - mClientConnect
+           - mClientDisconnect
+           - mClientDisplay
+
+    ------------------------------------------------------------------*/
+    if(recvHeader->message == mClientConnect)
+    {
+        SERVER_MSG(csClientConnect);
+        SERVER_REPLY(scClientConnect, mClientConnect);
+        sendMessage->id    = pClient->id;
+        pClient->maxMemory = min<ularge>(pClient->maxMemory, recvMessage->maxMemory);
+        return SCOPEFUN_SUCCESS;
+    }
+    if(recvHeader->message == mClientDisconnect)
+    {
+        SERVER_MSG(csClientDisconnect);
+        SERVER_REPLY(scClientDisconnect, mClientDisconnect);
+        return SCOPEFUN_SUCCESS;
+    }
+    if(recvHeader->message == mClientDisplay)
+    {
+        SERVER_MSG(csClientDisplay);
+        SERVER_REPLY(scClientDisplay, mClientDisplay);
+        ScopeFunClient* pDisplayClient = 0;
+        for(int i = 0; i < pServer->client.getCount(); i++)
+        {
+            if(recvMessage->clientId == pServer->client[i]->id)
+            {
+                pDisplayClient = pServer->client[i];
+                break;
+            }
+        }
+        if(pDisplayClient)
+        {
+            pDisplayClient->display = recvMessage->display;
+        }
+        return SCOPEFUN_SUCCESS;
+    }
+    /*------------------------------------------------------------------
+        server
+
+           - mUpload
+           - mDownload
+
+    ------------------------------------------------------------------*/
+    if(recvHeader->message == mUpload)
+    {
+        SERVER_MSG(csUpload);
+        SERVER_REPLY(scUpload, mUpload);
+        sfSetSimulateData(&pServer->ctx,   &recvMessage->simulate);
+        sfSetSimulateOnOff(&pServer->ctx,   recvMessage->simOnOff);
+        sfSetFrameVersion(&pServer->ctx,    recvMessage->frame.version);
+        sfSetFrameHeader(&pServer->ctx,     recvMessage->frame.header);
+        sfSetFrameData(&pServer->ctx,       recvMessage->frame.data);
+        sfSetFramePacket(&pServer->ctx,     recvMessage->frame.packet);
+        return SCOPEFUN_SUCCESS;
+    }
+    if(recvHeader->message == mDownload)
+    {
+        SERVER_MSG(csDownload);
+        SERVER_REPLY(scDownload, mDownload);
+        sendMessage->active.cnt = pServer->client.getCount();
+        for(int i = 0; i < sendMessage->active.cnt; i++)
+        {
+            sendMessage->active.client.bytes[i] = pServer->client[i]->id;
+        }
+        sendMessage->display = pClient->display;
+        sendMessage->simOnOff = sfIsSimulate(&pServer->ctx);
+        sfGetSimulateData(&pServer->ctx,  &sendMessage->simulate);
+        sfGetFrameVersion(&pServer->ctx, (int*)&sendMessage->frame.version);
+        sfGetFrameData(&pServer->ctx, (int*)&sendMessage->frame.data);
+        sfGetFrameHeader(&pServer->ctx, (int*)&sendMessage->frame.header);
+        sfGetFramePacket(&pServer->ctx, (int*)&sendMessage->frame.packet);
+        return SCOPEFUN_SUCCESS;
+    }
+    /*------------------------------------------------------------------
+        hardware
+
+              - mHardwareOpen
+              - mHardwareIsOpened
+              - mHardwareReset
+              - mHardwareConfig1
+              - mHardwareConfig2
+              - mHardwareUploadFx2
+              - mHardwareUploadFpga
+              - mHardwareUploadGenerator
+              - mHardwareEepromRead
+              - mHardwareEepromReadFirmwareID
+              - mHardwareEepromWrite
+              - mHardwareEepromErase
+              - mHardwareClose
+
+        mHardwareCapture waits for the capture thread and is handled
+        by the server model itself.
+
+    ------------------------------------------------------------------*/
+    if(recvHeader->message == mHardwareOpen)
+    {
+        SERVER_MSG(csHardwareOpen);
+        SERVER_REPLY(scHardwareOpen, mHardwareOpen);
+        sendMessage->header.error = sfHardwareOpen(&pServer->ctx, &recvMessage->usb, recvMessage->version);
+        return SCOPEFUN_SUCCESS;
+    }
+    if(recvHeader->message == mHardwareIsOpened)
+    {
+        SERVER_MSG(csHardwareIsOpened);
+        SERVER_REPLY(scHardwareIsOpened, mHardwareIsOpened);
+        sendMessage->header.error = sfHardwareIsOpened(&pServer->ctx, (int*)&sendMessage->opened);
+        return SCOPEFUN_SUCCESS;
+    }
+    if(recvHeader->message == mHardwareReset)
+    {
+        SERVER_MSG(csHardwareReset);
+        SERVER_REPLY(scHardwareReset, mHardwareReset);
+        sendMessage->header.error = sfHardwareReset(&pServer->ctx);
+        return SCOPEFUN_SUCCESS;
+    }
+    if(recvHeader->message == mHardwareConfig1)
+    {
+        SERVER_MSG(csHardwareConfig1);
+        SERVER_REPLY(scHardwareConfig1, mHardwareConfig1);
+        sendMessage->header.error = sfHardwareConfig1(&pServer->ctx, &recvMessage->config);
+        if(sendMessage->header.error == SCOPEFUN_SUCCESS)
+        {
+            SDL_AtomicSet(&pServer->firmwareConfigured, 1);
+        }
+        return SCOPEFUN_SUCCESS;
+    }
+    if(recvHeader->message == mHardwareConfig2)
+    {
+        SERVER_MSG(csHardwareConfig2);
+        SERVER_REPLY(scHardwareConfig2, mHardwareConfig2);
+        sendMessage->header.error = sfHardwareConfig2(&pServer->ctx, &recvMessage->config);
+        if(sendMessage->header.error == SCOPEFUN_SUCCESS)
+        {
+            SDL_AtomicSet(&pServer->firmwareConfigured, 1);
+        }
+        return SCOPEFUN_SUCCESS;
+    }
+    if(recvHeader->message == mHardwareUploadFx2)
+    {
+        SERVER_MSG(csHardwareUploadFx2);
+        SERVER_REPLY(scHardwareUploadFx2, mHardwareUploadFx2);
+        sendMessage->header.error = sfHardwareUploadFx2(&pServer->ctx, &recvMessage->fx2);
+        return SCOPEFUN_SUCCESS;
+    }
+    if(recvHeader->message == mHardwareUploadFpga)
+    {
+        SERVER_MSG(csHardwareUploadFpga);
+        SERVER_REPLY(scHardwareUploadFpga, mHardwareUploadFpga);
+        sendMessage->header.error = sfHardwareUploadFpga(&pServer->ctx, &recvMessage->fpga);
+        if(sendMessage->header.error == SCOPEFUN_SUCCESS)
+        {
+            SDL_AtomicSet(&pServer->firmwareUploaded, 1);
+        }
+        return SCOPEFUN_SUCCESS;
+    }
+    if(recvHeader->message == mHardwareUploadGenerator)
+    {
+        SERVER_MSG(csHardwareUploadGenerator);
+        SERVER_REPLY(scHardwareUploadGenerator, mHardwareUploadGenerator);
+        sendMessage->header.error = sfHardwareUploadGenerator(&pServer->ctx, &recvMessage->data);
+        return SCOPEFUN_SUCCESS;
+    }
+    if(recvHeader->message == mHardwareEepromRead)
+    {
+        SERVER_MSG(csHardwareEepromRead);
+        SERVER_REPLY(scHardwareEepromRead, mHardwareEepromRead);
+        sendMessage->header.error = sfHardwareEepromRead(&pServer->ctx, &sendMessage->eeprom, recvMessage->size, recvMessage->address);
+        return SCOPEFUN_SUCCESS;
+    }
+    if(recvHeader->message == mHardwareEepromReadFirmwareID)
+    {
+        SERVER_MSG(csHardwareEepromReadFirmwareID);
+        SERVER_REPLY(scHardwareEepromReadFirmwareID, mHardwareEepromReadFirmwareID);
+        sendMessage->header.error = sfHardwareEepromReadFirmwareID(&pServer->ctx, &sendMessage->eeprom, recvMessage->size, recvMessage->address);
+        return SCOPEFUN_SUCCESS;
+    }
+    if(recvHeader->message == mHardwareEepromWrite)
+    {
+        SERVER_MSG(csHardwareEepromWrite);
+        SERVER_REPLY(scHardwareEepromWrite, mHardwareEepromWrite);
+        sendMessage->header.error = sfHardwareEepromWrite(&pServer->ctx, &recvMessage->eeprom, recvMessage->size, recvMessage->address);
+        return SCOPEFUN_SUCCESS;
+    }
+    if(recvHeader->message == mHardwareEepromErase)
+    {
+        SERVER_MSG(csHardwareEepromErase);
+        SERVER_REPLY(scHardwareEepromErase, mHardwareEepromErase);
+        sendMessage->header.error = sfHardwareEepromErase(&pServer->ctx);
+        return SCOPEFUN_SUCCESS;
+    }
+    if(recvHeader->message == mHardwareClose)
+    {
+        SERVER_MSG(csHardwareClose);
+        SERVER_REPLY(scHardwareClose, mHardwareClose);
+        sendMessage->header.error = sfHardwareClose(&pServer->ctx);
+        return SCOPEFUN_SUCCESS;
+    }
+    /*------------------------------------------------------------------
+        stream
+
+              - mHardwareSubscribe
+              - mHardwareCredit
+
+        Each credit allows the server to push one mHardwareStream frame
+        without a request. Credit messages have no reply.
+
+    ------------------------------------------------------------------*/
+    if(recvHeader->message == mHardwareSubscribe)
+    {
+        SERVER_MSG(csHardwareSubscribe);
+        SERVER_REPLY(scHardwareSubscribe, mHardwareSubscribe);
+        pClient->stream      = recvMessage->credit > 0;
+        pClient->streamBytes = min<uint>(recvMessage->len, pClient->maxMemory);
+        pClient->streamType  = recvMessage->type;
+        pClient->credit      = recvMessage->credit;
+        sendMessage->credit  = pClient->credit;
+        return SCOPEFUN_SUCCESS;
+    }
+    if(recvHeader->message == mHardwareCredit)
+    {
+        SERVER_MSG(csHardwareCredit);
+        if(pClient->stream)
+        {
+            pClient->credit += recvMessage->credit;
+        }
+        return SCOPEFUN_SUCCESS;
+    }
+    return SCOPEFUN_FAILURE;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// stream
+////////////////////////////////////////////////////////////////////////////////
+bool serverStreamArm(ScopeFunClient* pClient)
+{
+    if(SDL_AtomicGet(&pClient->bytes) > 0)
+    {
+        return true;
+    }
+    if(!pClient->stream || pClient->credit == 0)
+    {
+        return false;
+    }
+    // one credit per frame handed over by the capture thread
+    pClient->credit--;
+    SDL_MemoryBarrierAcquire();
+    SDL_AtomicSet(&pClient->bytes, pClient->streamBytes);
+    SDL_AtomicSet(&pClient->captureType, pClient->streamType);
+    return true;
+}
+
+int serverStreamHeader(ScopeFunClient* pClient, char* dest)
+{
+    scHardwareStream* sendMessage = (scHardwareStream*)dest;
+    serverMessageHeader((messageHeader*)sendMessage, mHardwareStream);
+    sendMessage->bytes    = pClient->frame ? SDL_AtomicGet(&pClient->frame->transfered) : 0;
+    sendMessage->sequence = pClient->sequence;
+    return sizeof(messageHeader) + 2 * sizeof(uint);
+}
+
+void serverFrameDone(ScopeFunClient* pClient)
+{
+    SDL_AtomicSet(&pClient->bytes, 0);
+    if(pClient->frame)
+    {
+        pClient->frame->release();
+        pClient->frame = 0;
+    }
+    while(!pClient->sync.consumerUnlock())
+    {
+        SDL_Delay(1);
+    }
+    SDL_MemoryBarrierRelease();
+}
+
+int serverStreamSend(ScopeFunClient* pClient)
+{
+    SocketContext& s = pClient->socket;
+    int  transfered = 0;
+    char header[sizeof(messageHeader) + 2 * sizeof(uint)];
+    int  size = serverStreamHeader(pClient, header);
+    int  ret  = socketSend(&s, header, size, 0, &transfered);
+    uint bytes = ((scHardwareStream*)header)->bytes;
+    if(ret == PURESOCKET_SUCCESS && bytes > 0)
+    {
+        ret = socketSend(&s, (char*)&pClient->frame->data->data.bytes[0], bytes, 0, &transfered);
+    }
+    if(ret != PURESOCKET_SUCCESS)
+    {
+        errorMessage("error - stream");
+    }
+    serverFrameDone(pClient);
+    return ret;
+}
 
 int SDLCALL ClientFunServer(void* data)
 {
@@ -137,7 +464,7 @@ int SDLCALL ClientFunServer(void* data)
         // list box
         FORMAT_BUFFER();
         FORMAT("Client %d", pClient->id);
-        msgListBoxAdd(getListBox2(), (const char*)formatBuffer);
+        serverLogAdd(slClient, formatBuffer);
         // loop
         double timer = 0.f;
         while(SDL_AtomicGet(&pClient->active) > 0)
@@ -145,6 +472,19 @@ int SDLCALL ClientFunServer(void* data)
             int  transfered = 0;
             int  transfered_size_ok = 0;
             SocketContext& s = pClient->socket;
+            // stream, push frames while credit lasts and only block on receive when there is a message
+            if(serverStreamArm(pClient))
+            {
+                if(pClient->sync.consumerLock())
+                {
+                    serverStreamSend(pClient);
+                    serverStreamArm(pClient);
+                }
+                if(socketWait(&s, 1) != PURESOCKET_SUCCESS)
+                {
+                    continue;
+                }
+            }
             // receive
             SERVER_RECV_HEADER;
             if(transfered == 0)
@@ -171,219 +511,10 @@ int SDLCALL ClientFunServer(void* data)
             }
             // header ok
             FORMAT("Client %d | %s ", pClient->id, (const char*)messageName((EMessage)recvHeader->message));
-            msgListBoxAdd(getListBox1(), formatBuffer);
-            /*------------------------------------------------------------------
-                client
-
-                   - mClientConnect
-                   - mClientDisconnect
-
-            ------------------------------------------------------------------*/
-            if(recvHeader->message == mClientConnect)
-            {
-                SERVER_RECV_MSG(csClientConnect);
-                if(server_recv_msg == SCOPEFUN_SUCCESS)
-                {
-                    SERVER_HEADER(scClientConnect, mClientConnect);
-                    if(server_header == SCOPEFUN_SUCCESS)
-                    {
-                        sendMessage->id    = pClient->id;
-                        pClient->maxMemory = min<ularge>(pClient->maxMemory, recvMessage->maxMemory);
-                        SERVER_SEND_MSG(scClientConnect);
-                    }
-                }
-                continue;
-            }
-            if(recvHeader->message == mClientDisconnect)
-            {
-                SERVER_RECV_MSG(csClientDisconnect);
-                if(server_recv_msg == SCOPEFUN_SUCCESS)
-                {
-                    SERVER_HEADER(scClientDisconnect, mClientDisconnect);
-                    if(server_header == SCOPEFUN_SUCCESS)
-                    {
-                        SERVER_SEND_MSG(scClientDisconnect);
-                        if(server_send_msg == SCOPEFUN_SUCCESS)
-                        {
-                            pClient->stop(false);
-                        }
-                    }
-                }
-                continue;
-            }
-            if(recvHeader->message == mClientDisplay)
-            {
-                SERVER_RECV_MSG(csClientDisplay);
-                if(server_recv_msg == SCOPEFUN_SUCCESS)
-                {
-                    SERVER_HEADER(scClientDisplay, mClientDisplay);
-                    if(server_header == SCOPEFUN_SUCCESS)
-                    {
-                        ScopeFunClient* pDisplayClient = 0;
-                        for(int i = 0; i < pServer->client.getCount(); i++)
-                        {
-                            if(recvMessage->clientId == pServer->client[i]->id)
-                            {
-                                pDisplayClient = pServer->client[i];
-                                break;
-                            }
-                        }
-                        if(pDisplayClient)
-                        {
-                            pDisplayClient->display = recvMessage->display;
-                        }
-                        SERVER_SEND_MSG(scUpload);
-                    }
-                }
-                continue;
-            }
-            /*------------------------------------------------------------------
-                server
-
-                   - mUpload
-                   - mDownload
-
-            ------------------------------------------------------------------*/
-            if(recvHeader->message == mUpload)
-            {
-                SERVER_RECV_MSG(csUpload);
-                if(server_recv_msg == SCOPEFUN_SUCCESS)
-                {
-                    SERVER_HEADER(scUpload, mUpload);
-                    if(server_header == SCOPEFUN_SUCCESS)
-                    {
-                        sfSetSimulateData(&pServer->ctx,   &recvMessage->simulate);
-                        sfSetSimulateOnOff(&pServer->ctx,   recvMessage->simOnOff);
-                        sfSetFrameVersion(&pServer->ctx,    recvMessage->frame.version);
-                        sfSetFrameHeader(&pServer->ctx,     recvMessage->frame.header);
-                        sfSetFrameData(&pServer->ctx,       recvMessage->frame.data);
-                        sfSetFramePacket(&pServer->ctx,     recvMessage->frame.packet);
-                        SERVER_SEND_MSG(scUpload);
-                    }
-                }
-                continue;
-            }
-            if(recvHeader->message == mDownload)
-            {
-                SERVER_RECV_MSG(csDownload);
-                if(server_recv_msg == SCOPEFUN_SUCCESS)
-                {
-                    SERVER_HEADER(scDownload, mDownload);
-                    if(server_header == SCOPEFUN_SUCCESS)
-                    {
-                        sendMessage->active.cnt = pServer->client.getCount();
-                        for(int i = 0; i < sendMessage->active.cnt; i++)
-                        {
-                            sendMessage->active.client.bytes[i] = pServer->client[i]->id;
-                        }
-                        sendMessage->display = pClient->display;
-                        sendMessage->simOnOff = sfIsSimulate(&pServer->ctx);
-                        sfGetSimulateData(&pServer->ctx,  &sendMessage->simulate);
-                        sfGetFrameVersion(&pServer->ctx, (int*)&sendMessage->frame.version);
-                        sfGetFrameData(&pServer->ctx, (int*)&sendMessage->frame.data);
-                        sfGetFrameHeader(&pServer->ctx, (int*)&sendMessage->frame.header);
-                        sfGetFramePacket(&pServer->ctx, (int*)&sendMessage->frame.packet);
-                        SERVER_SEND_MSG(scDownload);
-                    }
-                }
-                continue;
-            }
+            serverLogAdd(slMessage, formatBuffer);
             /*------------------------------------------------------------------
-                hardware
-
-                      - mHardwareOpen
-                      - mHardwareIsOpened
-                      - mHardwareReset
-                      - mHardwareConfig1
-                      - mHardwareConfig2
-                      - mHardwareCapture
-                      - mHardwareUploadFx2
-                      - mHardwareUploadFpga
-                      - mHardwareUploadGenerator
-                      - mHardwareEepromRead
-                      - mHardwareEepromWrite
-                      - mHardwareEepromErase
-                      - mHardwareClose
-
+                capture
             ------------------------------------------------------------------*/
-            if(recvHeader->message == mHardwareOpen)
-            {
-                SERVER_RECV_MSG(csHardwareOpen);
-                if(server_recv_msg == SCOPEFUN_SUCCESS)
-                {
-                    SERVER_HEADER(scHardwareOpen, mHardwareOpen);
-                    if(server_header == SCOPEFUN_SUCCESS)
-                    {
-                        sendMessage->header.error = sfHardwareOpen(&pServer->ctx, &recvMessage->usb, recvMessage->version);
-                        SERVER_SEND_MSG(scHardwareOpen);
-                    }
-                }
-                continue;
-            }
-            if(recvHeader->message == mHardwareIsOpened)
-            {
-                SERVER_RECV_MSG(csHardwareIsOpened);
-                if(server_recv_msg == SCOPEFUN_SUCCESS)
-                {
-                    SERVER_HEADER(scHardwareIsOpened, mHardwareIsOpened);
-                    if(server_header == SCOPEFUN_SUCCESS)
-                    {
-                        sendMessage->header.error = sfHardwareIsOpened(&pServer->ctx, (int*)&sendMessage->opened);
-                        SERVER_SEND_MSG(scHardwareIsOpened);
-                    }
-                }
-                continue;
-            }
-            if(recvHeader->message == mHardwareReset)
-            {
-                SERVER_RECV_MSG(csHardwareReset);
-                if(server_recv_msg == SCOPEFUN_SUCCESS)
-                {
-                    SERVER_HEADER(scHardwareReset, mHardwareReset);
-                    if(server_header == SCOPEFUN_SUCCESS)
-                    {
-                        sendMessage->header.error = sfHardwareReset(&pServer->ctx);
-                        SERVER_SEND_MSG(scHardwareReset);
-                    }
-                }
-                continue;
-            }
-            if(recvHeader->message == mHardwareConfig1)
-            {
-                SERVER_RECV_MSG(csHardwareConfig1);
-                if(server_recv_msg == SCOPEFUN_SUCCESS)
-                {
-                    SERVER_HEADER(scHardwareConfig1, mHardwareConfig1);
-                    if(server_header == SCOPEFUN_SUCCESS)
-                    {
-                        sendMessage->header.error = sfHardwareConfig1(&pServer->ctx, &recvMessage->config);
-                        if(sendMessage->header.error == SCOPEFUN_SUCCESS)
-                        {
-                            SDL_AtomicSet(&pServer->firmwareConfigured, 1);
-                        }
-                        SERVER_SEND_MSG(scHardwareConfig1);
-                    }
-                }
-                continue;
-            }
-            if(recvHeader->message == mHardwareConfig2)
-            {
-                SERVER_RECV_MSG(csHardwareConfig2);
-                if(server_recv_msg == SCOPEFUN_SUCCESS)
-                {
-                    SERVER_HEADER(scHardwareConfig2, mHardwareConfig2);
-                    if(server_header == SCOPEFUN_SUCCESS)
-                    {
-                        sendMessage->header.error = sfHardwareConfig2(&pServer->ctx, &recvMessage->config);
-                        if(sendMessage->header.error == SCOPEFUN_SUCCESS)
-                        {
-                            SDL_AtomicSet(&pServer->firmwareConfigured, 1);
-                        }
-                        SERVER_SEND_MSG(scHardwareConfig2);
-                    }
-                }
-                continue;
-            }
             if(recvHeader->message == mHardwareCapture)
             {
                 SERVER_RECV_MSG(csHardwareCapture);
@@ -413,11 +544,14 @@ int SDLCALL ClientFunServer(void* data)
                         if(server_send_msg == SCOPEFUN_SUCCESS)
                         {
                             // amount of data to send
-                            sendMessage->bytes = SDL_AtomicGet(&pClient->transfered);
+                            sendMessage->bytes = pClient->frame ? SDL_AtomicGet(&pClient->frame->transfered) : 0;
                             SERVER_SEND_BUFFER(&sendMessage->bytes, sizeof(int));
                             if(server_send_buffer == SCOPEFUN_SUCCESS)
                             {
-                                SERVER_SEND_BUFFER((byte*)&pClient->buffer->data.bytes[0], (sendMessage->bytes));
+                                if(sendMessage->bytes > 0)
+                                {
+                                    SERVER_SEND_BUFFER((byte*)&pClient->frame->data->data.bytes[0], (sendMessage->bytes));
+                                }
                             }
                             else
                             {
@@ -440,6 +574,13 @@ int SDLCALL ClientFunServer(void* data)
                     // amount of data to capture
                     SDL_AtomicSet(&pClient->bytes,0);
 
+                    // frame sent, release reference
+                    if(pClient->frame)
+                    {
+                        pClient->frame->release();
+                        pClient->frame = 0;
+                    }
+
                     // unlock
                     while(!pClient->sync.consumerUnlock())
                     {
@@ -451,126 +592,40 @@ int SDLCALL ClientFunServer(void* data)
                 }
                 continue;
             }
-            if(recvHeader->message == mHardwareUploadFx2)
+            /*------------------------------------------------------------------
+                message
+            ------------------------------------------------------------------*/
+            int msgSize = serverMessageSize(recvHeader);
+            if(msgSize == 0)
             {
-                SERVER_RECV_MSG(csHardwareUploadFx2);
-                if(server_recv_msg == SCOPEFUN_SUCCESS)
-                {
-                    SERVER_HEADER(scHardwareUploadFx2, mHardwareUploadFx2);
-                    if(server_header == SCOPEFUN_SUCCESS)
-                    {
-                        sendMessage->header.error = sfHardwareUploadFx2(&pServer->ctx, &recvMessage->fx2);
-                        SERVER_SEND_MSG(scHardwareUploadFx2);
-                    }
-                }
                 continue;
             }
-            if(recvHeader->message == mHardwareUploadFpga)
+            int server_recv_msg = socketRecv(&s, (char*)pClient->recv + sizeof(messageHeader), msgSize - sizeof(messageHeader), 0, &transfered);
+            if(server_recv_msg == SCOPEFUN_SUCCESS)
             {
-                SERVER_RECV_MSG(csHardwareUploadFpga);
-                if(server_recv_msg == SCOPEFUN_SUCCESS)
+                int sendSize = 0;
+                if(serverMessage(pClient, &sendSize) == SCOPEFUN_SUCCESS && sendSize > 0)
                 {
-                    SERVER_HEADER(scHardwareUploadFpga, mHardwareUploadFpga);
-                    if(server_header == SCOPEFUN_SUCCESS)
+                    // unsubscribe, frame already requested goes out before the reply
+                    if(recvHeader->message == mHardwareSubscribe && !pClient->stream && SDL_AtomicGet(&pClient->bytes) > 0)
                     {
-                        sendMessage->header.error = sfHardwareUploadFpga(&pServer->ctx, &recvMessage->fpga);
-                        if(sendMessage->header.error == SCOPEFUN_SUCCESS)
+                        while(!pClient->sync.consumerLock())
                         {
-                            SDL_AtomicSet(&pServer->firmwareUploaded, 1);
+                            SDL_Delay(1);
                         }
-                        SERVER_SEND_MSG(scHardwareUploadFpga);
+                        serverStreamSend(pClient);
                     }
-                }
-                continue;
-            }
-            if(recvHeader->message == mHardwareUploadGenerator)
-            {
-                SERVER_RECV_MSG(csHardwareUploadGenerator);
-                if(server_recv_msg == SCOPEFUN_SUCCESS)
-                {
-                    SERVER_HEADER(scHardwareUploadGenerator, mHardwareUploadGenerator);
-                    if(server_header == SCOPEFUN_SUCCESS)
+                    int server_send_msg = socketSend(&s, (char*)pClient->send, sendSize, 0, &transfered);
+                    if(server_send_msg == SCOPEFUN_SUCCESS && recvHeader->message == mClientDisconnect)
                     {
-                        sendMessage->header.error = sfHardwareUploadGenerator(&pServer->ctx, &recvMessage->data);
-                        SERVER_SEND_MSG(scHardwareUploadGenerator);
+                        pClient->stop(false);
                     }
                 }
-                continue;
-            }
-            if(recvHeader->message == mHardwareEepromRead)
-            {
-                SERVER_RECV_MSG(csHardwareEepromRead);
-                if(server_recv_msg == SCOPEFUN_SUCCESS)
-                {
-                    SERVER_HEADER(scHardwareEepromRead, mHardwareEepromRead);
-                    if(server_header == SCOPEFUN_SUCCESS)
-                    {
-                        sendMessage->header.error = sfHardwareEepromRead(&pServer->ctx, &sendMessage->eeprom, recvMessage->size, recvMessage->address);
-                        SERVER_SEND_MSG(scHardwareEepromRead);
-                    }
-                }
-                continue;
-            }
-            if (recvHeader->message == mHardwareEepromReadFirmwareID)
-            {
-               SERVER_RECV_MSG(csHardwareEepromReadFirmwareID);
-               if (server_recv_msg == SCOPEFUN_SUCCESS)
-               {
-                  SERVER_HEADER(scHardwareEepromReadFirmwareID, mHardwareEepromReadFirmwareID);
-                  if (server_header == SCOPEFUN_SUCCESS)
-                  {
-                     sendMessage->header.error = sfHardwareEepromReadFirmwareID(&pServer->ctx, &sendMessage->eeprom, recvMessage->size, recvMessage->address);
-                     SERVER_SEND_MSG(scHardwareEepromReadFirmwareID);
-                  }
-               }
-               continue;
-            }
-            if(recvHeader->message == mHardwareEepromWrite)
-            {
-                SERVER_RECV_MSG(csHardwareEepromWrite);
-                if(server_recv_msg == SCOPEFUN_SUCCESS)
-                {
-                    SERVER_HEADER(scHardwareEepromWrite, mHardwareEepromWrite);
-                    if(server_header == SCOPEFUN_SUCCESS)
-                    {
-                        sendMessage->header.error = sfHardwareEepromWrite(&pServer->ctx, &recvMessage->eeprom, recvMessage->size, recvMessage->address);
-                        SERVER_SEND_MSG(scHardwareEepromWrite);
-                    }
-                }
-                continue;
-            }
-            if(recvHeader->message == mHardwareEepromErase)
-            {
-                SERVER_RECV_MSG(csHardwareEepromErase);
-                if(server_recv_msg == SCOPEFUN_SUCCESS)
-                {
-                    SERVER_HEADER(scHardwareEepromErase, mHardwareEepromErase);
-                    if(server_header == SCOPEFUN_SUCCESS)
-                    {
-                        sendMessage->header.error = sfHardwareEepromErase(&pServer->ctx);
-                        SERVER_SEND_MSG(scHardwareEepromErase);
-                    }
-                }
-                continue;
-            }
-            if(recvHeader->message == mHardwareClose)
-            {
-                SERVER_RECV_MSG(csHardwareClose);
-                if(server_recv_msg == SCOPEFUN_SUCCESS)
-                {
-                    SERVER_HEADER(scHardwareClose, mHardwareClose);
-                    if(server_header == SCOPEFUN_SUCCESS)
-                    {
-                        sendMessage->header.error = sfHardwareClose(&pServer->ctx);
-                        SERVER_SEND_MSG(scHardwareClose);
-                    }
-                }
-                continue;
             }
         }
         // remove from list
         FORMAT("Client %d", pClient->id);
-        msgListBoxRemove(getListBox2(), formatBuffer);
+        serverLogRemove(slClient, formatBuffer);
     }
     catch(...)
     {
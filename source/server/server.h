@@ -24,6 +24,8 @@ class ScopeFunClient;
 void* createRunner();
 void* createClient(ScopeFunClient* client);
 void* createServer(const char* serveraddr, int port);
+void* createEventServer(const char* serveraddr, int port);
+void  eventServerWake();
 
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,551 @@
+////////////////////////////////////////////////////////////////////////////////
+//    ScopeFun Oscilloscope ( http://www.scopefun.com )
+//    Copyright (C) 2016 - 2019 David Košenina
+//
+//    This file is part of ScopeFun Oscilloscope.
+//
+//    ScopeFun Oscilloscope is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    ScopeFun Oscilloscope is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with this ScopeFun Oscilloscope.  If not, see <http://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////
+#include <server/servermanager.h>
+#include <server/server.h>
+#include <server/serverlog.h>
+
+extern "C" {
+#include <api/scopefunapi.h>
+#include <core/purec/puresocket.h>
+}
+
+void  errorMessage(const char* msg);
+int   serverMessageSize(messageHeader* header);
+int   serverMessage(ScopeFunClient* pClient, int* sendSize);
+bool  serverStreamArm(ScopeFunClient* pClient);
+int   serverStreamHeader(ScopeFunClient* pClient, char* dest);
+void  serverFrameDone(ScopeFunClient* pClient);
+
+#if defined(PLATFORM_LINUX)
+
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <unistd.h>
+
+#define EVENT_LISTEN      SCOPEFUN_MAX_CLIENT
+#define EVENT_WAKE       (SCOPEFUN_MAX_CLIENT + 1)
+#define EVENT_MAX_EVENTS (SCOPEFUN_MAX_CLIENT + 2)
+#define EVENT_MAX_SEND    3
+#define EVENT_TIMEOUT     100
+
+// eventfd the capture thread signals after it hands frames to clients
+static SDL_atomic_t eventWake = { -1 };
+
+////////////////////////////////////////////////////////////////////////////////
+// EventConnection
+////////////////////////////////////////////////////////////////////////////////
+enum EEventState
+{
+    esClosed,
+    esRecvHeader,
+    esRecvMessage,
+    esCapture,
+    esSend,
+};
+
+class EventConnection
+{
+public:
+    ScopeFunClient* client;
+    EEventState     state;
+    uint            recvSize;
+    uint            recvBytes;
+    char*           sendPtr[EVENT_MAX_SEND];
+    uint            sendSize[EVENT_MAX_SEND];
+    uint            sendCount;
+    uint            sendIndex;
+    uint            sendOffset;
+    char            header[sizeof(messageHeader) + 2 * sizeof(uint)];
+    uint            reply;
+    bool            capture;
+    bool            disconnect;
+public:
+    EventConnection()
+    {
+        client = 0;
+        clear();
+        state = esClosed;
+    }
+    void clear()
+    {
+        state      = esRecvHeader;
+        recvSize   = sizeof(messageHeader);
+        recvBytes  = 0;
+        sendCount  = 0;
+        sendIndex  = 0;
+        sendOffset = 0;
+        reply      = 0;
+        capture    = false;
+        disconnect = false;
+    }
+    void queue(char* ptr, uint size)
+    {
+        sendPtr[sendCount]  = ptr;
+        sendSize[sendCount] = size;
+        sendCount++;
+    }
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// helpers
+////////////////////////////////////////////////////////////////////////////////
+int eventSocketSetup(SOCKETFUN s)
+{
+    int flags = fcntl(s, F_GETFL, 0);
+    if(flags < 0 || fcntl(s, F_SETFL, flags | O_NONBLOCK) < 0)
+    {
+        return PURESOCKET_FAILURE;
+    }
+    int flag = 1;
+    setsockopt(s, IPPROTO_TCP, TCP_NODELAY, (char*)&flag, sizeof(flag));
+    return PURESOCKET_SUCCESS;
+}
+
+void eventWatch(int epoll, EventConnection& c)
+{
+    struct epoll_event ev;
+    SDL_zero(ev);
+    ev.data.u32 = c.client->index;
+    switch(c.state)
+    {
+        case esRecvHeader:
+        case esRecvMessage:
+            ev.events = EPOLLIN;
+            break;
+        case esSend:
+            ev.events = EPOLLOUT;
+            break;
+        default:
+            // capture waits for eventWake
+            ev.events = 0;
+            break;
+    };
+    epoll_ctl(epoll, EPOLL_CTL_MOD, c.client->socket.socket, &ev);
+}
+
+void eventFrameDone(EventConnection& c)
+{
+    serverFrameDone(c.client);
+    c.capture = false;
+}
+
+void eventClose(int epoll, EventConnection& c)
+{
+    ScopeFunClient* pClient = c.client;
+    SDL_AtomicSet(&pClient->active, 0);
+    SDL_AtomicSet(&pClient->captureType, SCOPEFUN_CAPTURE_TYPE_NONE);
+    // frame that was already handed over by the capture thread
+    if(c.capture)
+    {
+        eventFrameDone(c);
+    }
+    if(SDL_AtomicGet(&pClient->bytes) > 0 && pClient->sync.consumerLock())
+    {
+        eventFrameDone(c);
+    }
+    epoll_ctl(epoll, EPOLL_CTL_DEL, pClient->socket.socket, 0);
+    socketClose(&pClient->socket);
+    c.state = esClosed;
+    FORMAT_BUFFER();
+    FORMAT("Client %d", pClient->id);
+    serverLogRemove(slClient, formatBuffer);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// message
+////////////////////////////////////////////////////////////////////////////////
+int eventMessage(EventConnection& c)
+{
+    ScopeFunClient*  pClient = c.client;
+    messageHeader* recvHeader = (messageHeader*)pClient->recv;
+    FORMAT_BUFFER();
+    FORMAT("Client %d | %s ", pClient->id, (const char*)messageName((EMessage)recvHeader->message));
+    serverLogAdd(slMessage, formatBuffer);
+    if(recvHeader->message == mHardwareCapture)
+    {
+        csHardwareCapture* recvMessage = (csHardwareCapture*)pClient->recv;
+        SDL_MemoryBarrierAcquire();
+        SDL_AtomicSet(&pClient->bytes, recvMessage->len);
+        SDL_AtomicSet(&pClient->captureType, recvMessage->type);
+        c.state = esCapture;
+        return SCOPEFUN_SUCCESS;
+    }
+    int sendSize = 0;
+    if(serverMessage(pClient, &sendSize) != SCOPEFUN_SUCCESS)
+    {
+        return SCOPEFUN_FAILURE;
+    }
+    if(sendSize == 0)
+    {
+        c.clear();
+        return SCOPEFUN_SUCCESS;
+    }
+    // unsubscribe, frame already requested goes out before the reply
+    if(recvHeader->message == mHardwareSubscribe && !pClient->stream && SDL_AtomicGet(&pClient->bytes) > 0)
+    {
+        c.reply = sendSize;
+        c.state = esCapture;
+        return SCOPEFUN_SUCCESS;
+    }
+    c.sendCount  = 0;
+    c.sendIndex  = 0;
+    c.sendOffset = 0;
+    c.queue(pClient->send, sendSize);
+    c.disconnect = recvHeader->message == mClientDisconnect;
+    c.state      = esSend;
+    return SCOPEFUN_SUCCESS;
+}
+
+int eventCapture(EventConnection& c)
+{
+    ScopeFunClient* pClient = c.client;
+    if(!pClient->sync.consumerLock())
+    {
+        return SCOPEFUN_FAILURE;
+    }
+    // header and byte count are sent as one block, followed by shared frame
+    scHardwareCapture* sendMessage = (scHardwareCapture*)pClient->send;
+    serverMessageHeader((messageHeader*)sendMessage, mHardwareCapture);
+    sendMessage->bytes = pClient->frame ? SDL_AtomicGet(&pClient->frame->transfered) : 0;
+    c.sendCount  = 0;
+    c.sendIndex  = 0;
+    c.sendOffset = 0;
+    c.queue(pClient->send, sizeof(messageHeader) + sizeof(uint));
+    if(sendMessage->bytes > 0)
+    {
+        c.queue((char*)&pClient->frame->data->data.bytes[0], sendMessage->bytes);
+    }
+    c.capture = true;
+    c.state   = esSend;
+    return SCOPEFUN_SUCCESS;
+}
+
+int eventStream(EventConnection& c)
+{
+    ScopeFunClient* pClient = c.client;
+    if(!pClient->sync.consumerLock())
+    {
+        return SCOPEFUN_FAILURE;
+    }
+    c.sendCount  = 0;
+    c.sendIndex  = 0;
+    c.sendOffset = 0;
+    c.queue(c.header, serverStreamHeader(pClient, c.header));
+    uint bytes = ((scHardwareStream*)c.header)->bytes;
+    if(bytes > 0)
+    {
+        c.queue((char*)&pClient->frame->data->data.bytes[0], bytes);
+    }
+    if(c.reply > 0)
+    {
+        c.queue(pClient->send, c.reply);
+    }
+    c.capture = true;
+    c.state   = esSend;
+    return SCOPEFUN_SUCCESS;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// recv / send
+////////////////////////////////////////////////////////////////////////////////
+int eventRecv(EventConnection& c)
+{
+    ScopeFunClient* pClient = c.client;
+    while(c.state == esRecvHeader || c.state == esRecvMessage)
+    {
+        int ret = (int)recv(pClient->socket.socket, pClient->recv + c.recvBytes, c.recvSize - c.recvBytes, 0);
+        if(ret == 0)
+        {
+            return SCOPEFUN_FAILURE;
+        }
+        if(ret < 0)
+        {
+            if(errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)
+            {
+                return SCOPEFUN_SUCCESS;
+            }
+            return SCOPEFUN_FAILURE;
+        }
+        c.recvBytes += ret;
+        if(c.recvBytes < c.recvSize)
+        {
+            continue;
+        }
+        if(c.state == esRecvHeader)
+        {
+            messageHeader* recvHeader = (messageHeader*)pClient->recv;
+            int msgSize = serverMessageSize(recvHeader);
+            if(isClientHeaderOk(recvHeader) != SCOPEFUN_SUCCESS || msgSize == 0)
+            {
+                return SCOPEFUN_FAILURE;
+            }
+            c.recvSize = msgSize;
+            c.state    = esRecvMessage;
+        }
+        else
+        {
+            return eventMessage(c);
+        }
+    }
+    return SCOPEFUN_SUCCESS;
+}
+
+int eventSend(EventConnection& c)
+{
+    ScopeFunClient* pClient = c.client;
+    while(c.sendIndex < c.sendCount)
+    {
+        char* ptr  = c.sendPtr[c.sendIndex] + c.sendOffset;
+        uint  left = c.sendSize[c.sendIndex] - c.sendOffset;
+        int   ret  = (int)send(pClient->socket.socket, ptr, left, MSG_NOSIGNAL);
+        if(ret < 0)
+        {
+            if(errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)
+            {
+                return SCOPEFUN_SUCCESS;
+            }
+            return SCOPEFUN_FAILURE;
+        }
+        c.sendOffset += ret;
+        if(c.sendOffset == c.sendSize[c.sendIndex])
+        {
+            c.sendOffset = 0;
+            c.sendIndex++;
+        }
+    }
+    // reply done
+    if(c.capture)
+    {
+        eventFrameDone(c);
+    }
+    if(c.disconnect)
+    {
+        return SCOPEFUN_FAILURE;
+    }
+    c.clear();
+    return SCOPEFUN_SUCCESS;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// event loop
+////////////////////////////////////////////////////////////////////////////////
+int SDLCALL ScopeFunEventServer(void* data)
+{
+    SDL_SetThreadPriority(SDL_THREAD_PRIORITY_HIGH);
+    SocketContext& serverSocket = pServer->socket;
+    socketCreate(&serverSocket);
+    int reuse = 1;
+    setsockopt(serverSocket.socket, SOL_SOCKET, SO_REUSEADDR, (char*)&reuse, sizeof(reuse));
+    socketBind(&serverSocket, pServer->ip.asChar(), pServer->port);
+    socketListen(&serverSocket, SCOPEFUN_MAX_CLIENT);
+    eventSocketSetup(serverSocket.socket);
+
+    int epoll = epoll_create1(0);
+    struct epoll_event ev;
+    SDL_zero(ev);
+    ev.events   = EPOLLIN;
+    ev.data.u32 = EVENT_LISTEN;
+    epoll_ctl(epoll, EPOLL_CTL_ADD, serverSocket.socket, &ev);
+
+    int wake = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if(wake >= 0)
+    {
+        ev.events   = EPOLLIN;
+        ev.data.u32 = EVENT_WAKE;
+        epoll_ctl(epoll, EPOLL_CTL_ADD, wake, &ev);
+        SDL_AtomicSet(&eventWake, wake);
+    }
+    else
+    {
+        errorMessage("error - eventfd, frames are polled");
+    }
+
+    EventConnection connection[SCOPEFUN_MAX_CLIENT];
+    for(int i = 0; i < pServer->client.getCount(); i++)
+    {
+        connection[i].client = pServer->client[i];
+    }
+
+    int id = 0;
+    struct epoll_event events[EVENT_MAX_EVENTS];
+    while(SDL_AtomicGet(&pServer->serverThreadActive) > 0)
+    {
+        // clients waiting for a frame are woken by the capture thread
+        int count = epoll_wait(epoll, events, EVENT_MAX_EVENTS, wake >= 0 ? EVENT_TIMEOUT : 1);
+        for(int e = 0; e < count; e++)
+        {
+            uint tag = events[e].data.u32;
+            if(tag == EVENT_WAKE)
+            {
+                uint64_t signaled = 0;
+                while(read(wake, &signaled, sizeof(signaled)) == sizeof(signaled))
+                {
+                }
+                continue;
+            }
+            if(tag == EVENT_LISTEN)
+            {
+                SocketContext clientSocket = { 0 };
+                while(socketAccept(&serverSocket, &clientSocket) == PURESOCKET_SUCCESS)
+                {
+                    ScopeFunClient* pFree = 0;
+                    for(int i = 0; i < pServer->client.getCount(); i++)
+                    {
+                        if(SDL_AtomicGet(&pServer->client[i]->active) == 0 && connection[i].state == esClosed)
+                        {
+                            pFree = pServer->client[i];
+                            break;
+                        }
+                    }
+                    if(!pFree)
+                    {
+                        socketClose(&clientSocket);
+                        continue;
+                    }
+                    eventSocketSetup(clientSocket.socket);
+                    pFree->attach(id, clientSocket);
+                    id++;
+                    EventConnection& c = connection[pFree->index];
+                    c.clear();
+                    struct epoll_event cev;
+                    SDL_zero(cev);
+                    cev.events   = EPOLLIN;
+                    cev.data.u32 = pFree->index;
+                    epoll_ctl(epoll, EPOLL_CTL_ADD, clientSocket.socket, &cev);
+                    FORMAT_BUFFER();
+                    FORMAT("Client %d", pFree->id);
+                    serverLogAdd(slClient, formatBuffer);
+                }
+                continue;
+            }
+            if(tag >= (uint)pServer->client.getCount())
+            {
+                continue;
+            }
+            EventConnection& c = connection[tag];
+            if(c.state == esClosed)
+            {
+                continue;
+            }
+            int ret = SCOPEFUN_SUCCESS;
+            if(events[e].events & (EPOLLERR | EPOLLHUP))
+            {
+                ret = SCOPEFUN_FAILURE;
+            }
+            if(ret == SCOPEFUN_SUCCESS && (events[e].events & EPOLLIN))
+            {
+                ret = eventRecv(c);
+            }
+            if(ret == SCOPEFUN_SUCCESS && c.state == esSend)
+            {
+                ret = eventSend(c);
+            }
+            if(ret != SCOPEFUN_SUCCESS)
+            {
+                eventClose(epoll, c);
+                continue;
+            }
+            eventWatch(epoll, c);
+        }
+        // frames handed over by the capture thread
+        for(int i = 0; i < pServer->client.getCount(); i++)
+        {
+            EventConnection& c = connection[i];
+            int ret = SCOPEFUN_FAILURE;
+            if(c.state == esCapture)
+            {
+                ret = c.reply > 0 ? eventStream(c) : eventCapture(c);
+            }
+            // subscribed clients get frames pushed between messages
+            if(c.state == esRecvHeader && c.recvBytes == 0 && serverStreamArm(c.client))
+            {
+                ret = eventStream(c);
+            }
+            if(ret == SCOPEFUN_SUCCESS)
+            {
+                if(eventSend(c) != SCOPEFUN_SUCCESS)
+                {
+                    eventClose(epoll, c);
+                    continue;
+                }
+                eventWatch(epoll, c);
+            }
+        }
+    }
+    for(int i = 0; i < pServer->client.getCount(); i++)
+    {
+        if(connection[i].state != esClosed)
+        {
+            eventClose(epoll, connection[i]);
+        }
+    }
+    SDL_AtomicSet(&eventWake, -1);
+    if(wake >= 0)
+    {
+        close(wake);
+    }
+    close(epoll);
+    socketClose(&serverSocket);
+    return 0;
+}
+
+void* createEventServer(const char* serveraddr, int port)
+{
+    SDL_AtomicSet(&pServer->serverThreadActive, 1);
+    pServer->serverThread = SDL_CreateThread(ScopeFunEventServer, "scopefun_event_server", pServer);
+    return pServer->serverThread;
+}
+
+void eventServerWake()
+{
+    int wake = SDL_AtomicGet(&eventWake);
+    if(wake >= 0)
+    {
+        uint64_t signal = 1;
+        ssize_t  ret = write(wake, &signal, sizeof(signal));
+        (void)ret;
+    }
+}
+
+#else
+
+void* createEventServer(const char* serveraddr, int port)
+{
+    errorMessage("event server is only available on linux, using thread per client");
+    return createServer(serveraddr, port);
+}
+
+void eventServerWake()
+{
+}
+
+#endif
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//
+//
+////////////////////////////////////////////////////////////////////////////////
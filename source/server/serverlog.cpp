@@ -0,0 +1,124 @@
+////////////////////////////////////////////////////////////////////////////////
+//    ScopeFun Oscilloscope ( http://www.scopefun.com )
+//    Copyright (C) 2016 - 2019 David Košenina
+//
+//    This file is part of ScopeFun Oscilloscope.
+//
+//    ScopeFun Oscilloscope is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    ScopeFun Oscilloscope is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with this ScopeFun Oscilloscope.  If not, see <http://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////
+#include<core/core.h>
+#include<server/serverlog.h>
+
+ServerLog serverLog;
+
+////////////////////////////////////////////////////////////////////////////////
+//
+// ServerLog
+//
+////////////////////////////////////////////////////////////////////////////////
+ServerLog::ServerLog()
+{
+    for(int i = 0; i < SERVER_LOG_SIZE; i++)
+    {
+        SDL_AtomicSet(&entry[i].sequence, i);
+    }
+    SDL_AtomicSet(&head, 0);
+    SDL_AtomicSet(&dropped, 0);
+    tail = 0;
+}
+
+void ServerLog::push(int list, int action, const char* text)
+{
+    int             pos = SDL_AtomicGet(&head);
+    ServerLogEntry* e   = 0;
+    while(1)
+    {
+        e = &entry[(uint)pos & (SERVER_LOG_SIZE - 1)];
+        int diff = (int)((uint)SDL_AtomicGet(&e->sequence) - (uint)pos);
+        if(diff == 0)
+        {
+            if(SDL_AtomicCAS(&head, pos, (int)((uint)pos + 1)))
+            {
+                break;
+            }
+        }
+        else if(diff < 0)
+        {
+            SDL_AtomicIncRef(&dropped);
+            return;
+        }
+        pos = SDL_AtomicGet(&head);
+    }
+    e->list   = list;
+    e->action = action;
+    SDL_strlcpy(e->text, text ? text : "", SERVER_LOG_TEXT);
+    SDL_AtomicSet(&e->sequence, (int)((uint)pos + 1));
+}
+
+bool ServerLog::pop(ServerLogEntry& out)
+{
+    ServerLogEntry* e = &entry[(uint)tail & (SERVER_LOG_SIZE - 1)];
+    if((int)((uint)SDL_AtomicGet(&e->sequence) - ((uint)tail + 1)) < 0)
+    {
+        return false;
+    }
+    out.list   = e->list;
+    out.action = e->action;
+    SDL_memcpy(out.text, e->text, SERVER_LOG_TEXT);
+    SDL_AtomicSet(&e->sequence, (int)((uint)tail + SERVER_LOG_SIZE));
+    tail = (int)((uint)tail + 1);
+    return true;
+}
+
+int ServerLog::flush(FILE* file)
+{
+    int count = 0;
+    ServerLogEntry e;
+    while(pop(e))
+    {
+        switch(e.action)
+        {
+            case saAdd:
+                fprintf(file, e.list == slClient ? "connected %s\n" : "%s\n", e.text);
+                break;
+            case saRemove:
+                fprintf(file, "disconnected %s\n", e.text);
+                break;
+            default:
+                break;
+        };
+        count++;
+    }
+    int lost = SDL_AtomicSet(&dropped, 0);
+    if(lost > 0)
+    {
+        fprintf(file, "log dropped %d messages\n", lost);
+    }
+    if(count || lost)
+    {
+        fflush(file);
+    }
+    return count;
+}
+
+void serverLogAdd(int list, const char* text)
+{
+    serverLog.push(list, saAdd, text);
+}
+
+void serverLogRemove(int list, const char* text)
+{
+    serverLog.push(list, saRemove, text);
+}
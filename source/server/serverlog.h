@@ -0,0 +1,86 @@
+////////////////////////////////////////////////////////////////////////////////
+//    ScopeFun Oscilloscope ( http://www.scopefun.com )
+//    Copyright (C) 2016 - 2019 David Košenina
+//
+//    This file is part of ScopeFun Oscilloscope.
+//
+//    ScopeFun Oscilloscope is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    ScopeFun Oscilloscope is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with this ScopeFun Oscilloscope.  If not, see <http://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////
+#ifndef __SERVER__LOG__
+#define __SERVER__LOG__
+
+#include<stdio.h>
+
+#define SERVER_LOG_SIZE 4096
+#define SERVER_LOG_TEXT 120
+
+// lists, same as the server ui list boxes
+enum ServerLogList
+{
+    slMessage,
+    slClient,
+};
+
+enum ServerLogAction
+{
+    saAdd,
+    saRemove,
+    saClear,
+};
+
+class ServerLogEntry
+{
+public:
+    SDL_atomic_t sequence;
+    int          list;
+    int          action;
+    char         text[SERVER_LOG_TEXT];
+};
+
+////////////////////////////////////////////////////////////////////////////////
+//
+// ServerLog
+//
+//   bounded multi producer / single consumer ring, producers never block,
+//   messages are dropped and counted when the consumer falls behind
+//
+////////////////////////////////////////////////////////////////////////////////
+class ServerLog
+{
+public:
+    ServerLogEntry entry[SERVER_LOG_SIZE];
+    SDL_atomic_t   head;
+    SDL_atomic_t   dropped;
+    int            tail;
+public:
+    ServerLog();
+public:
+    void push(int list, int action, const char* text);
+    bool pop(ServerLogEntry& out);
+    int  flush(FILE* file);
+};
+
+extern ServerLog serverLog;
+
+void serverLogAdd(int list, const char* text);
+void serverLogRemove(int list, const char* text);
+
+#endif
+////////////////////////////////////////////////////////////////////////////////
+//
+//
+//
+//
+////////////////////////////////////////////////////////////////////////////////
@@ -21,6 +21,7 @@
 #include<core/core.h>
 #include<server/servermanager.h>
 #include<server/server.h>
+#include<server/serverlog.h>
 
 ////////////////////////////////////////////////////////////////////////////////
 // Globals
@@ -58,16 +59,73 @@ void setup()
     pManager->addStop("Server");
 }
 
+////////////////////////////////////////////////////////////////////////////////
+// ScopeFunFrame
+////////////////////////////////////////////////////////////////////////////////
+ScopeFunFrame::ScopeFunFrame(ularge allocateBytes)
+{
+    // reserved frames are only backed by pages once a capture fills them
+    size     = allocateBytes;
+    data     = (SFrameData*)mapReserve(allocateBytes);
+    reserved = data ? 1 : 0;
+    if(data && mapCommit(data, 0, allocateBytes) != PUREMAP_SUCCESS)
+    {
+        mapUnreserve(data, allocateBytes);
+        data     = 0;
+        reserved = 0;
+    }
+    if(!data)
+    {
+        data = (SFrameData*)pMemory->allocate(allocateBytes);
+    }
+    SDL_AtomicSet(&ref, 0);
+    SDL_AtomicSet(&transfered, 0);
+    sequence = 0;
+}
+
+ScopeFunFrame::~ScopeFunFrame()
+{
+    if(reserved)
+    {
+        mapUnreserve(data, size);
+    }
+    else
+    {
+        pMemory->free(data);
+    }
+}
+
+void ScopeFunFrame::acquire()
+{
+    SDL_AtomicIncRef(&ref);
+}
+
+void ScopeFunFrame::release()
+{
+    SDL_AtomicAdd(&ref, -1);
+}
+
+bool ScopeFunFrame::isFree()
+{
+    return SDL_AtomicGet(&ref) == 0;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 // ScopeFunClient
 ////////////////////////////////////////////////////////////////////////////////
 ScopeFunClient::ScopeFunClient(uint allocateBytes)
 {
     maxMemory = allocateBytes;
-    buffer = (SFrameData*)pMemory->allocate(allocateBytes);
+    frame = 0;
     SDL_AtomicSet(&bytes, 0);
     SDL_AtomicSet(&active, 0);
     SDL_AtomicSet(&captureType, SCOPEFUN_CAPTURE_TYPE_NONE);
+    SDL_AtomicSet(&lag, 0);
+    sequence = 0;
+    stream      = false;
+    streamBytes = 0;
+    streamType  = SCOPEFUN_CAPTURE_TYPE_NONE;
+    credit      = 0;
     id = SCOPEFUN_INVALID_CLIENT;
     index = 0;
     thread = 0;
@@ -77,18 +135,39 @@ ScopeFunClient::ScopeFunClient(uint allocateBytes)
 
 ScopeFunClient::~ScopeFunClient()
 {
-    pMemory->free(buffer);
 }
 
-void ScopeFunClient::start(uint clientId, SocketContext s)
+void ScopeFunClient::attach(uint clientId, SocketContext s)
 {
+    // frame handed over after the previous connection in this slot closed
+    if(sync.consumerLock())
+    {
+        if(frame)
+        {
+            frame->release();
+        }
+        sync.consumerUnlock();
+    }
+    SDL_AtomicSet(&bytes, 0);
     SDL_memset(&simulate,  0, sizeof(SSimulate));
     SDL_memset(&display,   0, sizeof(SDisplay));
     SDL_memset(&frameInfo, 0, sizeof(SFrameInfo));
     SDL_AtomicSet(&active, 1);
     SDL_AtomicSet(&captureType, SCOPEFUN_CAPTURE_TYPE_NONE);
+    SDL_AtomicSet(&lag, 0);
+    sequence = 0;
+    stream      = false;
+    streamBytes = 0;
+    streamType  = SCOPEFUN_CAPTURE_TYPE_NONE;
+    credit      = 0;
+    frame = 0;
     id = clientId;
     socket = s;
+}
+
+void ScopeFunClient::start(uint clientId, SocketContext s)
+{
+    attach(clientId, s);
     thread = (SDL_Thread*)createClient(this);
 }
 
@@ -123,7 +202,14 @@ int ServerManager::startServer(const char* ip, int portNumber)
         ip   = ip;
         port = portNumber;
         SDL_AtomicSet(&serverThreadActive,1);
-        serverThread = (SDL_Thread*)createServer(ip, port);
+        if(eventLoop)
+        {
+            serverThread = (SDL_Thread*)createEventServer(ip, port);
+        }
+        else
+        {
+            serverThread = (SDL_Thread*)createServer(ip, port);
+        }
     }
     return 0;
 }
@@ -163,6 +249,37 @@ int ServerManager::killClient(int id)
     return 0;
 }
 
+ScopeFunFrame* ServerManager::acquireFrame()
+{
+    // a frame is reused once every client has sent it
+    for(int i = 0; i < framePool.getCount(); i++)
+    {
+        ScopeFunFrame* pFrame = framePool[i];
+        if(SDL_AtomicCAS(&pFrame->ref, 0, 1) == SDL_TRUE)
+        {
+            SDL_AtomicSet(&pFrame->transfered, 0);
+            pFrame->sequence = ++frameSequence;
+            return pFrame;
+        }
+    }
+    // every frame is still held by a client, drop this capture
+    SDL_AtomicIncRef(&frameDropped);
+    return 0;
+}
+
+uint ServerManager::framePoolUsed()
+{
+    uint used = 0;
+    for(int i = 0; i < framePool.getCount(); i++)
+    {
+        if(!framePool[i]->isFree())
+        {
+            used++;
+        }
+    }
+    return used;
+}
+
 int ServerManager::stopServer()
 {
     if(SDL_AtomicGet(&serverThreadActive)>0)
@@ -184,6 +301,11 @@ int ServerManager::init()
 {
     maxMemory = 16 * MEGABYTE;
     maxClient = SCOPEFUN_MAX_CLIENT;
+    framePoolSize = SERVER_FRAME_POOL;
+    frameSequence = 0;
+    SDL_AtomicSet(&frameDropped, 0);
+    eventLoop = false;
+    replayRate = 0;
     SDL_AtomicSet(&updateSimulation, 0);
     // server
     serverLockApi = 0;
@@ -210,8 +332,12 @@ int ServerManager::init()
 
 int ServerManager::allocate()
 {
-    // capture buffer
-    captureBuffer = (SFrameData*)pMemory->allocate(maxMemory);
+    // frame pool
+    framePoolSize = clamp<uint>(framePoolSize, 2, SERVER_FRAME_POOL_MAX);
+    for(uint i = 0; i < framePoolSize; i++)
+    {
+        framePool.pushBack(new ScopeFunFrame(maxMemory));
+    }
     // clients
     for(uint i = 0; i < maxClient; i++)
     {
@@ -224,7 +350,11 @@ int ServerManager::allocate()
 
 int ServerManager::free()
 {
-    pMemory->free(captureBuffer);
+    for(int i = 0; i < framePool.getCount(); i++)
+    {
+        delete framePool[i];
+    }
+    framePool.clear();
     for(uint i = 0; i < maxClient; i++)
     {
         delete client[i];
@@ -235,6 +365,7 @@ int ServerManager::free()
 
 int ServerManager::start()
 {
+    ularge startupTicks = SDL_GetPerformanceCounter();
     allocate();
     sfApiInit();
     sfApiCreateContext(&ctx, maxMemory);
@@ -242,8 +373,21 @@ int ServerManager::start()
     sfSetActive(&ctx, 1);
     sfSetUsb(&ctx);
     sfSetTimeOut(&ctx, -1);
+    if(replay.getLength() > 0)
+    {
+        sfSetReplay(&ctx, replay.asChar(), replayRate);
+    }
     startServer(ip.asChar(), port);
     startCapture();
+    // startup time and memory
+    startupTicks = SDL_GetPerformanceCounter() - startupTicks;
+    char text[SERVER_LOG_TEXT] = { 0 };
+    SDL_snprintf(text, SERVER_LOG_TEXT, "startup: %u ms, frames: %u x %u MB, peak rss: %u MB",
+                 uint(startupTicks * 1000 / SDL_GetPerformanceFrequency()),
+                 framePoolSize,
+                 uint(maxMemory / MEGABYTE),
+                 uint(mapPeakResident() / MEGABYTE));
+    serverLogAdd(slMessage, text);
     return 0;
 }
 
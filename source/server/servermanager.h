@@ -23,6 +23,9 @@
 #define CLIENT_RECV_BUFFER (4*MEGABYTE + KILOBYTE)
 #define CLIENT_SEND_BUFFER (256*KILOBYTE)
 
+#define SERVER_FRAME_POOL     3
+#define SERVER_FRAME_POOL_MAX (SCOPEFUN_MAX_CLIENT + 2)
+
 extern "C" {
 #include<api/scopefunapi.h>
 }
@@ -34,6 +37,25 @@ enum ETimer
     TIMER_SERVER,
 };
 
+// frame, shared by all clients that requested it
+class ScopeFunFrame
+{
+public:
+    SFrameData*                     data;
+    ularge                          size;
+    uint                            reserved;
+    SDL_atomic_t                    ref;
+    SDL_atomic_t                    transfered;
+    uint                            sequence;
+public:
+    ScopeFunFrame(ularge maxMemory);
+    ~ScopeFunFrame();
+public:
+    void acquire();
+    void release();
+    bool isFree();
+};
+
 // client
 class ScopeFunClient
 {
@@ -45,10 +67,16 @@ public:
     char                            recv[CLIENT_RECV_BUFFER];
     char                            send[CLIENT_SEND_BUFFER];
 public:
-    SFrameData*                     buffer;
+    ScopeFunFrame*                  frame;
     SDL_atomic_t                    bytes;
-    SDL_atomic_t                    transfered;
     SDL_atomic_t                    captureType;
+    SDL_atomic_t                    lag;
+    uint                            sequence;
+public:
+    bool                            stream;
+    uint                            streamBytes;
+    uint                            streamType;
+    uint                            credit;
 public:
     ConsumerThreadLock              sync;
     SDL_atomic_t                    active;
@@ -65,6 +93,7 @@ public:
     ScopeFunClient(uint maxMemory);
     ~ScopeFunClient();
 public:
+    void attach(uint id, SocketContext socket);
     void start(uint id, SocketContext socket);
     void stop(bool wait);
     bool waitToStop();
@@ -84,7 +113,10 @@ public:
     SFContext          ctx;
     SocketContext      socket;
 public:
-    SFrameData*  captureBuffer;
+    Array<ScopeFunFrame*, SERVER_FRAME_POOL_MAX> framePool;
+    uint                                          framePoolSize;
+    uint                                          frameSequence;
+    SDL_atomic_t                                  frameDropped;
 public:
     SDL_atomic_t firmwareUploaded;
     SDL_atomic_t firmwareConfigured;
@@ -98,6 +130,9 @@ public:
     SDL_atomic_t serverThreadActive;
     String       ip;
     uint         port;
+    bool         eventLoop;
+    String       replay;
+    uint         replayRate;
 public:
     SDL_Thread*  usbThread;
     bool         usbThreadActive;
@@ -116,6 +151,9 @@ public:
     int stopCapture();
 public:
     int killClient(int id);
+public:
+    ScopeFunFrame* acquireFrame();
+    uint           framePoolUsed();
 public:
     int init();
 public:
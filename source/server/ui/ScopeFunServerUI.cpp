@@ -19,13 +19,20 @@
 //
 ////////////////////////////////////////////////////////////////////////////////
 #include "ScopeFunServerUI.h"
+#include <server/serverlog.h>
 
 #include <wx/app.h>
 
+#define LOG_TIMER_MS 100
+
 ScopeFunServerUI::ScopeFunServerUI(wxWindow* parent)
     :
     ServerUI(parent)
 {
+    // server threads only write into the log ring, the ui drains it
+    logTimer.SetOwner(this);
+    Bind(wxEVT_TIMER, &ScopeFunServerUI::logTimerOnTimer, this, logTimer.GetId());
+    logTimer.Start(LOG_TIMER_MS);
 }
 
 extern "C" {
@@ -38,7 +45,9 @@ extern "C" {
     extern char* xpm512_xpm[];
 };
 
-void msgListBoxRemove(wxListBox* list, const char* message);
+void msgListBoxAdd(void* list, const char* message);
+void msgListBoxRemove(void* list, const char* message);
+void msgListBoxClear(void* list);
 
 void ScopeFunServerUI::ServerUIOnActivate(wxActivateEvent& event)
 {
@@ -122,6 +131,27 @@ void ScopeFunServerUI::m_textCtrl3OnTextEnter(wxCommandEvent& event)
 {
 }
 
+void ScopeFunServerUI::logTimerOnTimer(wxTimerEvent& event)
+{
+    ServerLogEntry entry;
+    while(serverLog.pop(entry))
+    {
+        wxListBox* list = (entry.list == slClient) ? m_listBox2 : m_listBox1;
+        switch(entry.action)
+        {
+            case saAdd:
+                msgListBoxAdd(list, entry.text);
+                break;
+            case saRemove:
+                msgListBoxRemove(list, entry.text);
+                break;
+            case saClear:
+                msgListBoxClear(list);
+                break;
+        };
+    }
+}
+
 
 void ScopeFunServerUI::msgVersion()
 {
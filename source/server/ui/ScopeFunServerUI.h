@@ -27,6 +27,7 @@ Subclass of ServerUI, which is generated by wxFormBuilder.
 */
 
 #include "serverui.h"
+#include <wx/timer.h>
 
 //// end generated include
 
@@ -42,6 +43,9 @@ protected:
     void m_checkBox1OnCheckBox(wxCommandEvent& event);
     void m_checkBox2OnCheckBox(wxCommandEvent& event);
     void m_textCtrl3OnTextEnter(wxCommandEvent& event);
+    void logTimerOnTimer(wxTimerEvent& event);
+public:
+    wxTimer logTimer;
 public:
     /** Constructor */
     ScopeFunServerUI(wxWindow* parent);
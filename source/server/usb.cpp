@@ -20,6 +20,7 @@
 ////////////////////////////////////////////////////////////////////////////////
 #include<core/core.h>
 #include<server/servermanager.h>
+#include<server/server.h>
 
 ////////////////////////////////////////////////////////////////////
 // capture thread
@@ -54,12 +55,30 @@ int SDLCALL CaptureThreadFunction(void* data)
     SDL_SetThreadPriority(SDL_THREAD_PRIORITY_HIGH);
     pTimer->init(TIMER_CAPTURE);
     double      timer  = 0;
+    double  statsTimer = 0;
     SDL_MemoryBarrierAcquire();
     while(SDL_AtomicGet(&pServer->serverThreadActive)>0)
     {
         SDL_Delay(1);
         pTimer->deltaTime(TIMER_CAPTURE);
         timer += pTimer->getDelta(TIMER_CAPTURE);
+        statsTimer += pTimer->getDelta(TIMER_CAPTURE);
+        if(statsTimer > 1.0)
+        {
+            FORMAT_BUFFER();
+            FORMAT("frame pool %d/%d dropped %d", pServer->framePoolUsed(), pServer->framePool.getCount(), SDL_AtomicGet(&pServer->frameDropped));
+            errorMessage(formatBuffer);
+            for(int i = 0; i < pServer->client.getCount(); i++)
+            {
+                ScopeFunClient* pClient = pServer->client[i];
+                if(SDL_AtomicGet(&pClient->active) > 0)
+                {
+                    FORMAT("Client %d | lag %d", pClient->id, SDL_AtomicGet(&pClient->lag));
+                    errorMessage(formatBuffer);
+                }
+            }
+            statsTimer = 0;
+        }
         int opened     = 0;
         int uploaded   = SDL_AtomicGet(&pServer->firmwareUploaded);
         int configured = SDL_AtomicGet(&pServer->firmwareConfigured);
@@ -164,42 +183,67 @@ int SDLCALL CaptureThreadFunction(void* data)
                 continue;
             }
 
+            // frame from pool
+            ScopeFunFrame* pFrame = pServer->acquireFrame();
+            if(!pFrame)
+            {
+                continue;
+            }
+
             // usb
             int transfered = 0;
-            int ret = sfHardwareCapture(&pServer->ctx, (SFrameData*)pServer->captureBuffer, bytesToReceive, &transfered, SCOPEFUN_CAPTURE_TYPE_NONE);
+            int ret = sfHardwareCapture(&pServer->ctx, pFrame->data, bytesToReceive, &transfered, SCOPEFUN_CAPTURE_TYPE_NONE);
+            SDL_AtomicSet(&pFrame->transfered, max(transfered, 0));
 
             // debug
             FORMAT_BUFFER();
             FORMAT("sfHardwareCapture: toReceive %d transfered %d",bytesToReceive, transfered);
             errorMessage(formatBuffer);
 
-            // copy buffers to send data over network
+            // lag, active clients that did not request this frame
+            for(int i = 0; i < pServer->client.getCount(); i++)
+            {
+                ScopeFunClient* pClient = pServer->client[i];
+                if(SDL_AtomicGet(&pClient->active) > 0 && request.find(pClient) < 0)
+                {
+                    SDL_AtomicIncRef(&pClient->lag);
+                }
+            }
+
+            // every client takes a reference to the same frame
+            int handed = 0;
             for(int i = 0; i < request.getCount(); i++)
             {
                 ScopeFunClient* pClient = request[i];
 
-                // lock
-                while(!pClient->sync.producerLock())
+                // lock, a client still holding its previous frame lags and keeps its request
+                if(!pClient->sync.producerLock())
                 {
-                    SDL_Delay(1);
+                    SDL_AtomicIncRef(&pClient->lag);
+                    continue;
                 }
 
-                // copy frame
-                if(transfered > 0)
-                {
-                    SDL_AtomicSet(&pClient->transfered, transfered);
-                    SDL_memcpy((void*)&pClient->buffer->data.bytes[0], (void*) & ((SFrameData*)pServer->captureBuffer)->data.bytes[0], transfered);
-                }
+                // share frame
+                pFrame->acquire();
+                pClient->frame    = pFrame;
+                pClient->sequence = pFrame->sequence;
 
                 // captureType
                 SDL_AtomicSet(&pClient->captureType, SCOPEFUN_CAPTURE_TYPE_NONE);
 
-                // unlock
-                while(!pClient->sync.producerUnlock())
-                {
-                    SDL_Delay(1);
-                }
+                // unlock, only the producer moves the lock out of this state
+                pClient->sync.producerUnlock();
+                handed++;
+            }
+
+            // event server sends the frame without polling
+            if(handed > 0)
+            {
+                eventServerWake();
             }
+
+            // capture reference
+            pFrame->release();
         }
         else
         {
@@ -7,6 +7,7 @@ add_library(sfAPI MODULE
 "${CMAKE_SOURCE_DIR}/lib/libusb-1.0.22/examples/ezusb.c"
 "${CMAKE_SOURCE_DIR}/source/core/purec/puresocket.c"
 "${CMAKE_SOURCE_DIR}/source/core/purec/pureusb.c"
+"${CMAKE_SOURCE_DIR}/source/core/purec/purerle.c"
 "${CMAKE_SOURCE_DIR}/source/core/purec/purec.c" 
 "${CMAKE_SOURCE_DIR}/source/api/scopefun.c"
 "${CMAKE_SOURCE_DIR}/source/api/scopefunapi_wrap_python.c" )
@@ -0,0 +1,104 @@
+cmake_minimum_required (VERSION 2.8)
+
+# sfBench, signal pipeline benchmarks, build with: cmake --build . --target sfBench
+add_executable(sfBench EXCLUDE_FROM_ALL
+#cpp
+"${CMAKE_SOURCE_DIR}/source/core/input/input.cpp"
+"${CMAKE_SOURCE_DIR}/source/core/core.cpp"
+"${CMAKE_SOURCE_DIR}/source/core/string/corestring.cpp"
+"${CMAKE_SOURCE_DIR}/source/core/format/format.cpp"
+"${CMAKE_SOURCE_DIR}/source/core/render/font/font.cpp"
+"${CMAKE_SOURCE_DIR}/source/core/render/canvas/canvas2d.cpp"
+"${CMAKE_SOURCE_DIR}/source/core/render/canvas/canvas3d.cpp"
+"${CMAKE_SOURCE_DIR}/source/core/render/render/render.cpp"
+"${CMAKE_SOURCE_DIR}/source/core/render/camera/camera.cpp"
+"${CMAKE_SOURCE_DIR}/source/core/opengl/opengl_devicestate.cpp"
+"${CMAKE_SOURCE_DIR}/source/core/opengl/opengl_texture.cpp"
+"${CMAKE_SOURCE_DIR}/source/core/opengl/opengl_device.cpp"
+"${CMAKE_SOURCE_DIR}/source/core/opengl/opengl_staticmesh.cpp"
+"${CMAKE_SOURCE_DIR}/source/core/opengl/opengl.cpp"
+"${CMAKE_SOURCE_DIR}/source/core/opengl/opengl_shader.cpp"
+"${CMAKE_SOURCE_DIR}/source/core/memory/memory.cpp"
+"${CMAKE_SOURCE_DIR}/source/core/manager/manager.cpp"
+"${CMAKE_SOURCE_DIR}/source/core/file/file.cpp"
+"${CMAKE_SOURCE_DIR}/source/core/timer/timer.cpp"
+"${CMAKE_SOURCE_DIR}/source/osciloscope/osciloscope.cpp"
+"${CMAKE_SOURCE_DIR}/source/osciloscope/gui/OsciloskopOsciloskop.cpp"
+"${CMAKE_SOURCE_DIR}/source/osciloscope/gui/OsciloskopMeasure.cpp"
+"${CMAKE_SOURCE_DIR}/source/osciloscope/gui/OsciloskopDebug.cpp"
+"${CMAKE_SOURCE_DIR}/source/osciloscope/gui/OsciloskopHardwareGenerator.cpp"
+"${CMAKE_SOURCE_DIR}/source/osciloscope/gui/OsciloskopThermal.cpp"
+"${CMAKE_SOURCE_DIR}/source/osciloscope/gui/OsciloskopInfo.cpp"
+"${CMAKE_SOURCE_DIR}/source/osciloscope/gui/osc.cpp"
+"${CMAKE_SOURCE_DIR}/source/osciloscope/gui/OsciloskopDisplay.cpp"
+"${CMAKE_SOURCE_DIR}/source/osciloscope/gui/OsciloskopStorage.cpp"
+"${CMAKE_SOURCE_DIR}/source/osciloscope/gui/OsciloskopConnection.cpp"
+"${CMAKE_SOURCE_DIR}/source/osciloscope/gui/OsciloskopSoftwareGenerator.cpp"
+"${CMAKE_SOURCE_DIR}/source/osciloscope/osciloscope/oscrender.cpp"
+"${CMAKE_SOURCE_DIR}/source/osciloscope/osciloscope/oscsignal.cpp"
+"${CMAKE_SOURCE_DIR}/source/osciloscope/osciloscope/oscdecode.cpp"
+"${CMAKE_SOURCE_DIR}/source/osciloscope/osciloscope/oscfile.cpp"
+"${CMAKE_SOURCE_DIR}/source/osciloscope/osciloscope/oscfft.cpp"
+"${CMAKE_SOURCE_DIR}/source/osciloscope/osciloscope/oscsettings.cpp"
+"${CMAKE_SOURCE_DIR}/source/osciloscope/osciloscope/oscmng.cpp"
+"${CMAKE_SOURCE_DIR}/source/osciloscope/osciloscope/osccontrol.cpp"
+"${CMAKE_SOURCE_DIR}/source/osciloscope/window/wndshadow.cpp"
+"${CMAKE_SOURCE_DIR}/source/osciloscope/window/wndmain.cpp"
+"${CMAKE_SOURCE_DIR}/source/osciloscope/window/tool.cpp"
+"${CMAKE_SOURCE_DIR}/source/osciloscope/window/wnddisplay.cpp"
+"${CMAKE_SOURCE_DIR}/source/osciloscope/window/wndgenerate.cpp"
+"${CMAKE_SOURCE_DIR}/source/osciloscope/app/managers.cpp"
+"${CMAKE_SOURCE_DIR}/source/test/sfbench.cpp"
+#c
+"${CMAKE_SOURCE_DIR}/lib/cJSON/cJSON.c"
+"${CMAKE_SOURCE_DIR}/lib/glew-1.13.0/src/glew.c"
+"${CMAKE_SOURCE_DIR}/lib/kiss_fft130/kiss_fft.c"
+"${CMAKE_SOURCE_DIR}/lib/kiss_fft130/tools/kiss_fftr.c"
+"${CMAKE_SOURCE_DIR}/lib/libusb-1.0.22/examples/ezusb.c"
+"${CMAKE_SOURCE_DIR}/source/core/purec/puresocket.c"
+"${CMAKE_SOURCE_DIR}/source/core/purec/puremap.c"
+"${CMAKE_SOURCE_DIR}/source/core/purec/pureusb.c"
+"${CMAKE_SOURCE_DIR}/source/core/purec/purerle.c"
+"${CMAKE_SOURCE_DIR}/source/core/purec/purec.c"
+"${CMAKE_SOURCE_DIR}/source/api/scopefun.c"
+"${CMAKE_SOURCE_DIR}/source/osciloscope/xpm/xpm96.c"
+"${CMAKE_SOURCE_DIR}/source/osciloscope/xpm/xpm512.c"
+"${CMAKE_SOURCE_DIR}/source/osciloscope/xpm/xpm64.c"
+"${CMAKE_SOURCE_DIR}/source/osciloscope/xpm/xpm256.c"
+"${CMAKE_SOURCE_DIR}/source/osciloscope/xpm/xpm16.c"
+"${CMAKE_SOURCE_DIR}/source/osciloscope/xpm/xpm32.c"
+"${CMAKE_SOURCE_DIR}/source/osciloscope/xpm/xpm128.c"
+)
+
+# output
+set_target_properties(sfBench
+    PROPERTIES
+    LIBRARY_OUTPUT_DIRECTORY  "${CMAKE_SOURCE_DIR}/bin"
+    RUNTIME_OUTPUT_DIRECTORY "${CMAKE_SOURCE_DIR}/bin"
+)
+
+# sfBench name
+set_target_properties(sfBench PROPERTIES OUTPUT_NAME "sfBench${SCOPEFUN_TYPE}")
+
+# 32 bit?
+if(SCOPEFUN_32BIT)
+  if(SCOPEFUN_LINUX)
+	set_target_properties(sfBench  PROPERTIES COMPILE_FLAGS "-m32 -no-pie" LINK_FLAGS "-m32 -no-pie")
+  else()
+    set_target_properties(sfBench  PROPERTIES COMPILE_FLAGS "-m32" LINK_FLAGS "-m32")
+  endif()
+else()
+  if(SCOPEFUN_LINUX)
+	set_target_properties(sfBench  PROPERTIES COMPILE_FLAGS "-no-pie" LINK_FLAGS "-no-pie")
+  endif()
+endif ()
+
+# link sfBench
+target_link_libraries(sfBench "${SCOPEFUN_LIBS}")
+
+# run all benchmarks and write bin/bench.json
+add_custom_target(bench
+    COMMAND sfBench -o "${CMAKE_SOURCE_DIR}/bin/bench.json"
+    DEPENDS sfBench
+    WORKING_DIRECTORY "${CMAKE_SOURCE_DIR}/bin"
+)
@@ -7,7 +7,7 @@ set(SCOPEFUN_LIB_INCLUDE_USB_EZ    "${CMAKE_SOURCE_DIR}/lib/libusb-1.0.22/exampl
 set(SCOPEFUN_LIB_INCLUDE_SDL2      "${CMAKE_SOURCE_DIR}/lib/SDL2-2.0.9/include"       CACHE PATH "include fodler for SDL2 library " FORCE)
 set(SCOPEFUN_LIB_INCLUDE_WX        "${CMAKE_SOURCE_DIR}/lib/wxWidgets-3.0.4/include"  CACHE PATH "include fodler for wxWidgets library" FORCE)      
 set(SCOPEFUN_LIB_INCLUDE_CJSON     "${CMAKE_SOURCE_DIR}/lib/cJSON"                CACHE PATH "include folder for cjson" FORCE)
-set(SCOPEFUN_LIB_INCLUDE_KISSFFT   "${CMAKE_SOURCE_DIR}/lib/kissfft130"           CACHE PATH "include folder for kissfft" FORCE)
+set(SCOPEFUN_LIB_INCLUDE_KISSFFT   "${CMAKE_SOURCE_DIR}/lib/kiss_fft130"          CACHE PATH "include folder for kissfft" FORCE)
 set(SCOPEFUN_LIB_INCLUDE_GLEW      "${CMAKE_SOURCE_DIR}/lib/glew-1.13.0/include"  CACHE PATH "include folder for glew" FORCE)
 
 # visual studio x64
@@ -103,6 +103,20 @@ set(SCOPEFUN_LIBS
 	"Rpcrt4.lib"
 	"${CMAKE_SOURCE_DIR}/source/osciloscope/rc/osc.res"
 )
+
+set(SCOPEFUN_LIBS_HEADLESS 
+	"${SCOPEFUN_LIB_LINK_USB}/libusb-1.0.lib"
+	"${SCOPEFUN_LIB_LINK_SDL2}/SDL2.lib"
+	"winmm.lib"
+	"ole32.lib"
+	"imm32.lib"
+	"version.lib"
+	"uuid.lib"
+	"oleaut32.lib"
+	"ws2_32.lib"
+	"setupapi.lib"
+	"hid.lib"
+)
 else()
 
 set(SCOPEFUN_LIBS
@@ -148,6 +162,21 @@ set(SCOPEFUN_LIBS
 "${CMAKE_SOURCE_DIR}/source/osciloscope/rc/osc.res"
 )
 
+set(SCOPEFUN_LIBS_HEADLESS
+"mingw32.a" 
+"${SCOPEFUN_LIB_LINK_USB}/libusb-1.0.a"
+"${SCOPEFUN_LIB_LINK_SDL2}/libSDL2.a"
+"winmm.a"
+"ole32.a"
+"imm32.a"
+"version.a"
+"uuid.a"
+"oleaut32.a"
+"ws2_32.a"
+"setupapi.a"
+"hid.a"
+)
+
 endif()
 
 endif()
@@ -195,6 +224,22 @@ set(SCOPEFUN_LIBS
 "-framework Metal"
 )
 
+set(SCOPEFUN_LIBS_HEADLESS 
+"iconv.a"
+"${SCOPEFUN_LIB_LINK_USB}/libusb-1.0.a"
+"${SCOPEFUN_LIB_LINK_SDL2}/libSDL2.a"
+"-framework CoreFoundation"
+"-framework AudioUnit"
+"-framework AudioToolbox"
+"-framework ForceFeedback"
+"-framework IOKit"
+"-framework Carbon"
+"-framework Cocoa"
+"-framework CoreAudio"
+"-framework CoreVideo"
+"-framework Metal"
+)
+
 endif()
 
 if(SCOPEFUN_LINUX)
@@ -244,5 +289,14 @@ set(SCOPEFUN_LIBS
 "Xxf86vm"
 )
 
+set(SCOPEFUN_LIBS_HEADLESS 
+"${SCOPEFUN_LIB_LINK_USB}/libusb-1.0.a"
+"${SCOPEFUN_LIB_LINK_SDL2}/libSDL2.a"
+"dl"
+"m"
+"pthread"
+"udev"
+)
+
 endif()
 
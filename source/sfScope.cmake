@@ -36,6 +36,7 @@ add_executable(sfScope ${SCOPEFUN_EXE_TYPE}
 "${CMAKE_SOURCE_DIR}/source/osciloscope/gui/OsciloskopSoftwareGenerator.cpp"
 "${CMAKE_SOURCE_DIR}/source/osciloscope/osciloscope/oscrender.cpp"
 "${CMAKE_SOURCE_DIR}/source/osciloscope/osciloscope/oscsignal.cpp"
+"${CMAKE_SOURCE_DIR}/source/osciloscope/osciloscope/oscdecode.cpp"
 "${CMAKE_SOURCE_DIR}/source/osciloscope/osciloscope/oscfile.cpp"
 "${CMAKE_SOURCE_DIR}/source/osciloscope/osciloscope/oscfft.cpp"
 "${CMAKE_SOURCE_DIR}/source/osciloscope/osciloscope/oscsettings.cpp"
@@ -52,9 +53,12 @@ add_executable(sfScope ${SCOPEFUN_EXE_TYPE}
 "${CMAKE_SOURCE_DIR}/lib/cJSON/cJSON.c"
 "${CMAKE_SOURCE_DIR}/lib/glew-1.13.0/src/glew.c"
 "${CMAKE_SOURCE_DIR}/lib/kiss_fft130/kiss_fft.c"
+"${CMAKE_SOURCE_DIR}/lib/kiss_fft130/tools/kiss_fftr.c"
 "${CMAKE_SOURCE_DIR}/lib/libusb-1.0.22/examples/ezusb.c"
 "${CMAKE_SOURCE_DIR}/source/core/purec/puresocket.c"
+"${CMAKE_SOURCE_DIR}/source/core/purec/puremap.c"
 "${CMAKE_SOURCE_DIR}/source/core/purec/pureusb.c"
+"${CMAKE_SOURCE_DIR}/source/core/purec/purerle.c"
 "${CMAKE_SOURCE_DIR}/source/core/purec/purec.c"
 "${CMAKE_SOURCE_DIR}/source/api/scopefun.c"
 "${CMAKE_SOURCE_DIR}/source/osciloscope/xpm/xpm96.c"
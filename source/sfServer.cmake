@@ -24,6 +24,8 @@ add_executable(sfServer ${SCOPEFUN_EXE_TYPE}
 "${CMAKE_SOURCE_DIR}/source/core/opengl/opengl_shader.cpp"
 "${CMAKE_SOURCE_DIR}/source/server/main.cpp"
 "${CMAKE_SOURCE_DIR}/source/server/server.cpp"
+"${CMAKE_SOURCE_DIR}/source/server/serverevent.cpp"
+"${CMAKE_SOURCE_DIR}/source/server/serverlog.cpp"
 "${CMAKE_SOURCE_DIR}/source/server/servermanager.cpp"
 "${CMAKE_SOURCE_DIR}/source/server/usb.cpp"
 "${CMAKE_SOURCE_DIR}/source/server/ui/serverui.cpp"
@@ -34,7 +36,9 @@ add_executable(sfServer ${SCOPEFUN_EXE_TYPE}
 "${CMAKE_SOURCE_DIR}/lib/kiss_fft130/kiss_fft.c"
 "${CMAKE_SOURCE_DIR}/lib/libusb-1.0.22/examples/ezusb.c"
 "${CMAKE_SOURCE_DIR}/source/core/purec/puresocket.c"
+"${CMAKE_SOURCE_DIR}/source/core/purec/puremap.c"
 "${CMAKE_SOURCE_DIR}/source/core/purec/pureusb.c"
+"${CMAKE_SOURCE_DIR}/source/core/purec/purerle.c"
 "${CMAKE_SOURCE_DIR}/source/core/purec/purec.c"
 "${CMAKE_SOURCE_DIR}/source/api/scopefun.c"
 "${CMAKE_SOURCE_DIR}/source/osciloscope/xpm/xpm96.c"
@@ -72,4 +76,53 @@ else()
 endif ()
 
 # link sfServer
-target_link_libraries(sfServer "${SCOPEFUN_LIBS}")
\ No newline at end of file
+target_link_libraries(sfServer "${SCOPEFUN_LIBS}")
+
+# sfServerHeadless, no wxWidgets and no rendering
+add_executable(sfServerHeadless
+"${CMAKE_SOURCE_DIR}/source/server/mainheadless.cpp"
+"${CMAKE_SOURCE_DIR}/source/core/core.cpp"
+"${CMAKE_SOURCE_DIR}/source/core/string/corestring.cpp"
+"${CMAKE_SOURCE_DIR}/source/core/format/format.cpp"
+"${CMAKE_SOURCE_DIR}/source/core/memory/memory.cpp"
+"${CMAKE_SOURCE_DIR}/source/core/manager/manager.cpp"
+"${CMAKE_SOURCE_DIR}/source/core/file/file.cpp"
+"${CMAKE_SOURCE_DIR}/source/core/timer/timer.cpp"
+"${CMAKE_SOURCE_DIR}/source/server/server.cpp"
+"${CMAKE_SOURCE_DIR}/source/server/serverevent.cpp"
+"${CMAKE_SOURCE_DIR}/source/server/serverlog.cpp"
+"${CMAKE_SOURCE_DIR}/source/server/servermanager.cpp"
+"${CMAKE_SOURCE_DIR}/source/server/usb.cpp"
+"${CMAKE_SOURCE_DIR}/lib/libusb-1.0.22/examples/ezusb.c"
+"${CMAKE_SOURCE_DIR}/source/core/purec/puresocket.c"
+"${CMAKE_SOURCE_DIR}/source/core/purec/puremap.c"
+"${CMAKE_SOURCE_DIR}/source/core/purec/pureusb.c"
+"${CMAKE_SOURCE_DIR}/source/core/purec/purerle.c"
+"${CMAKE_SOURCE_DIR}/source/core/purec/purec.c"
+"${CMAKE_SOURCE_DIR}/source/api/scopefun.c" )
+
+# output
+set_target_properties(sfServerHeadless
+    PROPERTIES
+    LIBRARY_OUTPUT_DIRECTORY  "${CMAKE_SOURCE_DIR}/bin"
+    RUNTIME_OUTPUT_DIRECTORY "${CMAKE_SOURCE_DIR}/bin"
+)
+
+# sfServerHeadless name
+set_target_properties(sfServerHeadless PROPERTIES OUTPUT_NAME "sfServerHeadless${SCOPEFUN_TYPE}")
+
+# 32 bit?
+if(SCOPEFUN_32BIT)
+  if(SCOPEFUN_LINUX)
+	set_target_properties(sfServerHeadless PROPERTIES COMPILE_FLAGS "-m32 -no-pie" LINK_FLAGS "-m32 -no-pie")
+  else()
+	set_target_properties(sfServerHeadless PROPERTIES COMPILE_FLAGS "-m32" LINK_FLAGS "-m32")
+  endif()
+else()
+  if(SCOPEFUN_LINUX)
+	set_target_properties(sfServerHeadless PROPERTIES COMPILE_FLAGS "-no-pie" LINK_FLAGS "-no-pie")
+  endif()
+endif ()
+
+# link sfServerHeadless
+target_link_libraries(sfServerHeadless "${SCOPEFUN_LIBS_HEADLESS}")
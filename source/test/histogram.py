@@ -38,10 +38,8 @@ fig, ax = plt.subplots()
 y1 = 500 * np.sin(2 * np.pi * 500 * x / 10000)
 n, bins, patches = plt.hist(y1, 50, facecolor='green', alpha=0.75)
 
-def complement(val):
-    if (val & (1 << 9)) != 0: # sign bit
-        val = val - (1 << 10) # negative value
-    return val 
+# decoded channel 0, filled in place by sfFrameDecode
+ch0 = np.zeros(10000, dtype=np.int16)
 	
 # callback
 def animate(frameno):
@@ -53,18 +51,8 @@ def animate(frameno):
     ret,transfered = scopefunapi.sfHardwareCapture(ctx,frame,40960,2)
     if transfered == 40960:
         # input
-        for i in range(10000):
-            mask0 = 1020
-            mask1 = 3
-            mask2 = 511
-            data0 = frame.data[(i*4)]
-            data1 = frame.data[(i*4)+1]
-            hi  = data0 << 2
-            hi  = hi & mask0
-            lo  = data1 >> 6
-            lo  = lo & mask1
-            value = hi | lo
-            y1[i] = complement(value)
+        ret,decoded = scopefunapi.sfFrameDecode(ctx,frame,0,ch0,None,None)
+        y1[:decoded] = ch0[:decoded]
         
         # draw histogram
         n, _ = np.histogram(y1, bins)
@@ -0,0 +1,60 @@
+import scopefunapi
+import time
+import sys
+
+# compare server models over loopback:
+#   sfServer       - thread per client
+#   sfServer -ev   - epoll event loop
+# usage: python latency.py [requests] [ip] [port]
+
+szCapture = 16*1024*1024
+szFrame   = 16*1024*1024
+
+count = 1000
+ip    = '127.0.0.1'
+port  = 42250
+if len(sys.argv) > 1:
+    count = int(sys.argv[1])
+if len(sys.argv) > 2:
+    ip = sys.argv[2]
+if len(sys.argv) > 3:
+    port = int(sys.argv[3])
+
+# setup
+ret = scopefunapi.sfApiInit()
+ctx = scopefunapi.sfCreateSFContext()
+ret = scopefunapi.sfApiCreateContext(ctx,szCapture)
+ret = scopefunapi.sfSetActive(ctx,1)
+ret = scopefunapi.sfSetThreadSafe(ctx,1)
+ret = scopefunapi.sfSetNetwork(ctx)
+ret = scopefunapi.sfSetFrameVersion(ctx,2)
+ret = scopefunapi.sfSetFrameHeader(ctx,1024)
+ret = scopefunapi.sfSetFrameData(ctx,40000)
+ret = scopefunapi.sfSetFramePacket(ctx,(1024*1024))
+
+print "sfClientConnect", ip, port
+ret = scopefunapi.sfClientConnect(ctx,ip,port)
+
+frame = scopefunapi.sfCreateSFrameData(ctx,szFrame)
+
+def measure(name,call):
+    samples = []
+    for i in range(0,count):
+        start = time.time()
+        call()
+        samples.append((time.time() - start)*1000.0)
+    samples.sort()
+    avg = sum(samples)/len(samples)
+    p50 = samples[len(samples)/2]
+    p99 = samples[min(len(samples)-1,(len(samples)*99)/100)]
+    print "%-24s avg %8.3f ms  p50 %8.3f ms  p99 %8.3f ms  max %8.3f ms" % (name,avg,p50,p99,samples[-1])
+
+# small request / reply
+measure("sfHardwareIsOpened", lambda: scopefunapi.sfHardwareIsOpened(ctx))
+
+# header capture
+measure("sfHardwareCapture(1024)", lambda: scopefunapi.sfHardwareCapture(ctx,frame,1024,1))
+
+# exit
+ret = scopefunapi.sfClientDisconnect(ctx)
+ret = scopefunapi.sfApiExit()
@@ -0,0 +1,1056 @@
+////////////////////////////////////////////////////////////////////////////////
+//    ScopeFun Oscilloscope ( http://www.scopefun.com )
+//    Copyright (C) 2016 - 2019 David Košenina
+//
+//    This file is part of ScopeFun Oscilloscope.
+//
+//    ScopeFun Oscilloscope is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    ScopeFun Oscilloscope is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with this ScopeFun Oscilloscope.  If not, see <http://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////////////
+/*--------------------------------------------------------------------
+   signal pipeline benchmark
+
+   times the decode, rle, fft, measure, custom function and history
+   stages of the gui pipeline, the memory manager, the simulate
+   generator and the server loopback capture rate, results are
+   written as json so runs can be compared between releases, human
+   readable lines go to stderr
+
+   server loopback needs a running server with a device, simulation
+   or -replay, it is reported as skipped when the connect fails
+
+   build: cmake --build . --target sfBench
+   usage: sfBench [-o file] [-t seconds] [-f filter] [-ip ip] [-port port] [-dir path]
+--------------------------------------------------------------------*/
+#include<osciloscope/osciloscope.h>
+#include<sfversion.h>
+
+#include<stdio.h>
+
+#define BENCH_SECONDS        0.5
+#define BENCH_ITERATIONS     3
+#define BENCH_FRAME_SAMPLES  (1024 * 1024)
+#define BENCH_DISPLAY_STEP   100
+#define BENCH_RLE_BYTES      (16 * MEGABYTE)
+#define BENCH_EXPORT_BYTES   (64 * MEGABYTE)
+#define BENCH_HISTORY_BYTES  (64 * MEGABYTE)
+#define BENCH_HISTORY_FRAME  4
+#define BENCH_SERVER_MEMORY  (16 * MEGABYTE)
+#define BENCH_SERVER_DATA    40960
+#define BENCH_MEMORY_WINDOW  64
+#define BENCH_MEMORY_STEPS   100000
+#define BENCH_MEMORY_THREADS 8
+#define BENCH_SIMULATE_DATA  (8 * MEGABYTE)
+
+extern void create();
+
+////////////////////////////////////////////////////////////////////////////////
+// runner
+////////////////////////////////////////////////////////////////////////////////
+typedef ularge (*BenchFunction)(void* user);
+
+volatile double benchSink = 0;
+
+class Bench
+{
+public:
+    double      seconds;
+    const char* filter;
+    cJSON*      results;
+public:
+    Bench() : seconds(BENCH_SECONDS), filter(0), results(0) {};
+public:
+    bool enabled(const char* name)
+    {
+        return !filter || SDL_strstr(name, filter) != 0;
+    }
+    cJSON* run(const char* name, BenchFunction function, void* user, ularge items)
+    {
+        if(!enabled(name))
+        {
+            return 0;
+        }
+        // warm up caches, plans and lazily committed memory
+        function(user);
+        ularge freq       = SDL_GetPerformanceFrequency();
+        ularge start      = SDL_GetPerformanceCounter();
+        ularge now        = start;
+        ularge bytes      = 0;
+        ularge iterations = 0;
+        while(iterations < BENCH_ITERATIONS || double(now - start) < seconds * double(freq))
+        {
+            bytes += function(user);
+            iterations++;
+            now = SDL_GetPerformanceCounter();
+        }
+        double elapsed = double(now - start) / double(freq);
+        double mbs     = double(bytes) / double(MEGABYTE) / elapsed;
+        double ips     = double(items * iterations) / elapsed;
+        cJSON* json = cJSON_CreateObject();
+        cJSON_AddItemToObject(json, "name", cJSON_CreateString(name));
+        cJSON_AddItemToObject(json, "iterations", cJSON_CreateNumber(double(iterations)));
+        cJSON_AddItemToObject(json, "seconds", cJSON_CreateNumber(elapsed));
+        cJSON_AddItemToObject(json, "nsPerIteration", cJSON_CreateNumber(elapsed * 1e9 / double(iterations)));
+        cJSON_AddItemToObject(json, "bytesPerIteration", cJSON_CreateNumber(double(bytes / iterations)));
+        cJSON_AddItemToObject(json, "mbPerSecond", cJSON_CreateNumber(mbs));
+        cJSON_AddItemToObject(json, "itemsPerSecond", cJSON_CreateNumber(ips));
+        cJSON_AddItemToArray(results, json);
+        fprintf(stderr, "%-32s %10.1f MB/s %14.0f items/s %12.0f ns\n", name, mbs, ips, elapsed * 1e9 / double(iterations));
+        return json;
+    }
+    void skip(const char* name, const char* reason)
+    {
+        if(!enabled(name))
+        {
+            return;
+        }
+        cJSON* json = cJSON_CreateObject();
+        cJSON_AddItemToObject(json, "name", cJSON_CreateString(name));
+        cJSON_AddItemToObject(json, "skipped", cJSON_CreateString(reason));
+        cJSON_AddItemToArray(results, json);
+        fprintf(stderr, "%-32s skipped, %s\n", name, reason);
+    }
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// synthetic frames
+////////////////////////////////////////////////////////////////////////////////
+ishort benchAnalog(uint i, double period, double amplitude)
+{
+    return ishort(clamp<int>(int(amplitude * sin(2.0 * PI * double(i) / period)), -512, 511));
+}
+
+void benchFrame1(byte* data, uint samples)
+{
+    for(uint i = 0; i < samples; i++)
+    {
+        ushort* sample = (ushort*)(data + i * 6);
+        sample[0] = ushort(benchAnalog(i, 1000.0, 400.0)) & 0x3FF;
+        sample[1] = ushort(benchAnalog(i, 333.0, 200.0)) & 0x3FF;
+        sample[2] = ushort(i);
+    }
+}
+
+void benchFrame2(byte* data, uint samples)
+{
+    for(uint i = 0; i < samples; i++)
+    {
+        uint word = (uint(benchAnalog(i, 1000.0, 400.0) & 0x3FF) << 22) | (uint(benchAnalog(i, 333.0, 200.0) & 0x3FF) << 12) | (i & 0xFFF);
+        byte* sample = data + i * 4;
+        sample[0] = byte(word >> 24);
+        sample[1] = byte(word >> 16);
+        sample[2] = byte(word >> 8);
+        sample[3] = byte(word >> 0);
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// decode
+////////////////////////////////////////////////////////////////////////////////
+class BenchDecode
+{
+public:
+    byte*             data;
+    uint              version;
+    uint              samples;
+    uint              step;
+    DecodeKernel      kernel;
+    OsciloscopeFrame* frame;
+};
+
+ularge benchDecode(void* user)
+{
+    BenchDecode* bench = (BenchDecode*)user;
+    DisplayDecode decode;
+    decode.data     = bench->data;
+    decode.version  = bench->version;
+    decode.start    = 0;
+    decode.end      = bench->samples;
+    decode.step     = bench->step;
+    decode.analog0  = &bench->frame->analog[0][0];
+    decode.analog1  = &bench->frame->analog[1][0];
+    decode.digital  = &bench->frame->digital[0];
+    decode.attr     = &bench->frame->attr[0];
+    decode.capacity = NUM_SAMPLES;
+    decodeDisplay(decode, bench->kernel);
+    return ularge(bench->samples) * (bench->version == 1 ? 6 : 4);
+}
+
+class BenchApiDecode
+{
+public:
+    SFContext*   ctx;
+    SFrameData*  frame;
+    uint         samples;
+    ishort*      ch0;
+    ishort*      ch1;
+    ushort*      digital;
+};
+
+ularge benchApiDecode(void* user)
+{
+    BenchApiDecode* bench = (BenchApiDecode*)user;
+    int decoded = 0;
+    sfFrameDecode(bench->ctx, bench->frame, 0, bench->ch0, bench->ch1, bench->digital, bench->samples, &decoded);
+    return ularge(decoded) * 4;
+}
+
+void benchDecodeAll(Bench& bench)
+{
+    byte* data = (byte*)pMemory->allocate(BENCH_FRAME_SAMPLES * 6);
+    OsciloscopeFrame* frame = new OsciloscopeFrame();
+    for(uint version = 1; version <= 2; version++)
+    {
+        if(version == 1)
+        {
+            benchFrame1(data, BENCH_FRAME_SAMPLES);
+        }
+        else
+        {
+            benchFrame2(data, BENCH_FRAME_SAMPLES);
+        }
+        for(int kernel = DECODE_KERNEL_SCALAR; kernel < DECODE_KERNEL_LAST; kernel++)
+        {
+            // version 1 always takes the scalar path
+            if(version == 1 && kernel != DECODE_KERNEL_SCALAR)
+            {
+                continue;
+            }
+            FORMAT_BUFFER();
+            FORMAT("decode.v%u.%s", version, decodeKernelName(DecodeKernel(kernel)));
+            if(!decodeKernelAvailable(DecodeKernel(kernel)))
+            {
+                bench.skip(formatBuffer, "kernel not supported by this cpu");
+                continue;
+            }
+            BenchDecode decode;
+            decode.data    = data;
+            decode.version = version;
+            decode.kernel  = DecodeKernel(kernel);
+            decode.frame   = frame;
+            // every sample of a display sized frame
+            decode.samples = NUM_SAMPLES;
+            decode.step    = 1;
+            bench.run(formatBuffer, benchDecode, &decode, decode.samples);
+            // decimated display of a large frame
+            FORMAT("decode.v%u.%s.step%u", version, decodeKernelName(DecodeKernel(kernel)), BENCH_DISPLAY_STEP);
+            decode.samples = BENCH_FRAME_SAMPLES;
+            decode.step    = BENCH_DISPLAY_STEP;
+            bench.run(formatBuffer, benchDecode, &decode, decode.samples);
+        }
+    }
+    // api decode into separate channel arrays
+    SFContext* ctx = new SFContext();
+    sfApiCreateContext(ctx, BENCH_FRAME_SAMPLES * 4);
+    sfSetFrameVersion(ctx, HARDWARE_VERSION_2);
+    SFrameData* apiFrame = sfCreateSFrameData(ctx, BENCH_FRAME_SAMPLES * 4);
+    benchFrame2(apiFrame->data.bytes, BENCH_FRAME_SAMPLES);
+    BenchApiDecode api;
+    api.ctx     = ctx;
+    api.frame   = apiFrame;
+    api.samples = BENCH_FRAME_SAMPLES;
+    api.ch0     = (ishort*)pMemory->allocate(BENCH_FRAME_SAMPLES * sizeof(ishort));
+    api.ch1     = (ishort*)pMemory->allocate(BENCH_FRAME_SAMPLES * sizeof(ishort));
+    api.digital = (ushort*)pMemory->allocate(BENCH_FRAME_SAMPLES * sizeof(ushort));
+    bench.run("decode.v2.sfFrameDecode", benchApiDecode, &api, api.samples);
+    pMemory->free(api.ch0);
+    pMemory->free(api.ch1);
+    pMemory->free(api.digital);
+    sfDeleteSFrameData(apiFrame);
+    sfApiDeleteContext(ctx);
+    delete ctx;
+    delete frame;
+    pMemory->free(data);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// rle
+////////////////////////////////////////////////////////////////////////////////
+class BenchRle
+{
+public:
+    byte*  src;
+    uint   srcSize;
+    byte*  dest;
+    ularge destSize;
+};
+
+ularge benchRle(void* user)
+{
+    BenchRle* bench = (BenchRle*)user;
+    return rleDecode(bench->dest, bench->destSize, bench->src, bench->srcSize);
+}
+
+void benchRleAll(Bench& bench)
+{
+    // runs of a flat signal alternate with literal noise, roughly what a slow signal compresses to
+    BenchRle rle;
+    rle.destSize = BENCH_RLE_BYTES;
+    rle.dest     = (byte*)pMemory->allocate(rle.destSize);
+    rle.src      = (byte*)pMemory->allocate(rle.destSize);
+    rle.srcSize  = 0;
+    ularge written = 0;
+    uint   seed    = 1;
+    while(written + 128 + 32 <= rle.destSize)
+    {
+        rle.src[rle.srcSize++] = 128;
+        rle.src[rle.srcSize++] = byte(written);
+        rle.src[rle.srcSize++] = 128 + 32;
+        for(uint i = 0; i < 32; i++)
+        {
+            seed = seed * 1103515245u + 12345u;
+            rle.src[rle.srcSize++] = byte(seed >> 16);
+        }
+        written += 128 + 32;
+    }
+    bench.run("rle.decode", benchRle, &rle, rle.srcSize);
+    pMemory->free(rle.src);
+    pMemory->free(rle.dest);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// export
+////////////////////////////////////////////////////////////////////////////////
+class BenchExport
+{
+public:
+    OscExport*     exporter;
+    OscExportFrame info;
+    byte*          data;
+};
+
+ularge benchExport(void* user)
+{
+    BenchExport* bench = (BenchExport*)user;
+    SDL_RWseek(bench->exporter->ctx, 0, RW_SEEK_SET);
+    bench->exporter->frame(bench->data, 2, bench->info);
+    bench->exporter->flush();
+    return bench->info.samples * 4;
+}
+
+void benchExportAll(Bench& bench)
+{
+    // one large frame into memory so only decoding and formatting is measured
+    byte* data = (byte*)pMemory->allocate(BENCH_FRAME_SAMPLES * 4);
+    byte* sink = (byte*)pMemory->allocate(BENCH_EXPORT_BYTES);
+    benchFrame2(data, BENCH_FRAME_SAMPLES);
+    const char* names[oefLast] = { "export.csv", "export.raw", "export.binary" };
+    for(uint format = 0; format < oefLast; format++)
+    {
+        OscExport exporter;
+        BenchExport run;
+        SDL_memset(&run.info, 0, sizeof(OscExportFrame));
+        run.exporter       = &exporter;
+        run.data           = data;
+        run.info.samples   = BENCH_FRAME_SAMPLES;
+        run.info.timeStep  = 1e-8;
+        run.info.voltStep0 = 5.0 / 512.0;
+        run.info.voltStep1 = 5.0 / 512.0;
+        exporter.open(SDL_RWFromMem(sink, BENCH_EXPORT_BYTES), format);
+        bench.run(names[format], benchExport, &run, BENCH_FRAME_SAMPLES);
+        if(exporter.error)
+        {
+            fprintf(stderr, "%-32s output did not fit the sink\n", names[format]);
+        }
+        exporter.close();
+    }
+    pMemory->free(sink);
+    pMemory->free(data);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// fft, measure, function
+////////////////////////////////////////////////////////////////////////////////
+class BenchSignal
+{
+public:
+    OsciloscopeThreadRenderer* renderer;
+    OsciloscopeThreadData*     threadData;
+    OsciloscopeFFT*            fft;
+    MeasureData*               measure;
+    OsciloscopeFunction*       function;
+    FunctionProgram*           program;
+    double*                    ch0;
+    double*                    ch1;
+    double*                    value;
+    double*                    real;
+    double*                    imag;
+    double*                    inputReal;
+    uint                       n;
+};
+
+ularge benchFftComplex(void* user)
+{
+    BenchSignal* bench = (BenchSignal*)user;
+    SDL_memcpy(bench->real, bench->inputReal, bench->n * sizeof(double));
+    SDL_memset(bench->imag, 0, bench->n * sizeof(double));
+    bench->renderer->fftCalculate(0, 0, bench->n, bench->real, bench->imag);
+    return ularge(bench->n) * 2 * sizeof(double);
+}
+
+ularge benchFftSpectrum(void* user)
+{
+    BenchSignal* bench = (BenchSignal*)user;
+    // clear the spectrum cache so every iteration transforms
+    bench->fft->clear();
+    bench->renderer->fftSpectrum(0, *bench->threadData, *bench->fft, bench->threadData->frame, 0, bench->n);
+    return ularge(bench->n) * sizeof(double);
+}
+
+ularge benchMeasure(void* user)
+{
+    BenchSignal* bench = (BenchSignal*)user;
+    bench->fft->clear();
+    bench->renderer->measureSignal(0, *bench->threadData, *bench->measure, *bench->fft);
+    return ularge(bench->threadData->frame.analog[0].getCount()) * 2 * sizeof(ishort);
+}
+
+ularge benchFunctionInterpreter(void* user)
+{
+    BenchSignal* bench = (BenchSignal*)user;
+    for(uint i = 0; i < NUM_SAMPLES; i++)
+    {
+        bench->value[i] = bench->function->evaluate(bench->ch0[i], bench->ch1[i]);
+    }
+    benchSink = bench->value[NUM_SAMPLES - 1];
+    return ularge(NUM_SAMPLES) * 2 * sizeof(double);
+}
+
+ularge benchFunctionCompiled(void* user)
+{
+    BenchSignal* bench = (BenchSignal*)user;
+    bench->program->evaluate(*bench->function, bench->ch0, bench->ch1, bench->value, NUM_SAMPLES);
+    benchSink = bench->value[NUM_SAMPLES - 1];
+    return ularge(NUM_SAMPLES) * 2 * sizeof(double);
+}
+
+void benchFunctionAll(Bench& bench, BenchSignal& signal)
+{
+    const char* names[] = { "add", "mixed", "mod", "folded", "nested" };
+    const char* expressions[] =
+    {
+        "ch0 + ch1",
+        "sin(ch0) * ch1 + max(ch0, ch1) / 2",
+        "(ch0 * 2 + 3) * (ch1 - 0.5) % 7",
+        "cos(2 * 3.14159 / 4) * ch0 + (1 + 2) * (3 - 4) - min(5, 6) / 2",
+        "sin(cos(ch0 + ch1)) * min(ch0, ch1) - max(ch0 * ch1, 0.25)",
+    };
+    OsciloscopeFrame& frame = signal.threadData->frame;
+    for(uint i = 0; i < NUM_SAMPLES; i++)
+    {
+        signal.ch0[i] = frame.getAnalog(0, i);
+        signal.ch1[i] = frame.getAnalog(1, i);
+    }
+    for(uint e = 0; e < sizeof(expressions) / sizeof(const char*); e++)
+    {
+        signal.function->tokenize(expressions[e]);
+        signal.function->parse();
+        signal.program->compile(*signal.function);
+        // compiled code must give the interpreter's results
+        signal.program->evaluate(*signal.function, signal.ch0, signal.ch1, signal.value, NUM_SAMPLES);
+        uint mismatch = 0;
+        for(uint i = 0; i < NUM_SAMPLES; i++)
+        {
+            double expected = signal.function->evaluate(signal.ch0[i], signal.ch1[i]);
+            if(SDL_memcmp(&expected, &signal.value[i], sizeof(double)) != 0)
+            {
+                mismatch++;
+            }
+        }
+        FORMAT_BUFFER();
+        FORMAT("function.interpreter.%s", names[e]);
+        bench.run(formatBuffer, benchFunctionInterpreter, &signal, NUM_SAMPLES);
+        FORMAT("function.compiled.%s", names[e]);
+        if(mismatch)
+        {
+            bench.skip(formatBuffer, "results differ from the interpreter");
+            continue;
+        }
+        bench.run(formatBuffer, benchFunctionCompiled, &signal, NUM_SAMPLES);
+    }
+}
+
+void benchSignalAll(Bench& bench)
+{
+    BenchSignal signal;
+    signal.renderer   = new OsciloscopeThreadRenderer();
+    signal.threadData = new OsciloscopeThreadData();
+    signal.fft        = new OsciloscopeFFT();
+    signal.measure    = new MeasureData();
+    signal.function   = new OsciloscopeFunction();
+    signal.program    = new FunctionProgram();
+    signal.renderer->init(1);
+    signal.fft->init();
+    signal.real      = (double*)pMemory->allocate(NUM_FFT * sizeof(double));
+    signal.imag      = (double*)pMemory->allocate(NUM_FFT * sizeof(double));
+    signal.inputReal = (double*)pMemory->allocate(NUM_FFT * sizeof(double));
+    for(uint i = 0; i < NUM_FFT; i++)
+    {
+        signal.inputReal[i] = sin(2.0 * PI * double(i) / 1000.0) + 0.25 * sin(2.0 * PI * double(i) / 37.0);
+    }
+    // display frame decoded from a synthetic capture
+    byte* data = (byte*)pMemory->allocate(NUM_SAMPLES * 4);
+    benchFrame2(data, NUM_SAMPLES);
+    decodeDisplayFrame(signal.threadData->frame, data, 2, 0, NUM_SAMPLES, 1);
+    pMemory->free(data);
+    // fft
+    uint sizes[] = { 1024, 16384, 1048576 };
+    for(uint i = 0; i < sizeof(sizes) / sizeof(uint); i++)
+    {
+        FORMAT_BUFFER();
+        FORMAT("fftCalculate.%u", sizes[i]);
+        signal.n = sizes[i];
+        bench.run(formatBuffer, benchFftComplex, &signal, signal.n);
+    }
+    signal.n = NUM_SAMPLES;
+    bench.run("fftSpectrum.10000", benchFftSpectrum, &signal, signal.n);
+    // measure with the measure window open, that is when the gui runs it
+    signal.threadData->window.measure.uiOpen = 1;
+    bench.run("measureSignal", benchMeasure, &signal, NUM_SAMPLES);
+    // custom function, interpreter against compiled code
+    signal.ch0   = (double*)pMemory->allocate(NUM_SAMPLES * sizeof(double));
+    signal.ch1   = (double*)pMemory->allocate(NUM_SAMPLES * sizeof(double));
+    signal.value = (double*)pMemory->allocate(NUM_SAMPLES * sizeof(double));
+    benchFunctionAll(bench, signal);
+    pMemory->free(signal.ch0);
+    pMemory->free(signal.ch1);
+    pMemory->free(signal.value);
+    pMemory->free(signal.real);
+    pMemory->free(signal.imag);
+    pMemory->free(signal.inputReal);
+    delete signal.function;
+    delete signal.program;
+    delete signal.measure;
+    delete signal.fft;
+    delete signal.threadData;
+    delete signal.renderer;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// history
+////////////////////////////////////////////////////////////////////////////////
+class BenchHistory
+{
+public:
+    CaptureInterface* capture;
+    CapturePacket*    packet;
+};
+
+ularge benchHistoryWrite(void* user)
+{
+    BenchHistory* bench = (BenchHistory*)user;
+    CaptureInterface* capture = bench->capture;
+    // one frame, header flag on the first packet as the capture thread does
+    capture->lock();
+    capture->openWrite();
+    CaptureFrame frame;
+    capture->ringFrame.write(frame);
+    for(uint i = 0; i < BENCH_HISTORY_FRAME; i++)
+    {
+        capture->writePacket(*bench->packet, i == 0);
+    }
+    capture->closeWrite();
+    capture->unlock();
+    return ularge(BENCH_HISTORY_FRAME) * bench->packet->size;
+}
+
+ularge benchHistoryRead(void* user)
+{
+    BenchHistory* bench = (BenchHistory*)user;
+    CaptureInterface* capture = bench->capture;
+    ularge bytes = 0;
+    capture->lock();
+    capture->openRead();
+    Ring<PacketData> ring = capture->ringPacket;
+    uint count = min<uint>(uint(ring.getCount()), BENCH_HISTORY_FRAME);
+    for(uint i = 0; i < count; i++)
+    {
+        PacketData packet;
+        ring.read(packet);
+        capture->read(packet.offset, bench->packet->data, packet.size);
+        bytes += packet.size;
+    }
+    capture->closeRead();
+    capture->unlock();
+    return bytes;
+}
+
+void benchHistoryRun(Bench& bench, const char* name, CaptureInterface* capture, CapturePacket* packet)
+{
+    BenchHistory history;
+    history.capture = capture;
+    history.packet  = packet;
+    FORMAT_BUFFER();
+    FORMAT("history.%s.write", name);
+    bench.run(formatBuffer, benchHistoryWrite, &history, BENCH_HISTORY_FRAME);
+    FORMAT("history.%s.read", name);
+    bench.run(formatBuffer, benchHistoryRead, &history, BENCH_HISTORY_FRAME);
+}
+
+void benchHistoryAll(Bench& bench, const char* dir)
+{
+    CapturePacket* packet = new CapturePacket();
+    packet->size = SCOPEFUN_FRAME_2_PACKET;
+    for(uint i = 0; i < packet->size; i++)
+    {
+        packet->data[i] = byte(i * 7);
+    }
+    // ram
+    CaptureMemory* memory = new CaptureMemory();
+    byte* data = (byte*)pMemory->allocate(BENCH_HISTORY_BYTES);
+    memory->init(data, BENCH_HISTORY_BYTES, SCOPEFUN_FRAME_2_PACKET);
+    benchHistoryRun(bench, "memory", memory, packet);
+    pMemory->free(data);
+    // ssd, seek and read / write calls
+    FORMAT_BUFFER();
+    FORMAT("%s/sfbench.history", dir);
+    String path = formatBuffer;
+    CaptureSSD* ssd = new CaptureSSD();
+    ssd->init(path.asChar(), BENCH_HISTORY_BYTES, SCOPEFUN_FRAME_2_PACKET);
+    benchHistoryRun(bench, "ssd", ssd, packet);
+    remove(path.asChar());
+    // ssd through mapped windows
+    CaptureMapped* mapped = new CaptureMapped();
+    mapped->init(path.asChar(), BENCH_HISTORY_BYTES, SCOPEFUN_FRAME_2_PACKET);
+    if(mapped->mapped)
+    {
+        benchHistoryRun(bench, "mapped", mapped, packet);
+    }
+    else
+    {
+        bench.skip("history.mapped.write", "mapping failed");
+        bench.skip("history.mapped.read", "mapping failed");
+    }
+    mapped->release();
+    remove(path.asChar());
+    delete packet;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// memory
+////////////////////////////////////////////////////////////////////////////////
+
+// previous allocator, one global spinlock around SDL_malloc
+class BenchMemoryLock
+{
+public:
+    SDL_SpinLock lock;
+public:
+    BenchMemoryLock() : lock(0) {};
+public:
+    void* allocate(ularge size)
+    {
+        SDL_AtomicLock(&lock);
+        void* ptr = SDL_malloc(size);
+        SDL_AtomicUnlock(&lock);
+        return ptr;
+    }
+    void free(void* ptr)
+    {
+        SDL_AtomicLock(&lock);
+        SDL_free(ptr);
+        SDL_AtomicUnlock(&lock);
+    }
+};
+
+BenchMemoryLock benchMemoryLock;
+
+class BenchMemoryThread
+{
+public:
+    int    pooled;
+    ularge seed;
+    ularge bytes;
+};
+
+class BenchMemory
+{
+public:
+    int  pooled;
+    uint threads;
+};
+
+ularge benchMemoryRandom(ularge& state)
+{
+    state ^= state << 13;
+    state ^= state >> 7;
+    state ^= state << 17;
+    return state;
+}
+
+// sizes of the small render, json and api allocations with a few large buffers mixed in
+ularge benchMemorySize(ularge& state)
+{
+    ularge r = benchMemoryRandom(state);
+    if((r & 1023) == 0)
+    {
+        return 256 * 1024;
+    }
+    return 16 + (r >> 16) % (8 * 1024);
+}
+
+int SDLCALL benchMemoryThread(void* data)
+{
+    // every thread keeps a window of live blocks and replaces a random one each step
+    BenchMemoryThread* bench = (BenchMemoryThread*)data;
+    void*  live[BENCH_MEMORY_WINDOW] = { 0 };
+    ularge state = bench->seed;
+    for(uint i = 0; i < BENCH_MEMORY_STEPS; i++)
+    {
+        uint   slot = benchMemoryRandom(state) % BENCH_MEMORY_WINDOW;
+        ularge size = benchMemorySize(state);
+        if(bench->pooled)
+        {
+            pMemory->free(live[slot]);
+            live[slot] = pMemory->allocate(size);
+        }
+        else
+        {
+            benchMemoryLock.free(live[slot]);
+            live[slot] = benchMemoryLock.allocate(size);
+        }
+        ((byte*)live[slot])[0] = byte(i);
+        bench->bytes += size;
+    }
+    for(uint i = 0; i < BENCH_MEMORY_WINDOW; i++)
+    {
+        if(bench->pooled)
+        {
+            pMemory->free(live[i]);
+        }
+        else
+        {
+            benchMemoryLock.free(live[i]);
+        }
+    }
+    pMemory->threadFlush();
+    return 0;
+}
+
+ularge benchMemory(void* user)
+{
+    BenchMemory*      bench = (BenchMemory*)user;
+    BenchMemoryThread thread[MAX_THREAD];
+    SDL_Thread*       handle[MAX_THREAD];
+    ularge            bytes = 0;
+    for(uint t = 0; t < bench->threads; t++)
+    {
+        thread[t].pooled = bench->pooled;
+        thread[t].seed   = 0x9E3779B97F4A7C15ULL * (t + 1);
+        thread[t].bytes  = 0;
+        handle[t] = SDL_CreateThread(benchMemoryThread, "bench", &thread[t]);
+    }
+    for(uint t = 0; t < bench->threads; t++)
+    {
+        SDL_WaitThread(handle[t], 0);
+        bytes += thread[t].bytes;
+    }
+    return bytes;
+}
+
+uint benchMemoryAligned()
+{
+    uint misaligned = 0;
+    int  align[] = { 16, 32, 64, 128, 4096 };
+    for(uint a = 0; a < sizeof(align) / sizeof(int); a++)
+    {
+        for(ularge size = 1; size < 1024 * 1024; size = size * 3 + 1)
+        {
+            void* ptr = pMemory->allocate(size, align[a]);
+            misaligned += ularge(ptr) % align[a] ? 1 : 0;
+            ptr = pMemory->reallocate(ptr, size * 2);
+            misaligned += ularge(ptr) % min(align[a], MEMORY_ALIGN) ? 1 : 0;
+            pMemory->free(ptr);
+        }
+    }
+    return misaligned;
+}
+
+void benchMemoryAll(Bench& bench)
+{
+    if(benchMemoryAligned())
+    {
+        bench.skip("memory", "misaligned allocation");
+        return;
+    }
+    FORMAT_BUFFER();
+    for(uint threads = 1; threads <= min<uint>(BENCH_MEMORY_THREADS, MAX_THREAD); threads *= 2)
+    {
+        for(int pooled = 0; pooled < 2; pooled++)
+        {
+            BenchMemory memory;
+            memory.pooled  = pooled;
+            memory.threads = threads;
+            FORMAT("memory.%s.t%u", pooled ? "pool" : "lock", threads);
+            bench.run(formatBuffer, benchMemory, &memory, ularge(threads) * BENCH_MEMORY_STEPS);
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// simulate
+////////////////////////////////////////////////////////////////////////////////
+class BenchSimulate
+{
+public:
+    SFContext* ctx;
+    uint       frames;
+    uint       data;
+};
+
+ularge benchSimulate(void* user)
+{
+    BenchSimulate* bench = (BenchSimulate*)user;
+    sfSimulate(bench->ctx, bench->frames * 0.01);
+    bench->frames++;
+    return bench->data;
+}
+
+uint benchChecksum(byte* data, uint size)
+{
+    uint sum = 2166136261u;
+    for(uint i = 0; i < size; i++)
+    {
+        sum = (sum ^ data[i]) * 16777619u;
+    }
+    return sum;
+}
+
+void benchSimulateAll(Bench& bench)
+{
+    SFContext* ctx = new SFContext();
+    sfApiCreateContext(ctx, BENCH_SIMULATE_DATA + SCOPEFUN_FRAME_1_HEADER);
+    SSimulate sim;
+    SDL_zero(sim);
+    sim.active0     = 1;
+    sim.active1     = 1;
+    sim.time        = 1e-6f;
+    sim.period0     = 5e-4f;
+    sim.period1     = 3e-4f;
+    sim.peakToPeak0 = 1.5f;
+    sim.peakToPeak1 = 1.0f;
+    sim.speed0      = 1.f;
+    sim.speed1      = 2.f;
+    sim.voltage0    = 0.2f;
+    sim.voltage1    = 0.1f;
+    sfSetSimulateOnOff(ctx, 1);
+    const char* name[] = { "sin", "cos", "inc", "dec", "constant", "random", "square", "delta" };
+    FORMAT_BUFFER();
+    for(int type = stSin; type <= stDelta; type++)
+    {
+        for(int version = HARDWARE_VERSION_1; version <= HARDWARE_VERSION_2; version++)
+        {
+            sim.type0 = (ESimulateType)type;
+            sim.type1 = (ESimulateType)((type + 1) % (stDelta + 1));
+            FORMAT("simulate.v%d.%s.%s", version, name[sim.type0], name[sim.type1]);
+            if(!bench.enabled(formatBuffer))
+            {
+                continue;
+            }
+            int header = version == HARDWARE_VERSION_1 ? SCOPEFUN_FRAME_1_HEADER : SCOPEFUN_FRAME_2_HEADER;
+            sfSetSimulateData(ctx, &sim);
+            sfSetFrameVersion(ctx, version);
+            sfSetFrameHeader(ctx, header);
+            sfSetFrameData(ctx, BENCH_SIMULATE_DATA);
+            sfSetSimulateSeed(ctx, 1);
+            // the same seed and time give the same frame, the checksum can be compared between builds and machines
+            sfSimulate(ctx, 0.0);
+            uint sum = benchChecksum(&ctx->frame.data->data.bytes[0], header + BENCH_SIMULATE_DATA);
+            BenchSimulate run;
+            run.ctx    = ctx;
+            run.frames = 0;
+            run.data   = BENCH_SIMULATE_DATA;
+            cJSON* json = bench.run(formatBuffer, benchSimulate, &run, 1);
+            if(json)
+            {
+                cJSON_AddItemToObject(json, "checksum", cJSON_CreateNumber(double(sum)));
+            }
+        }
+    }
+    sfApiDeleteContext(ctx);
+    delete ctx;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// server loopback
+////////////////////////////////////////////////////////////////////////////////
+class BenchServer
+{
+public:
+    SFContext*   ctx;
+    SFrameData*  frame;
+    SFrameBatch* batch;
+};
+
+ularge benchServerCapture(void* user)
+{
+    BenchServer* bench = (BenchServer*)user;
+    int received = 0;
+    sfHardwareCapture(bench->ctx, bench->frame, BENCH_SERVER_DATA, &received, SCOPEFUN_CAPTURE_TYPE_DATA);
+    return ularge(max(received, 0));
+}
+
+ularge benchServerBatch(void* user)
+{
+    BenchServer* bench = (BenchServer*)user;
+    int frames   = BENCH_SERVER_MEMORY / BENCH_SERVER_DATA;
+    int captured = 0;
+    sfHardwareCaptureBatch(bench->ctx, bench->frame, BENCH_SERVER_MEMORY, 0, BENCH_SERVER_DATA, frames, bench->batch, &captured);
+    ularge bytes = 0;
+    for(int i = 0; i < captured; i++)
+    {
+        bytes += bench->batch->length.bytes[i];
+    }
+    return bytes;
+}
+
+void benchServerAll(Bench& bench, const char* ip, int port)
+{
+    if(!bench.enabled("server.loopback"))
+    {
+        return;
+    }
+    BenchServer server;
+    server.ctx = new SFContext();
+    sfApiCreateContext(server.ctx, BENCH_SERVER_MEMORY);
+    sfSetActive(server.ctx, 1);
+    sfSetThreadSafe(server.ctx, 1);
+    sfSetNetwork(server.ctx);
+    sfSetFrameVersion(server.ctx, HARDWARE_VERSION_2);
+    sfSetFrameHeader(server.ctx, SCOPEFUN_FRAME_2_HEADER);
+    sfSetFrameData(server.ctx, BENCH_SERVER_DATA);
+    sfSetFramePacket(server.ctx, SCOPEFUN_FRAME_2_PACKET);
+    if(sfClientConnect(server.ctx, ip, port) != SCOPEFUN_SUCCESS)
+    {
+        bench.skip("server.loopback.capture", "connect failed");
+        bench.skip("server.loopback.batch", "connect failed");
+    }
+    else
+    {
+        server.frame = sfCreateSFrameData(server.ctx, BENCH_SERVER_MEMORY);
+        server.batch = sfCreateSFrameBatch();
+        if(benchServerCapture(&server) == 0)
+        {
+            bench.skip("server.loopback.capture", "server sends no frames");
+            bench.skip("server.loopback.batch", "server sends no frames");
+        }
+        else
+        {
+            bench.run("server.loopback.capture", benchServerCapture, &server, 1);
+            bench.run("server.loopback.batch", benchServerBatch, &server, BENCH_SERVER_MEMORY / BENCH_SERVER_DATA);
+        }
+        sfDeleteSFrameBatch(server.batch);
+        sfDeleteSFrameData(server.frame);
+        sfClientDisconnect(server.ctx);
+    }
+    sfApiDeleteContext(server.ctx);
+    delete server.ctx;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// main
+////////////////////////////////////////////////////////////////////////////////
+void usage()
+{
+    fprintf(stderr, "usage: sfBench [options]\n");
+    fprintf(stderr, "  -o    <file>     write json to file instead of stdout\n");
+    fprintf(stderr, "  -t    <seconds>  minimum time per benchmark, default is 0.5\n");
+    fprintf(stderr, "  -f    <filter>   run only benchmarks whose name contains filter\n");
+    fprintf(stderr, "  -ip   <ip>       server for the loopback benchmark, default is 127.0.0.1\n");
+    fprintf(stderr, "  -port <port>     server port, default is 42250\n");
+    fprintf(stderr, "  -dir  <path>     directory for the ssd history file, default is current\n");
+}
+
+int main(int argc, char** argv)
+{
+    Bench       bench;
+    const char* outFile = 0;
+    const char* ip      = "127.0.0.1";
+    int         port    = 42250;
+    const char* dir     = ".";
+    for(int i = 1; i < argc; i++)
+    {
+        bool value = i + 1 < argc;
+        if(SDL_strcmp(argv[i], "-o") == 0 && value)
+        {
+            outFile = argv[++i];
+        }
+        else if(SDL_strcmp(argv[i], "-t") == 0 && value)
+        {
+            bench.seconds = max(SDL_atof(argv[++i]), 0.0);
+        }
+        else if(SDL_strcmp(argv[i], "-f") == 0 && value)
+        {
+            bench.filter = argv[++i];
+        }
+        else if(SDL_strcmp(argv[i], "-ip") == 0 && value)
+        {
+            ip = argv[++i];
+        }
+        else if(SDL_strcmp(argv[i], "-port") == 0 && value)
+        {
+            port = SDL_atoi(argv[++i]);
+        }
+        else if(SDL_strcmp(argv[i], "-dir") == 0 && value)
+        {
+            dir = argv[++i];
+        }
+        else
+        {
+            usage();
+            return 1;
+        }
+    }
+    // managers, nothing is started
+    create();
+    sfApiInit();
+    // header
+    cJSON* root = cJSON_CreateObject();
+    cJSON_AddItemToObject(root, "version", cJSON_CreateString(SCOPEFUN_VERSION_MAJOR "." SCOPEFUN_VERSION_MINOR "." SCOPEFUN_VERSION_MICRO));
+    cJSON_AddItemToObject(root, "timestamp", cJSON_CreateString(SCOPEFUN_VERSION_TIMESTAMP));
+    cJSON_AddItemToObject(root, "type", cJSON_CreateString(SCOPEFUN_VERSION_TYPE));
+    cJSON_AddItemToObject(root, "platform", cJSON_CreateString(SDL_GetPlatform()));
+    cJSON_AddItemToObject(root, "cpus", cJSON_CreateNumber(SDL_GetCPUCount()));
+    cJSON_AddItemToObject(root, "decodeKernel", cJSON_CreateString(decodeKernelName(decodeKernel())));
+    cJSON_AddItemToObject(root, "secondsPerBenchmark", cJSON_CreateNumber(bench.seconds));
+    bench.results = cJSON_CreateArray();
+    cJSON_AddItemToObject(root, "results", bench.results);
+    // run
+    benchDecodeAll(bench);
+    benchRleAll(bench);
+    benchExportAll(bench);
+    benchSignalAll(bench);
+    benchHistoryAll(bench, dir);
+    benchMemoryAll(bench);
+    benchSimulateAll(bench);
+    benchServerAll(bench, ip, port);
+    // write
+    setlocale(LC_ALL, "C");
+    char* json = cJSON_Print(root);
+    FILE* out = outFile ? fopen(outFile, "w") : stdout;
+    if(!out)
+    {
+        fprintf(stderr, "can't open %s\n", outFile);
+        return 1;
+    }
+    fprintf(out, "%s\n", json);
+    if(out != stdout)
+    {
+        fclose(out);
+    }
+    free(json);
+    cJSON_Delete(root);
+    sfApiExit();
+    return 0;
+}
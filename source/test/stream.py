@@ -0,0 +1,73 @@
+import scopefunapi
+import time
+import sys
+
+# frames per second over loopback, request/reply capture against batch capture and subscribe stream
+# start sfServer with simulation enabled, then run: python stream.py [frames] [credit]
+
+szCapture = 16*1024*1024
+szFrame   = 16*1024*1024
+szData    = 40960
+
+count  = 500
+credit = 4
+if len(sys.argv) > 1:
+    count = int(sys.argv[1])
+if len(sys.argv) > 2:
+    credit = int(sys.argv[2])
+
+# setup
+ret = scopefunapi.sfApiInit()
+ctx = scopefunapi.sfCreateSFContext()
+ret = scopefunapi.sfApiCreateContext(ctx,szCapture)
+ret = scopefunapi.sfSetActive(ctx,1)
+ret = scopefunapi.sfSetThreadSafe(ctx,1)
+ret = scopefunapi.sfSetNetwork(ctx)
+ret = scopefunapi.sfSetFrameVersion(ctx,2)
+ret = scopefunapi.sfSetFrameHeader(ctx,1024)
+ret = scopefunapi.sfSetFrameData(ctx,40000)
+ret = scopefunapi.sfSetFramePacket(ctx,(1024*1024))
+
+print "sfClientConnect"
+ret = scopefunapi.sfClientConnect(ctx,'127.0.0.1',42250)
+
+frame = scopefunapi.sfCreateSFrameData(ctx,szFrame)
+
+# request / reply
+start = time.time()
+for i in range(0,count):
+    ret,transfered = scopefunapi.sfHardwareCapture(ctx,frame,szData,2)
+elapsed = time.time() - start
+print "sfHardwareCapture   %8.1f frames/s" % (count/elapsed)
+
+# batch, frames land back to back in frame at batch.offset[i]
+batch    = scopefunapi.sfCreateSFrameBatch()
+perBatch = szFrame / szData
+captured = 0
+start = time.time()
+while captured < count:
+    ret,n = scopefunapi.sfHardwareCaptureBatch(ctx,frame,szFrame,0,szData,min(perBatch,count-captured),batch)
+    if ret != 0 or n == 0:
+        break
+    captured = captured + n
+elapsed = time.time() - start
+print "sfHardwareCaptureBatch %5.1f frames/s" % (captured/elapsed)
+scopefunapi.sfDeleteSFrameBatch(batch)
+
+# stream
+ret = scopefunapi.sfHardwareSubscribe(ctx,szData,2,credit)
+lost  = 0
+last  = -1
+start = time.time()
+for i in range(0,count):
+    ret,transfered,sequence = scopefunapi.sfHardwareStream(ctx,frame,szData)
+    if last >= 0 and sequence != last + 1:
+        lost = lost + 1
+    last = sequence
+elapsed = time.time() - start
+ret = scopefunapi.sfHardwareUnsubscribe(ctx)
+print "sfHardwareStream    %8.1f frames/s  credit %d  gaps %d" % (count/elapsed,credit,lost)
+
+# exit
+ret = scopefunapi.sfClientDisconnect(ctx)
+ret = scopefunapi.sfApiExit()